@@ -1203,6 +1203,166 @@ namespace jhbCURLTools {
     }
     #endif
 
+    //
+    // FTPSessionCache
+    //
+
+    /**
+     * @brief constructor of the FTP sessions cache
+     *
+     * @param [in] uIdleTimeout delay (in s) after which an unused session is closed
+     *
+     */
+    FTPSessionCache::FTPSessionCache(const unsigned &uIdleTimeout):
+       uIdleTimeout_(uIdleTimeout)
+    {
+    }
+
+    /**
+     * @brief destructor : all the sessions are closed
+     *
+     */
+    FTPSessionCache::~FTPSessionCache()
+    {
+       Purge(true);
+    }
+
+    /**
+     * @brief returns an opened session for the given server and account
+     *
+     * A session left in the cache by a previous transfer is reused : its curl handle
+     * keeps the control connection alive. Otherwise a new session is initialized.
+     * The caller owns the session until Release() is called.
+     *
+     * Example Usage:
+     * @code
+     *    bool bReused(false);
+     *    FTPClient* pClient = oSessions.Acquire("ftp://127.0.0.1", 21, "username", "password", bReused);
+     *    pClient->UploadFile(...);
+     *    oSessions.Release(pClient);
+     * @endcode
+     */
+    FTPClient *FTPSessionCache::Acquire(const std::string &strHost, const unsigned &uPort, const std::string &strLogin, const std::string &strPassword,
+                                        bool &bReused, const FTPClient::FTP_PROTOCOL &eFtpProtocol /* = FTP */)
+    {
+       // expired sessions are closed first
+       Purge();
+
+       {
+          std::lock_guard<std::mutex> lock(mutex_);
+
+          // most recently used session for this server / account
+          for (std::vector<FTPSESSION>::reverse_iterator it = sessions_.rbegin(); it != sessions_.rend(); it++) {
+             FTPClient *pClient(it->pClient);
+             if (pClient->GetURL() == strHost && pClient->GetPort() == uPort &&
+                 pClient->GetUsername() == strLogin && pClient->GetPassword() == strPassword &&
+                 pClient->GetProtocol() == eFtpProtocol) {
+                sessions_.erase(std::next(it).base());
+                bReused = true;
+                return pClient;
+             }
+          }
+       }
+
+       // new session
+       std::unique_ptr<FTPClient> pNewClient(new FTPClient());
+       pNewClient->InitSession(strHost, uPort, strLogin, strPassword, eFtpProtocol);
+
+       bReused = false;
+       return pNewClient.release();
+    }
+
+    /**
+     * @brief gives back a session
+     *
+     * @param [in] pClient session returned by Acquire()
+     * @param [in] bReusable false if the session should be closed (after a transfer error)
+     *
+     */
+    void FTPSessionCache::Release(FTPClient *pClient, const bool &bReusable /* = true */)
+    {
+       if (nullptr == pClient) {
+          return;
+       }
+
+       if (!bReusable || 0 == uIdleTimeout_) {
+          Close(pClient);
+          return;
+       }
+
+       FTPSESSION session;
+       session.pClient = pClient;
+       session.tLastUse = time(nullptr);
+
+       std::lock_guard<std::mutex> lock(mutex_);
+       sessions_.push_back(session);
+    }
+
+    /**
+     * @brief closes the sessions unused for more than the idle timeout
+     *
+     * @param [in] bAll if true all the sessions are closed
+     *
+     * @return the number of closed sessions
+     */
+    const size_t FTPSessionCache::Purge(const bool &bAll /* = false */)
+    {
+       std::vector<FTPClient*> expired;
+       time_t tNow(time(nullptr));
+
+       {
+          std::lock_guard<std::mutex> lock(mutex_);
+          std::vector<FTPSESSION>::iterator it = sessions_.begin();
+          while (it != sessions_.end()) {
+             if (bAll || tNow - it->tLastUse >= static_cast<time_t>(uIdleTimeout_)) {
+                expired.push_back(it->pClient);
+                it = sessions_.erase(it);
+             }
+             else {
+                it++;
+             }
+          }
+       }
+
+       // connections are closed outside of the lock
+       for (std::vector<FTPClient*>::iterator it = expired.begin(); it != expired.end(); it++) {
+          Close(*it);
+       }
+
+       return expired.size();
+    }
+
+    /**
+     * @brief number of sessions waiting in the cache
+     *
+     */
+    const size_t FTPSessionCache::size()
+    {
+       std::lock_guard<std::mutex> lock(mutex_);
+       return sessions_.size();
+    }
+
+    /**
+     * @brief closes a session and frees the client
+     *
+     */
+    void FTPSessionCache::Close(FTPClient *pClient)
+    {
+       if (nullptr == pClient) {
+          return;
+       }
+
+       try {
+          if (pClient->GetCurlPointer()) {
+             pClient->CleanupSession();
+          }
+       }
+       catch (...) {
+       }
+
+       delete pClient;
+    }
+
 }  // namespace jhbCURLTools
 
 // EOF
@@ -45,6 +45,10 @@
 #define LOG_ERROR_FILE_GETFILE_FORMAT   "[FTPClient::DownloadFile()] - Impossible d'ouvrir '%s'"
 #define LOG_ERROR_DIR_GETWILD_FORMAT    "[FTPClient::DownloadWildcard()] - '%s' n'est pas un dossier ou n'existe pas"
 
+// Dure (en s) au del de laquelle une session inutilise est ferme
+//
+#define FTP_SESSION_DEF_IDLE            60
+
 namespace jhbCURLTools {
 
 class FTPClient {
@@ -272,6 +276,53 @@ class FTPClient {
    CURLHandle &hCurl_;
 };
 
+// Cache des sessions FTP
+//  les sessions (et donc les connexions de contrle) sont conserves entre deux transferts
+//  vers un mme serveur / port / compte. Une session est retire du cache pendant son utilisation
+//  (un handle CURL ne peut tre utilis que par un seul thread  la fois)
+//
+class FTPSessionCache {
+  public:
+   FTPSessionCache(const unsigned &uIdleTimeout = FTP_SESSION_DEF_IDLE);
+   virtual ~FTPSessionCache();
+
+   // copy constructor and assignment operator are disabled
+   FTPSessionCache(const FTPSessionCache &) = delete;
+   FTPSessionCache &operator=(const FTPSessionCache &) = delete;
+
+   inline void SetIdleTimeout(const unsigned &uIdleTimeout)
+   { uIdleTimeout_ = uIdleTimeout; }
+   inline const unsigned GetIdleTimeout() const
+   { return uIdleTimeout_; }
+
+   // Une session ouverte (rutilise si possible)
+   //   bReused est positionn si la session provient du cache
+   FTPClient *Acquire(const std::string &strHost, const unsigned &uPort, const std::string &strLogin, const std::string &strPassword,
+                      bool &bReused, const FTPClient::FTP_PROTOCOL &eFtpProtocol = FTPClient::FTP_PROTOCOL::FTP);
+
+   // Fin d'utilisation de la session
+   //   si elle n'est pas rutilisable (erreur de transfert), elle est ferme
+   void Release(FTPClient *pClient, const bool &bReusable = true);
+
+   // Fermeture des sessions inutilises depuis trop longtemps (toutes si bAll)
+   const size_t Purge(const bool &bAll = false);
+
+   // Nombre de sessions en attente
+   const size_t size();
+
+  private:
+   typedef struct tagFTPSESSION {
+      FTPClient    *pClient;
+      time_t       tLastUse;
+   }FTPSESSION;
+
+   static void Close(FTPClient *pClient);
+
+   std::mutex              mutex_;
+   std::vector<FTPSESSION> sessions_;     // Sessions inutilises
+   unsigned                uIdleTimeout_;
+};
+
 };  // namespace jhbCURLTools
 
 #endif // __JHB_CUPS_FTP_CLIENT_h__
@@ -51,6 +51,9 @@
 // Taille de la chaine "Boudary"
 #define BOUNDARY_LEN				65
 
+// Nombre de lignes base64 gnres  chaque lecture d'une PJ
+#define BASE64_CHUNK_LINES			64
+
 // Association extension(s) => type MIME
 static const std::string EXT2MIME{ ".avi -video/ms-video "
 									".css -text/css "
@@ -106,11 +109,16 @@ namespace jhbCURLTools
 	{
 		encoder_.sourceFormat(charUtils::SOURCE_FORMAT::ISO_8859_15, true);
 		eol_ = charUtils::eol(charUtils::FORMAT_EOL::EOL_CRLF);
+		timeout_ = 0;
+		response_ = 0;
+
+		// Initialisation de libCURL (avant tout envoi, ventuellement depuis plusieurs threads)
+		CURLHandle::instance();
 	}
 
 	// Envoi du message
 	//
-	CURLcode SMTPClient::send(const std::string& addr, int port, const std::string &user, const std::string& password, bool tls)
+	CURLcode SMTPClient::send(const std::string& addr, int port, const std::string &user, const std::string& password, bool tls, CURL* session)
 	{
 		std::stringstream ss;
 		if (tls) {
@@ -122,11 +130,12 @@ namespace jhbCURLTools
 		ss << IPPROTO_URL_SEP << addr << ":" << port;
 		std::string fURL;
 		ss >> fURL;
-		return send(fURL , user, password, tls);
+		return send(fURL , user, password, tls, session);
 	}
 
-	CURLcode SMTPClient::send(const std::string &url, const std::string &userName, const std::string &password, bool tls)
+	CURLcode SMTPClient::send(const std::string &url, const std::string &userName, const std::string &password, bool tls, CURL* session)
 	{
+		response_ = 0;
 
 		if (!from_.isValid() ||		// Si l'adresse source n'est pas valide
 			!recipients_.size()){	// ou aucun destinataire pour le message
@@ -136,11 +145,20 @@ namespace jhbCURLTools
 		CURLcode ret(CURLE_OK);
 		struct curl_slist* dests(NULL);
 
-		CURL *curl = curl_easy_init();
+		// Session existante ?
+		//	les options sont rinitialises mais la connexion est conserve
+		CURL *curl(session);
+		if (curl){
+			curl_easy_reset(curl);
+		}
+		else{
+			curl = curl_easy_init();
+		}
 
 		if (curl){
 			// Gnration du message
-			StringData textData { _generate() };
+			messageData textData;
+			_generate(textData);
 
 			// Transaction avec le serveur SMTP
 			curl_easy_setopt(curl, CURLOPT_USERNAME, userName.c_str());
@@ -169,22 +187,32 @@ namespace jhbCURLTools
 			curl_easy_setopt(curl, CURLOPT_READDATA, &textData);
 			curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
 
+			// Pas de signaux : l'envoi peut se faire depuis un thread
+			curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+			if (timeout_ > 0) {
+				curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_);
+			}
+
 #ifdef _DEBUG
 			curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
 #endif // #ifdef _DEBUG
 
 			ret = curl_easy_perform(curl);
+			curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_);
 
 			curl_slist_free_all(dests);
-			curl_easy_cleanup(curl);
+			if (curl != session){
+				curl_easy_cleanup(curl);
+			}
 		}
 
 		return ret;
 	}
 
 	// Gnration du message
+	//	les PJ ne sont pas charges, seuls leurs noms sont conservs
 	//
-	std::string SMTPClient::_generate()
+	void SMTPClient::_generate(messageData& message)
 	{
 		std::string ret;
 
@@ -217,14 +245,12 @@ namespace jhbCURLTools
 
 		// PJ(s)
 		if (attachments_.size()){
-			std::string header, buffer, shortName;
-			size_t pos;
-
-			for (std::vector<std::string>::iterator it = attachments_.begin(); it != attachments_.end(); it++){
-				// Gnration du buffer pour le fichier
-				buffer = encoder_.file2Base64((*it));
-				if (buffer.size()){
-					// Le fichier existe et le buffer a t cre
+			std::string header, shortName;
+			size_t pos, index(0);
+
+			for (std::vector<std::string>::iterator it = attachments_.begin(); it != attachments_.end(); it++, index++){
+				if (messageData::fileSize((*it))){
+					// Le fichier existe et n'est pas vide
 					multiparted = true;
 
 					// Nom court du fichier
@@ -239,6 +265,11 @@ namespace jhbCURLTools
 						shortName = shortName.substr(pos + 1);
 					}
 
+					// ... ou nom impos
+					if (index < attachmentNames_.size() && attachmentNames_[index].size()){
+						shortName = attachmentNames_[index];
+					}
+
 					// Ajout au buffer
 					header = _fileName2MIMEType((*it));
 					header += "; name=\"";
@@ -248,7 +279,11 @@ namespace jhbCURLTools
 					ret += eol_ + "--" + separator + eol_;
 					ret += _addLine("Content-Type", header);
 					ret += _addLine("Content-Transfer-Encoding", "base64") + eol_;
-					ret += buffer;
+
+					// Le contenu du fichier sera encod lors de l'envoi
+					message.add(ret);
+					message.addFile((*it));
+					ret = "";
 				}
 			}
 		}
@@ -258,7 +293,7 @@ namespace jhbCURLTools
 			ret +=  "--" + separator + "--" + eol_ + eol_;
 		}
 
-		return ret;
+		message.add(ret);
 	}
 
 	// Date du jour
@@ -273,8 +308,9 @@ namespace jhbCURLTools
 		time_t tt;
 
 #ifdef _MSC_VER
+		tm tv, *t = &tv;
 		time(&tt);
-		tm *t = localtime(&tt);
+		localtime_s(t, &tt);
 #else
 		tm tv, *t = &tv;
 		tt = time(&tt);
@@ -290,29 +326,152 @@ namespace jhbCURLTools
 	//
 	size_t SMTPClient::_read(void *ptr, size_t size, size_t nmemb, void *userp)
 	{
-		// Pointeur sur mon buffer mmoire
-		StringData *text(reinterpret_cast<StringData *>(userp));
+		// Pointeur sur mon message
+		messageData *message(reinterpret_cast<messageData *>(userp));
+
+		// Vrification des paramtres
+		if (NULL != message && NULL != ptr && 0 != nmemb*size){
+			return message->read((char*)ptr, size*nmemb);
+		}
+
+		// Plus rien  retourner
+		return 0;
+	}
+
+	//---------------------------------------------------------------------------
+	//--
+	//--	jhbSMTP::SMTPClient::messageData
+	//--
+	//---------------------------------------------------------------------------
+
+	// Destruction
+	//
+	SMTPClient::messageData::~messageData()
+	{
+		if (file_){
+			fclose(file_);
+			file_ = NULL;
+		}
+	}
 
-		// Vrification des paramtres
-		if (NULL != text && NULL != ptr && 0 != nmemb*size){
-			size_t bytesLeft = text->size() - text->offset_;
+	// Ajout de texte
+	//
+	void SMTPClient::messageData::add(const std::string& text)
+	{
+		if (!text.size()){
+			return;
+		}
 
-			// Nombre d'octets  transfrer
-			// soit ((size*nmemb)) octets soit ce qu'il reste effectivement  copier
-			size_t transfer(((size*nmemb)>=bytesLeft)?bytesLeft:(size*nmemb));
+		// A la suite du texte prcdent ?
+		if (parts_.size() && !parts_.back().isFile_){
+			parts_.back().value_ += text;
+			return;
+		}
+
+		PART part;
+		part.isFile_ = false;
+		part.value_ = text;
+		parts_.push_back(part);
+	}
+
+	// Ajout d'une PJ
+	//	le fichier ne sera ouvert qu'au moment de l'envoi
+	//
+	void SMTPClient::messageData::addFile(const std::string& fileName)
+	{
+		PART part;
+		part.isFile_ = true;
+		part.value_ = fileName;
+		parts_.push_back(part);
+	}
+
+	// Taille d'un fichier (0 s'il n'existe pas)
+	//
+	size_t SMTPClient::messageData::fileSize(const std::string& fileName)
+	{
+		struct stat infos;
+		return ((0 == stat(fileName.c_str(), &infos)) ? (size_t)infos.st_size : 0);
+	}
+
+	// Copie dans le tampon de curl
+	//	retourne le nombre d'octets copis (0 => fin du message)
+	//
+	size_t SMTPClient::messageData::read(char* dest, size_t len)
+	{
+		size_t copied(0), transfer(0);
+		while (copied < len){
+			// Le tampon courant est vide => on passe  la suite
+			if (offset_ >= buffer_.size()){
+				if (!_next()){
+					// Fin du message ou PJ illisible (erreur ds que le tampon de curl est vide)
+					return ((copied || 0 == parts_.size()) ? copied : CURL_READFUNC_ABORT);
+				}
+				continue;
+			}
+
+			// Nombre d'octets  transfrer
+			// soit la place restante dans le tampon de curl, soit ce qu'il reste effectivement  copier
+			transfer = buffer_.size() - offset_;
+			if (transfer > (len - copied)){
+				transfer = len - copied;
+			}
 
 			// Copie
-			memcpy(ptr, text->buffer_.c_str() + text->offset_, transfer);
+			memcpy(dest + copied, buffer_.c_str() + offset_, transfer);
 
-			// Mise  jour des pointeurs
-			text->offset_ += transfer;
+			// Mise  jour des pointeurs
+			offset_ += transfer;
+			copied += transfer;
+		}
 
-			// Nombre d'octets copis
-			return transfer;
+		return copied;
+	}
+
+	// Remplissage du tampon avec la suite du message
+	//
+	bool SMTPClient::messageData::_next()
+	{
+		buffer_ = "";
+		offset_ = 0;
+
+		while (!buffer_.size()){
+			// PJ en cours d'encodage
+			if (file_){
+				// Toujours un multiple de 57 octets => des lignes compltes de 76 car.
+				unsigned char source[BASE64_CHUNK_LINES * RFC5322_BASE64_MAX_LINE_LEN];
+				size_t len(fread(source, sizeof(unsigned char), sizeof(source), file_));
+				if (len){
+					size_t lineLen(4 * RFC5322_BASE64_MAX_LINE_LEN / 3);
+					charUtils::appendBase64(buffer_, source, len, lineLen, lineLen, "\r\n");
+					buffer_ += "\r\n";
+				}
+				else{
+					// Fin du fichier
+					fclose(file_);
+					file_ = NULL;
+				}
+				continue;
+			}
+
+			// Plus rien  envoyer
+			if (!parts_.size()){
+				return false;
+			}
+
+			if (parts_.front().isFile_){
+				if (NULL == (file_ = fopen(parts_.front().value_.c_str(), "rb"))){
+					// Le fichier a disparu depuis la gnration du message
+					return false;
+				}
+			}
+			else{
+				buffer_ = parts_.front().value_;
+			}
+
+			parts_.pop_front();
 		}
 
-		// Plus rien  retourner
-		return 0;
+		return true;
 	}
 
 	// Cration d'une "ligne"
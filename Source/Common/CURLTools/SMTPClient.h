@@ -214,33 +214,67 @@ namespace jhbCURLTools{
 		{ return addRecipient(destAddr, NULL, destType); }
 
 		// Une pice jointe
-		bool addAttachment(const std::string& fileName)
-		{ attachments_.push_back(fileName); return true; }
+		//	le nom affich dans le message est, par dfaut, le nom court du fichier
+		bool addAttachment(const std::string& fileName, const std::string& name = "")
+		{ attachments_.push_back(fileName); attachmentNames_.push_back(name); return true; }
+
+		// Dure maximale de l'envoi en secondes (0 = pas de limite)
+		void setTimeout(long timeout)
+		{ timeout_ = timeout; }
 
 
 		// Envoi du message
-		CURLcode send(const std::string &url, int port, const std::string &user, const std::string& password, bool tls);
-		CURLcode send(const std::string &url, const std::string &user, const std::string& password, bool tls);
+		//	une session (handle curl) peut tre fournie : la connexion au serveur est alors
+		//	conserve d'un message  l'autre
+		CURLcode send(const std::string &url, int port, const std::string &user, const std::string& password, bool tls, CURL* session = NULL);
+		CURLcode send(const std::string &url, const std::string &user, const std::string& password, bool tls, CURL* session = NULL);
+
+		// Code retour du serveur pour le dernier envoi
+		long responseCode()
+		{ return response_; }
 
 		// Mthodes prives
 		//
 	private:
 
-		struct StringData{
-			std::string	buffer_;
-			size_t		offset_;
-
-			StringData(std::string &&m)
-			: buffer_{ m }, offset_{0}
+		// Contenu du message transmis  curl " la vole"
+		//	Le texte est conserv en mmoire, les PJ sont lues et encodes en base64
+		//	par blocs au fur et  mesure de l'envoi (jamais de copie complte du fichier)
+		//
+		class messageData{
+		public:
+			messageData()
+			: offset_{0}, file_{NULL}
 			{}
-			StringData(std::string &m) = delete;
-			size_t size()
-			{ return buffer_.size(); }
+			virtual ~messageData();
+
+			// Ajout de texte
+			void add(const std::string& text);
+
+			// Ajout d'une PJ
+			void addFile(const std::string& fileName);
+			static size_t fileSize(const std::string& fileName);
+
+			// Copie dans le tampon de curl
+			size_t read(char* dest, size_t len);
+
+		protected:
+			bool _next();
+
+			typedef struct tagPART{
+				bool		isFile_;
+				std::string	value_;		// Texte ou nom du fichier
+			}PART;
+
+			std::deque<PART>	parts_;
+			std::string			buffer_;	// Partie en cours d'envoi
+			size_t				offset_;
+			FILE*				file_;		// PJ en cours d'encodage
 		};
 
 		// Contenu du "message" curl
 		static size_t _read(void *ptr, size_t size, size_t nmemb, void *userp);  // Envoi
-		std::string _generate();  // Gnration du message
+		void _generate(messageData& message);  // Gnration du message
 
 		// Cration d'une "ligne"
 		//		Une "ligne" est dcoupe en une ou plusieurs lignes dans le flux de sortie
@@ -278,9 +312,13 @@ namespace jhbCURLTools{
 
 		// Pices jointes
 		std::vector<std::string>	attachments_;
+		std::vector<std::string>	attachmentNames_;
 
 		// Encodeur
 		charUtils					encoder_;
+
+		long						timeout_;
+		long						response_;
 	};
 }; // namespace jhbCURLTools
 
@@ -59,6 +59,401 @@
 //---------------------------------------------------------------------------
 
 
+//---------------------------------------------------------------------------
+//--
+//--		Fonctions vectorielles (SSE2 / SSSE3 / AVX2)
+//--
+//---------------------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define __CHAR_UTILS_X86__
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#define CHAR_UTILS_TARGET(isa)
+#else
+#include <immintrin.h>
+#define CHAR_UTILS_TARGET(isa)	__attribute__((target(isa)))
+#endif // _MSC_VER
+#endif // x86
+
+// Table de dcodage base64 (0xFF => caractre invalide)
+//
+static const unsigned char base64_values[256] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 62,   0xFF, 0xFF, 0xFF, 63,
+	52,   53,   54,   55,   56,   57,   58,   59,   60,   61,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0,    1,    2,    3,    4,    5,    6,    7,    8,    9,    10,   11,   12,   13,   14,
+	15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+	41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+#ifdef __CHAR_UTILS_X86__
+
+// Jeux d'instructions disponibles
+//
+typedef struct tagCPUFEATURES
+{
+	tagCPUFEATURES(){
+#ifdef _MSC_VER
+		int regs[4] = { 0, 0, 0, 0 };
+		__cpuid(regs, 0);
+		int maxLeaf(regs[0]);
+
+		__cpuid(regs, 1);
+		sse2_ = (0 != (regs[3] & (1 << 26)));
+		ssse3_ = (0 != (regs[2] & (1 << 9)));
+
+		// AVX2 : support CPU et sauvegarde des registres YMM par l'OS
+		avx2_ = false;
+		if (maxLeaf >= 7 && (regs[2] & (1 << 27)) && (regs[2] & (1 << 28))
+			&& 6 == (_xgetbv(0) & 6)){
+			__cpuidex(regs, 7, 0);
+			avx2_ = (0 != (regs[1] & (1 << 5)));
+		}
+#else
+		__builtin_cpu_init();
+		sse2_ = (0 != __builtin_cpu_supports("sse2"));
+		ssse3_ = (0 != __builtin_cpu_supports("ssse3"));
+		avx2_ = (0 != __builtin_cpu_supports("avx2"));
+#endif // _MSC_VER
+	}
+
+	bool	sse2_;
+	bool	ssse3_;
+	bool	avx2_;
+}CPUFEATURES;
+
+static const CPUFEATURES& _cpuFeatures()
+{
+	static const CPUFEATURES features;
+	return features;
+}
+
+// Recherche d'un caractre tendu (>127)
+//	retourne le nombre d'octets "ASCII" conscutifs en dbut de tampon
+//
+CHAR_UTILS_TARGET("sse2")
+static size_t _asciiPrefix_SSE2(const unsigned char* buffer, size_t len)
+{
+	size_t pos(0);
+	for (; pos + 16 <= len; pos += 16){
+		if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(buffer + pos)))){
+			break;
+		}
+	}
+
+	return pos;
+}
+
+CHAR_UTILS_TARGET("avx2")
+static size_t _asciiPrefix_AVX2(const unsigned char* buffer, size_t len)
+{
+	size_t pos(0);
+	for (; pos + 64 <= len; pos += 64){
+		__m256i block = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(buffer + pos)),
+										_mm256_loadu_si256((const __m256i*)(buffer + pos + 32)));
+		if (_mm256_movemask_epi8(block)){
+			break;
+		}
+	}
+	for (; pos + 32 <= len; pos += 32){
+		if (_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(buffer + pos)))){
+			break;
+		}
+	}
+
+	return pos;
+}
+
+// Encodage base64 de blocs de 12 octets (=> 16 car.)
+//	cf. W. Mula, D. Lemire "Faster Base64 Encoding and Decoding Using AVX2 Instructions"
+//
+CHAR_UTILS_TARGET("ssse3")
+static inline __m128i _base64Lookup_SSSE3(__m128i indices)
+{
+	const __m128i shift_LUT = _mm_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+		'/' - 63, 'A', 0, 0);
+
+	__m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+	result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+	result = _mm_shuffle_epi8(shift_LUT, result);
+	return _mm_add_epi8(result, indices);
+}
+
+CHAR_UTILS_TARGET("ssse3")
+static inline __m128i _base64Split_SSSE3(__m128i in)
+{
+	in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+	const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+	const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+	const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+	return _mm_or_si128(t1, t3);
+}
+
+// retourne le nombre d'octets sources traits (multiple de 12)
+CHAR_UTILS_TARGET("ssse3")
+static size_t _encodeBase64_SSSE3(char* dest, const unsigned char* src, size_t len)
+{
+	size_t done(0);
+
+	// 16 octets sont lus pour 12 utiliss
+	while (done + 16 <= len){
+		__m128i in = _mm_loadu_si128((const __m128i*)(src + done));
+		_mm_storeu_si128((__m128i*)dest, _base64Lookup_SSSE3(_base64Split_SSSE3(in)));
+		dest += 16;
+		done += 12;
+	}
+
+	return done;
+}
+
+CHAR_UTILS_TARGET("avx2")
+static size_t _encodeBase64_AVX2(char* dest, const unsigned char* src, size_t len)
+{
+	size_t done(0);
+
+	const __m256i shuffle = _mm256_set_epi8(
+		10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+		10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	const __m256i shift_LUT = _mm256_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+		'/' - 63, 'A', 0, 0,
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+		'/' - 63, 'A', 0, 0);
+
+	// 2 x 12 octets par itration (lecture de 28 octets)
+	while (done + 28 <= len){
+		__m256i in = _mm256_inserti128_si256(
+						_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(src + done))),
+						_mm_loadu_si128((const __m128i*)(src + done + 12)), 1);
+		in = _mm256_shuffle_epi8(in, shuffle);
+
+		const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+		const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+		const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+		const __m256i indices = _mm256_or_si256(t1, t3);
+
+		__m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+		const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+		result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+		result = _mm256_shuffle_epi8(shift_LUT, result);
+
+		_mm256_storeu_si256((__m256i*)dest, _mm256_add_epi8(result, indices));
+		dest += 32;
+		done += 24;
+	}
+
+	return done;
+}
+
+// Dcodage base64 de blocs de 16 car. (=> 12 octets)
+//	Le traitement s'arrte au premier bloc contenant un caractre invalide (ou '=')
+//	dest doit pouvoir recevoir 4 octets supplmentaires
+//	retourne le nombre de caractres traits (multiple de 16)
+//
+CHAR_UTILS_TARGET("ssse3")
+static size_t _decodeBase64_SSSE3(unsigned char* dest, const char* src, size_t len)
+{
+	const __m128i lut_lo = _mm_setr_epi8(
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+		0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m128i lut_hi = _mm_setr_epi8(
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i lut_roll = _mm_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71,
+		0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i mask_2F = _mm_set1_epi8(0x2f);
+	const __m128i zero = _mm_setzero_si128();
+
+	size_t done(0);
+	while (done + 16 <= len){
+		const __m128i in = _mm_loadu_si128((const __m128i*)(src + done));
+
+		// Validation
+		const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2F);
+		const __m128i lo_nibbles = _mm_and_si128(in, mask_2F);
+		const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+		const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+		if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero))){
+			break;
+		}
+
+		// Conversion car. => valeurs sur 6 bits
+		const __m128i eq_2F = _mm_cmpeq_epi8(in, mask_2F);
+		const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2F, hi_nibbles));
+		const __m128i values = _mm_add_epi8(in, roll);
+
+		// Regroupement 4 x 6 bits => 3 octets
+		const __m128i merge_ab_and_bc = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+		__m128i out = _mm_madd_epi16(merge_ab_and_bc, _mm_set1_epi32(0x00011000));
+		out = _mm_shuffle_epi8(out, _mm_setr_epi8(
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+		_mm_storeu_si128((__m128i*)dest, out);
+		dest += 12;
+		done += 16;
+	}
+
+	return done;
+}
+
+#endif // __CHAR_UTILS_X86__
+
+// Encodage scalaire d'un nombre quelconque d'octets (avec remplissage)
+//
+static size_t _encodeBase64_scalar(char* dest, const unsigned char* src, size_t len)
+{
+	char* start(dest);
+	size_t pos(0);
+	for (; pos + 3 <= len; pos += 3){
+		unsigned int value = ((unsigned int)src[pos] << 16) | ((unsigned int)src[pos + 1] << 8) | src[pos + 2];
+		*dest++ = base64_chars[(value >> 18) & 0x3F];
+		*dest++ = base64_chars[(value >> 12) & 0x3F];
+		*dest++ = base64_chars[(value >> 6) & 0x3F];
+		*dest++ = base64_chars[value & 0x3F];
+	}
+
+	// Reste (complt par des '=')
+	if (pos < len){
+		unsigned int value = (unsigned int)src[pos] << 16;
+		if (pos + 1 < len){
+			value |= (unsigned int)src[pos + 1] << 8;
+		}
+
+		*dest++ = base64_chars[(value >> 18) & 0x3F];
+		*dest++ = base64_chars[(value >> 12) & 0x3F];
+		*dest++ = (pos + 1 < len ? base64_chars[(value >> 6) & 0x3F] : '=');
+		*dest++ = '=';
+	}
+
+	return (size_t)(dest - start);
+}
+
+// Encodage d'un tampon complet (sans dcoupage)
+//
+static size_t _encodeBase64(char* dest, const unsigned char* src, size_t len)
+{
+	size_t done(0), written(0);
+
+#ifdef __CHAR_UTILS_X86__
+	if (_cpuFeatures().avx2_){
+		done = _encodeBase64_AVX2(dest, src, len);
+	}
+	if (_cpuFeatures().ssse3_){
+		done += _encodeBase64_SSSE3(dest + done / 3 * 4, src + done, len - done);
+	}
+	written = done / 3 * 4;
+#endif // __CHAR_UTILS_X86__
+
+	return written + _encodeBase64_scalar(dest + written, src + done, len - done);
+}
+
+// Nombre d'octets "ASCII" conscutifs en dbut de tampon
+//
+static size_t _asciiPrefix(const unsigned char* buffer, size_t len)
+{
+	size_t pos(0);
+
+#ifdef __CHAR_UTILS_X86__
+	// Recherche par blocs de 16 ou 32 octets
+	if (_cpuFeatures().avx2_){
+		pos = _asciiPrefix_AVX2(buffer, len);
+	}
+	else{
+		if (_cpuFeatures().sse2_){
+			pos = _asciiPrefix_SSE2(buffer, len);
+		}
+	}
+#endif // __CHAR_UTILS_X86__
+
+	while (pos < len && buffer[pos] < 0x80){
+		pos++;
+	}
+
+	return pos;
+}
+
+// Caractres CP1252 de 0x80  0x9F (les autres car. sont identiques en ISO-8859-1)
+//
+static const unsigned short cp1252_codepoints[32] = {
+	0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+	0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+// Encodage UTF8 des caractres tendus (0x80 - 0xFF)
+//
+typedef struct tagUTF8CHAR
+{
+	unsigned char	len_;
+	char			bytes_[3];
+}UTF8CHAR;
+
+static const UTF8CHAR* _utf8Table()
+{
+	static UTF8CHAR table[128];
+	static bool init = [](){
+		for (unsigned int ch = 0x80; ch <= 0xFF; ch++){
+			unsigned int codepoint = (ch < 0xA0 ? cp1252_codepoints[ch - 0x80] : ch);
+			UTF8CHAR& dest = table[ch - 0x80];
+			if (codepoint < 0x800){
+				dest.len_ = 2;
+				dest.bytes_[0] = (char)(0xC0 | (codepoint >> 6));
+				dest.bytes_[1] = (char)(0x80 | (codepoint & 0x3F));
+			}
+			else{
+				dest.len_ = 3;
+				dest.bytes_[0] = (char)(0xE0 | (codepoint >> 12));
+				dest.bytes_[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+				dest.bytes_[2] = (char)(0x80 | (codepoint & 0x3F));
+			}
+		}
+		return true;
+	}();
+
+	(void)init;
+	return table;
+}
+
+// Caractre CP1252 correspondant  un point de code (0 si absent)
+//
+static inline unsigned char _cp1252Char(unsigned int codepoint)
+{
+	if (codepoint <= 0xFF){
+		return (unsigned char)codepoint;
+	}
+
+	for (unsigned int index = 0; index < 32; index++){
+		if (cp1252_codepoints[index] == codepoint){
+			return (unsigned char)(0x80 + index);
+		}
+	}
+
+	return 0;
+}
+
+
 //---------------------------------------------------------------------------
 //--
 //--		Classe charUtils
@@ -113,13 +508,12 @@ std::string charUtils::eol(FORMAT_EOL eType)
 //
 bool charUtils::convert_fromUTF8(std::string& source)
 {
-#ifdef _WIN32
-	std::string out = _win32_UTF8toISO8859_1(source);
-#else
-	std::string out = _UTF8toISO8859_1(source);
-#endif // #ifdef _WIN32
+	// Rien  faire pour une chaine ASCII
+	if (!isPureASCII(source)){
+		fromUTF8(buffer_, source.c_str(), source.size());
+		source.swap(buffer_);		// Les 2 tampons seront rutiliss
+	}
 
-	source = out;
 	return true;
 }
 
@@ -130,40 +524,173 @@ bool charUtils::convert_fromUTF8(std::string& source)
 //
 bool charUtils::convert_toUTF8(std::string& source, bool MIMEEncode)
 {
-	// Conversion
-#ifdef _WIN32
-	std::string out = _win32_ISO8859_1toUTF8(source);
-#else
-	std::string out = _ISO8859_1toUTF8(source);
-#endif // #ifdef _WIN32
+	// Conversion (rien  faire pour une chaine ASCII)
+	if (!isPureASCII(source)){
+		toUTF8(buffer_, source.c_str(), source.size());
+		source.swap(buffer_);		// Les 2 tampons seront rutiliss
+	}
 
 	// En hexa ?
 	if (MIMEEncode){
 		std::string Xout("");
 		char value[4];
-		for (std::string::iterator it = out.begin(); it != out.end(); it++){
+		for (std::string::iterator it = source.begin(); it != source.end(); it++){
 			sprintf(value, "=%02X", (*it));
 			Xout.append(value);
+		}
+
+		if (Xout.size()){
 			source = Xout;
 		}
 	}
-	else{
-		source = out;
-	}
 
 	// Termin
 	return true;
 }
 
+// Transcodage CP1252 => UTF8 dans un tampon
+//	dest doit pouvoir contenir 3 * len octets
+//	retourne le nombre d'octets crits
+//
+size_t charUtils::latin1ToUTF8(char* dest, const char* src, size_t len)
+{
+	const unsigned char* in = (const unsigned char*)src;
+	const UTF8CHAR* table(_utf8Table());
+	char* out(dest);
+	size_t pos(0), run(0);
+
+	while (pos < len){
+		// Copie des caractres ASCII par blocs
+		if (0 != (run = _asciiPrefix(in + pos, len - pos))){
+			memcpy(out, in + pos, run);
+			out += run;
+			pos += run;
+		}
+
+		// Caractres tendus
+		while (pos < len && in[pos] >= 0x80){
+			const UTF8CHAR& car = table[in[pos++] - 0x80];
+			out[0] = car.bytes_[0];
+			out[1] = car.bytes_[1];
+			out[2] = car.bytes_[2];
+			out += car.len_;
+		}
+	}
+
+	return (size_t)(out - dest);
+}
+
+// Transcodage UTF8 => CP1252 dans un tampon
+//	dest doit pouvoir contenir len octets
+//	les caractres sans quivalent (et les squences invalides) sont ignors
+//	retourne le nombre d'octets crits
+//
+size_t charUtils::UTF8ToLatin1(char* dest, const char* src, size_t len)
+{
+	const unsigned char* in = (const unsigned char*)src;
+	char* out(dest);
+	size_t pos(0), run(0), count(0), index(0);
+	unsigned int codepoint(0);
+	unsigned char ch(0);
+
+	while (pos < len){
+		// Copie des caractres ASCII par blocs
+		if (0 != (run = _asciiPrefix(in + pos, len - pos))){
+			memcpy(out, in + pos, run);
+			out += run;
+			pos += run;
+		}
+
+		// Squences multi-octets
+		while (pos < len && (ch = in[pos]) >= 0x80){
+			if (ch >= 0xC0 && ch <= 0xDF){
+				count = 1;
+				codepoint = ch & 0x1F;
+			}
+			else{
+				if (ch >= 0xE0 && ch <= 0xEF){
+					count = 2;
+					codepoint = ch & 0x0F;
+				}
+				else{
+					if (ch >= 0xF0 && ch <= 0xF7){
+						count = 3;
+						codepoint = ch & 0x07;
+					}
+					else{
+						// Octet de continuation isol
+						pos++;
+						continue;
+					}
+				}
+			}
+
+			// Octets de continuation
+			for (index = 1; index <= count && (pos + index) < len && 0x80 == (in[pos + index] & 0xC0); index++){
+				codepoint = (codepoint << 6) | (in[pos + index] & 0x3F);
+			}
+
+			if (index > count && 0 != (ch = _cp1252Char(codepoint))){
+				*out++ = (char)ch;
+			}
+
+			pos += index;
+		}
+	}
+
+	return (size_t)(out - dest);
+}
+
+// Versions "std::string" (la capacit de dest est conserve d'un appel  l'autre)
+//
+void charUtils::latin1ToUTF8(std::string& dest, const char* src, size_t len)
+{
+	dest.resize(3 * len);
+	dest.resize(len ? latin1ToUTF8(&dest[0], src, len) : 0);
+}
+
+void charUtils::UTF8ToLatin1(std::string& dest, const char* src, size_t len)
+{
+	dest.resize(len);
+	dest.resize(len ? UTF8ToLatin1(&dest[0], src, len) : 0);
+}
+
+// Conversions dans un tampon
+//
+void charUtils::toUTF8(std::string& dest, const char* value, size_t len)
+{
+#ifdef _WIN32
+	// La table de transcodage ne concerne que la page de code 1252
+	if (1252 != GetACP()){
+		std::string source(value, len);
+		dest = _win32_ISO8859_1toUTF8(source);
+		return;
+	}
+#endif // _WIN32
+
+	latin1ToUTF8(dest, value, len);
+}
+
+void charUtils::fromUTF8(std::string& dest, const char* value, size_t len)
+{
+#ifdef _WIN32
+	if (1252 != GetACP()){
+		std::string source(value, len);
+		dest = _win32_UTF8toISO8859_1(source);
+		return;
+	}
+#endif // _WIN32
+
+	UTF8ToLatin1(dest, value, len);
+}
+
 // Encodage UTF8 du texte
 //
 std::string charUtils::toUTF8(const char* value, size_t len)
 {
 	std::string source("");
 	if (len && value){
-		source = value;
-		source.resize(len);
-		convert_toUTF8(source, false);
+		toUTF8(source, value, len);
 	}
 
 	return source;
@@ -257,22 +784,17 @@ bool charUtils::utf8_check_is_valid(const std::string& string)
 //
 bool charUtils::isPureASCII(const char* str)
 {
-    if (!IS_EMPTY(str)){
-        const unsigned char* car = (const unsigned char*)str;
-        while (*car != 0x00) {
-             if (*car > 127){
-                // Un seul caractre tendu suffit !!!
-                return false;
-            }
-
-            // Caractre suivant
-            car++;
-        }
+    return (IS_EMPTY(str) ? true : isPureASCII(str, strlen(str)));
+}
 
+bool charUtils::isPureASCII(const char* str, size_t len)
+{
+    if (nullptr == str){
+        return true;
     }
 
-    // Oui ...
-    return true;
+    // Un seul caractre tendu suffit !!!
+    return (len == _asciiPrefix((const unsigned char*)str, len));
 }
 
 // Accs  un caractre par son index
@@ -319,72 +841,135 @@ size_t charUtils::utf8_realIndex(const std::string& source, size_t index)
 //
 std::string charUtils::toBase64(unsigned char const* bytes_to_encode, size_t in_len)
 {
-	std::string ret;
-	int i = 0, j = 0;
-	unsigned char char_array_3[3], char_array_4[4];
+	std::string ret("");
+	appendBase64(ret, bytes_to_encode, in_len);
+	return ret;
+}
 
-	while (in_len--){
-		char_array_3[i++] = *(bytes_to_encode++);
-		if (i == 3){
-			char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-			char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-			char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-			char_array_4[3] = char_array_3[2] & 0x3f;
+// Taille du tampon ncessaire  l'encodage (sans le 0 terminal)
+//
+size_t charUtils::base64Size(size_t len, size_t firstLen, size_t lineLen, size_t foldLen)
+{
+	size_t total(4 * ((len + 2) / 3));
+	if (0 == firstLen || 0 == lineLen || 0 == foldLen || total <= firstLen){
+		return total;
+	}
 
-			for (i = 0; (i < 4); i++) {
-				ret += base64_chars[char_array_4[i]];
-			}
-			i = 0;
-		}
+	// Nombre de sparateurs de lignes
+	return total + foldLen * (1 + (total - firstLen - 1) / lineLen);
+}
+
+// Encodage dans un tampon avec dcoupage des lignes
+//	retourne le nombre de caractres crits
+//
+size_t charUtils::encodeBase64(char* dest, unsigned char const* src, size_t len, size_t firstLen, size_t lineLen, const char* fold)
+{
+	size_t foldLen(IS_EMPTY(fold) ? 0 : strlen(fold));
+	if (0 == firstLen || 0 == lineLen || 0 == foldLen){
+		// Pas de dcoupage
+		return _encodeBase64(dest, src, len);
 	}
 
-	if (i)
-	{
-		for (j = i; j < 3; j++) {
-			char_array_3[j] = '\0';
+	size_t total(4 * ((len + 2) / 3));		// Nombre de car. encods
+	size_t pos(0), end(0), count(firstLen);
+	size_t quad(0), bytes(0);
+	char buffer[4];
+	char* out(dest);
+
+	while (pos < total){
+		end = ((pos + count) < total ? pos + count : total);
+
+		// La ligne commence au milieu d'un quadruplet
+		if (pos % 4){
+			quad = pos / 4;
+			_encodeBase64_scalar(buffer, src + 3 * quad, (len - 3 * quad) < 3 ? (len - 3 * quad) : 3);
+
+			bytes = ((4 * (quad + 1)) < end ? 4 * (quad + 1) : end) - pos;
+			memcpy(out, buffer + pos % 4, bytes);
+			out += bytes;
+			pos += bytes;
 		}
 
-		char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-		char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-		char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-		char_array_4[3] = char_array_3[2] & 0x3f;
+		// Quadruplets complets
+		if (end / 4 > pos / 4){
+			quad = pos / 4;
+			bytes = 3 * (end / 4 - quad);
+			if (bytes > len - 3 * quad){
+				bytes = len - 3 * quad;
+			}
 
-		for (j = 0; (j < i + 1); j++) {
-			ret += base64_chars[char_array_4[j]];
+			out += _encodeBase64(out, src + 3 * quad, bytes);
+			pos = 4 * (end / 4);
 		}
 
-		// On complte  4 par le car. "="
-		while ((i++ < 3)){
-			ret += '=';
+		// La ligne se termine au milieu d'un quadruplet
+		if (pos < end){
+			quad = pos / 4;
+			_encodeBase64_scalar(buffer, src + 3 * quad, (len - 3 * quad) < 3 ? (len - 3 * quad) : 3);
+
+			memcpy(out, buffer, end - pos);
+			out += (end - pos);
+			pos = end;
 		}
+
+		// Ligne suivante
+		if (pos < total){
+			memcpy(out, fold, foldLen);
+			out += foldLen;
+		}
+
+		count = lineLen;
 	}
 
-	return ret;
+	return (size_t)(out - dest);
+}
+
+// Encodage  la fin d'une chaine
+//
+void charUtils::appendBase64(std::string& dest, unsigned char const* src, size_t len, size_t firstLen, size_t lineLen, const char* fold)
+{
+	if (0 == len){
+		return;
+	}
+
+	size_t start(dest.size());
+	dest.resize(start + base64Size(len, firstLen, lineLen, IS_EMPTY(fold) ? 0 : strlen(fold)));
+	encodeBase64(&dest[start], src, len, firstLen, lineLen, fold);
 }
 
 // Dcodage base64
+//	le dcodage s'arrte au premier caractre invalide (ou '=')
 //
 std::string charUtils::fromBase64(std::string const& encoded_string)
 {
-	size_t in_len = encoded_string.size();
-	int i = 0, j = 0, in_ = 0;
-	unsigned char char_array_4[4], char_array_3[3];
-	std::string ret;
+	size_t in_len(encoded_string.size()), pos(0), written(0);
+	std::string ret("");
+	if (0 == in_len){
+		return ret;
+	}
 
-	while (in_len-- && (encoded_string[in_] != '=') && _is_base64(encoded_string[in_])){
-		char_array_4[i++] = encoded_string[in_]; in_++;
-		if (i == 4) {
-			for (i = 0; i < 4; i++) {
-				char_array_4[i] = (char)base64_chars.find(char_array_4[i]);
-			}
+	// 4 octets de plus pour les critures par blocs de 16
+	ret.resize(in_len / 4 * 3 + 16);
+	unsigned char* out = (unsigned char*)&ret[0];
 
-			char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-			char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-			char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
+#ifdef __CHAR_UTILS_X86__
+	if (_cpuFeatures().ssse3_){
+		pos = _decodeBase64_SSSE3(out, encoded_string.c_str(), in_len);
+		written = pos / 4 * 3;
+	}
+#endif // __CHAR_UTILS_X86__
 
-			for (i = 0; (i < 3); i++) {
-				ret += char_array_3[i];
-			}
+	// Fin du dcodage
+	unsigned char char_array_4[4], value;
+	int i(0), j(0);
+	while (pos < in_len && 0xFF != (value = base64_values[(unsigned char)encoded_string[pos]])){
+		char_array_4[i++] = value;
+		pos++;
+
+		if (i == 4) {
+			out[written++] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
+			out[written++] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
+			out[written++] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
 			i = 0;
 		}
 	}
@@ -395,35 +980,31 @@ std::string charUtils::fromBase64(std::string const& encoded_string)
 			char_array_4[j] = 0;
 		}
 
-		for (j = 0; j < 4; j++) {
-			char_array_4[j] = (char)base64_chars.find(char_array_4[j]);
-		}
-
+		unsigned char char_array_3[3];
 		char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
 		char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
 		char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
 
 		for (j = 0; (j < i - 1); j++) {
-			ret += char_array_3[j];
+			out[written++] = char_array_3[j];
 		}
 	}
 
+	ret.resize(written);
 	return ret;
 }
 
 // Encodage complet d'une chaine de caractres
+//	lignes de 76 car. (cf. RFC5322)
 //
 std::string charUtils::text2Base64(const std::string& source)
 {
 	std::string out("");
-	size_t pos(0), tailleMax(source.size()), taille;
-	const char* value = source.c_str();
+	size_t lineLen(4 * RFC5322_BASE64_MAX_LINE_LEN / 3);
 
-	// Dcoupage ligne  ligne
-	while (pos < tailleMax){
-		taille = ((pos + RFC5322_BASE64_MAX_LINE_LEN)<tailleMax ? RFC5322_BASE64_MAX_LINE_LEN : (tailleMax - pos));
-		out += toBase64(reinterpret_cast<const unsigned char*>(value + pos), taille) + "\r\n";
-		pos += taille;
+	appendBase64(out, (const unsigned char*)source.c_str(), source.size(), lineLen, lineLen, "\r\n");
+	if (out.size()){
+		out += "\r\n";
 	}
 
 	return out;
@@ -445,21 +1026,21 @@ std::string charUtils::file2Base64(const std::string& fileName)
 		tailleMax = ftell(file);
 		fseek(file, 0, SEEK_SET);
 
-		size_t pointeur(0);
-		char wBuffer[RFC5322_BASE64_MAX_LINE_LEN +1];		// Mon wBuffer de lecture
-		while (pointeur < tailleMax){
-			// Lecture d'un paquet
-			len = fread(wBuffer, sizeof(char), RFC5322_BASE64_MAX_LINE_LEN, file);
-			wBuffer[len] = 0;
-
-			// Ajout de la ligne
-			fContent += toBase64(reinterpret_cast<unsigned char*>(wBuffer), len) + "\r\n";
-
-			pointeur += len;
-		}
+		// Lecture du contenu
+		std::string wBuffer("");
+		wBuffer.resize(tailleMax);
+		len = (tailleMax ? fread(&wBuffer[0], sizeof(char), tailleMax, file) : 0);
 
 		// Fermeture du fichier
 		fclose(file);
+
+		// Encodage en une seule passe, par lignes de 76 car.
+		size_t lineLen(4 * RFC5322_BASE64_MAX_LINE_LEN / 3);
+		fContent.reserve(base64Size(len, lineLen, lineLen, 2) + 2);
+		appendBase64(fContent, (const unsigned char*)wBuffer.c_str(), len, lineLen, lineLen, "\r\n");
+		if (fContent.size()){
+			fContent += "\r\n";
+		}
 	}
 
 	// Termin
@@ -813,119 +1394,6 @@ std::string charUtils::itoa(int num, int radix, int digits)
 	return std::string(buffer);
 }
 
-// Mthodes de conversion
-//
-
-// => UTF8
-//
-std::string charUtils::_ISO8859_1toUTF8(std::string &str)
-{
-	std::string out("");
-	for (std::string::iterator it = str.begin(); it != str.end(); ++it){
-		uint8_t ch = *it;
-#ifdef _DEBUG
-		if (ch == 140) {
-			int i(3);
-			i++;
-		}
-#endif // #ifdef _DEBUG
-		if (ch < 0x80) {
-			out.push_back(ch);
-		}
-		else{
-			// http://html-codes.info/ansi/html/Windows-1252-Latin%20capital%20ligature%20OE_140
-
-			//if (ch == '')
-			if (ch == 140){
-				/*
-				if (extendedLatin_)
-				{
-				*/
-				out.push_back((__int8)0xc5);
-				out.push_back((__int8)0x92);
-				/*
-				}
-				else
-				{
-					out.push_back((__int8)'O');
-					out.push_back((__int8)'E');
-				}
-				*/
-			}
-			else{
-				//if (ch == '')
-				if (ch == 156){
-					/*
-					if (extendedLatin_)
-					{*/
-					out.push_back((__int8)0xc5);
-					out.push_back((__int8)0x93);
-					/*}
-					else
-					{
-						out.push_back((__int8)'o');
-						out.push_back((__int8)'e');
-					}*/
-				}
-				else{
-					// Encodage standard
-					out.push_back(0xc0 | ch >> 6);
-					out.push_back(0x80 | (ch & 0x3f));
-				}
-			}
-		}
-	}
-
-	return out;
-}
-
-// UTF8 =>
-//
-std::string charUtils::_UTF8toISO8859_1(const std::string& str)
-{
-	std::string out("");
-	if (!str.size()){
-		return out;
-	}
-
-	unsigned int codepoint(0);
-	const char* in = str.c_str(), *prev(nullptr);
-	while (*in != 0){
-		unsigned char ch = static_cast<unsigned char>(*in);
-		if (ch <= 0x7f)
-			codepoint = ch;
-		else if (ch <= 0xbf)
-			codepoint = (codepoint << 6) | (ch & 0x3f);
-		else if (ch <= 0xdf)
-			codepoint = ch & 0x1f;
-		else if (ch <= 0xef)
-			codepoint = ch & 0x0f;
-		else
-			codepoint = ch & 0x07;
-		prev = (in++);
-		if (((*in & 0xc0) != 0x80) && (codepoint <= 0x10ffff)){
-			if (codepoint <= 255){
-				out.append(1, static_cast<char>(codepoint));
-			}
-			else{
-				// Autres caractres
-				//
-				if (*(prev-1) == (__int8)0xc5){
-					if (*prev == (__int8)0x92){
-						out.push_back((__int8)140);
-					}
-					else{
-						if (*prev == (__int8)0x93){
-							out.push_back((__int8)156);
-						}
-					}
-				}
-			}
-		}
-	}
-	return out;
-}
-
 // Version WIN32
 //
 
@@ -179,6 +179,17 @@ public:
 		return str;
 	}
 
+	// Versions "tampon" : le rsultat remplace le contenu de dest (dont la capacit est rutilise)
+	void toUTF8(std::string& dest, const char* value, size_t len);
+	void fromUTF8(std::string& dest, const char* value, size_t len);
+
+	// Transcodage CP1252 (ISO-8859-1 + , , , ...) <=> UTF8 sans allocation
+	//	les caractres ASCII sont copis par blocs
+	static size_t latin1ToUTF8(char* dest, const char* src, size_t len);		// dest : 3 * len octets
+	static size_t UTF8ToLatin1(char* dest, const char* src, size_t len);		// dest : len octets
+	static void latin1ToUTF8(std::string& dest, const char* src, size_t len);
+	static void UTF8ToLatin1(std::string& dest, const char* src, size_t len);
+
 	// Codage UTF8 valide ?
 	static bool isValidUTF8(const char* source);
 	static bool isValidUTF8(const std::string source)
@@ -186,8 +197,9 @@ public:
 	//bool utf8_check_is_valid(const std::string& string);
 
 	static bool isPureASCII(const char* str);
-	static bool isPureASCII(const std::string str)
-	{ return charUtils::isPureASCII(str.c_str()); }
+	static bool isPureASCII(const char* str, size_t len);
+	static bool isPureASCII(const std::string& str)
+	{ return charUtils::isPureASCII(str.c_str(), str.size()); }
 
 	// Accs
     static size_t utf8_realIndex(const std::string& source, size_t index);
@@ -201,6 +213,13 @@ public:
 	{ return toBase64((unsigned char const*)source.c_str(), source.length()); }
 	std::string fromBase64(std::string const& s);
 
+	// Encodage base64 dans un tampon, avec dcoupage des lignes " la vole"
+	//	firstLen : longueur max. de la premire ligne, lineLen : des lignes suivantes (0 => pas de dcoupage)
+	//	fold : sparateur insr entre les lignes
+	static size_t base64Size(size_t len, size_t firstLen = 0, size_t lineLen = 0, size_t foldLen = 0);
+	static size_t encodeBase64(char* dest, unsigned char const* src, size_t len, size_t firstLen = 0, size_t lineLen = 0, const char* fold = nullptr);
+	static void appendBase64(std::string& dest, unsigned char const* src, size_t len, size_t firstLen = 0, size_t lineLen = 0, const char* fold = nullptr);
+
 	// Utilitaires
 	std::string text2Base64(const std::string& source);
 	std::string file2Base64(const std::string& fileName);
@@ -299,9 +318,6 @@ protected:
 	}
 
 	// Conversions
-	std::string _UTF8toISO8859_1(const std::string& str);
-	std::string _ISO8859_1toUTF8(std::string &str);
-
 #ifdef _WIN32
 	std::string _win32_UTF8toISO8859_1(const std::string& str) {
 		return _win32_UTF8Convert(str, CP_UTF8, CP_ACP);
@@ -319,6 +335,7 @@ protected :
 	bool					initialized_;
 	SOURCE_FORMAT			format_;
 	std::string				eol_;		// Saut de ligne
+	std::string				buffer_;	// Tampon pour les conversions "sur place"
 };
 
 #endif // __JHB_CHAR_UTILS_h__
@@ -0,0 +1,237 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: charUtils_bench.cpp
+//--
+//--	AUTEUR	: Jrme Henry-Barnaudire - JHB
+//--
+//--	PROJET	:
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--		Mesure des performances de l'encodage base64 et de la dtection
+//--		ASCII de charUtils par rapport aux versions scalaires prcdentes
+//--		(reprises ci-dessous comme rfrence).
+//--
+//--		Programme autonome, hors des projets :
+//--			g++ -O2 -std=c++17 -DLINUX -I. charUtils_bench.cpp charUtils.cpp -o charUtils_bench
+//--
+//--		Les rsultats sont compars  ceux de la rfrence avant chaque mesure.
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#include "charUtils.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+//----------------------------------------------------------------------
+//--
+//-- Versions de rfrence (scalaires)
+//--
+//----------------------------------------------------------------------
+
+static const std::string refChars("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+
+// Dtection ASCII, octet par octet
+//
+static bool refIsPureASCII(const char* str)
+{
+	const unsigned char* car = (const unsigned char*)str;
+	while (*car != 0x00) {
+		if (*car > 127) {
+			return false;
+		}
+		car++;
+	}
+
+	return true;
+}
+
+// Encodage base64, caractre par caractre
+//
+static std::string refToBase64(unsigned char const* src, size_t len)
+{
+	std::string ret;
+	int i = 0, j = 0;
+	unsigned char in[3], out[4];
+
+	while (len--) {
+		in[i++] = *(src++);
+		if (i == 3) {
+			out[0] = (in[0] & 0xfc) >> 2;
+			out[1] = ((in[0] & 0x03) << 4) + ((in[1] & 0xf0) >> 4);
+			out[2] = ((in[1] & 0x0f) << 2) + ((in[2] & 0xc0) >> 6);
+			out[3] = in[2] & 0x3f;
+			for (i = 0; i < 4; i++) {
+				ret += refChars[out[i]];
+			}
+			i = 0;
+		}
+	}
+
+	if (i) {
+		for (j = i; j < 3; j++) {
+			in[j] = '\0';
+		}
+
+		out[0] = (in[0] & 0xfc) >> 2;
+		out[1] = ((in[0] & 0x03) << 4) + ((in[1] & 0xf0) >> 4);
+		out[2] = ((in[1] & 0x0f) << 2) + ((in[2] & 0xc0) >> 6);
+		out[3] = in[2] & 0x3f;
+		for (j = 0; j < i + 1; j++) {
+			ret += refChars[out[j]];
+		}
+
+		while (i++ < 3) {
+			ret += '=';
+		}
+	}
+
+	return ret;
+}
+
+// Dcodage base64
+//
+static std::string refFromBase64(std::string const& encoded)
+{
+	size_t len = encoded.size();
+	int i = 0, j = 0, pos = 0;
+	unsigned char in[4], out[3];
+	std::string ret;
+
+	while (len-- && (encoded[pos] != '=') && (isalnum((unsigned char)encoded[pos]) || encoded[pos] == '+' || encoded[pos] == '/')) {
+		in[i++] = encoded[pos++];
+		if (i == 4) {
+			for (i = 0; i < 4; i++) {
+				in[i] = (unsigned char)refChars.find(in[i]);
+			}
+
+			out[0] = (in[0] << 2) + ((in[1] & 0x30) >> 4);
+			out[1] = ((in[1] & 0xf) << 4) + ((in[2] & 0x3c) >> 2);
+			out[2] = ((in[2] & 0x3) << 6) + in[3];
+			for (i = 0; i < 3; i++) {
+				ret += out[i];
+			}
+			i = 0;
+		}
+	}
+
+	if (i) {
+		for (j = i; j < 4; j++) {
+			in[j] = 0;
+		}
+
+		for (j = 0; j < 4; j++) {
+			in[j] = (unsigned char)refChars.find(in[j]);
+		}
+
+		out[0] = (in[0] << 2) + ((in[1] & 0x30) >> 4);
+		out[1] = ((in[1] & 0xf) << 4) + ((in[2] & 0x3c) >> 2);
+		out[2] = ((in[2] & 0x3) << 6) + in[3];
+		for (j = 0; j < i - 1; j++) {
+			ret += out[j];
+		}
+	}
+
+	return ret;
+}
+
+// Encodage par lignes de 57 octets (corps des mails)
+//
+static std::string refText2Base64(const std::string& source)
+{
+	std::string out("");
+	size_t pos(0), size(source.size()), len;
+	const char* value = source.c_str();
+
+	while (pos < size) {
+		len = ((pos + RFC5322_BASE64_MAX_LINE_LEN) < size ? RFC5322_BASE64_MAX_LINE_LEN : (size - pos));
+		out += refToBase64(reinterpret_cast<const unsigned char*>(value + pos), len) + "\r\n";
+		pos += len;
+	}
+
+	return out;
+}
+
+//----------------------------------------------------------------------
+//--
+//-- Mesures
+//--
+//----------------------------------------------------------------------
+
+// Dbit en Mo/s d'une fonction applique "count" fois  "bytes" octets
+//
+template<typename FUNC> static double _throughput(size_t bytes, int count, FUNC func)
+{
+	std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+	for (int index = 0; index < count; index++) {
+		func();
+	}
+	double seconds(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	return (seconds > 0.0 ? ((double)bytes * count) / (seconds * 1024.0 * 1024.0) : 0.0);
+}
+
+static void _show(const char* name, double before, double after)
+{
+	std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(0)
+		<< std::setw(8) << before << " Mo/s -> " << std::setw(8) << after << " Mo/s" << std::endl;
+}
+
+int main()
+{
+	const size_t size(1024 * 1024);
+	const int count(20);
+
+	// Donnes alatoires (binaire) et texte ASCII
+	std::mt19937 generator(42);
+	std::string binary(size, '\0'), text(size, '\0');
+	for (size_t index = 0; index < size; index++) {
+		binary[index] = (char)(generator() & 0xFF);
+		text[index] = (char)(' ' + generator() % 95);
+	}
+
+	charUtils encoder;
+	const unsigned char* bytes((const unsigned char*)binary.c_str());
+	std::string encoded(refToBase64(bytes, size));
+
+	// Vrifications
+	if (encoder.toBase64(bytes, size) != encoded
+		|| encoder.fromBase64(encoded) != binary
+		|| encoder.text2Base64(binary) != refText2Base64(binary)
+		|| charUtils::isPureASCII(text) != refIsPureASCII(text.c_str())) {
+		std::cout << "Erreur : les rsultats diffrent de ceux de la rfrence" << std::endl;
+		return 1;
+	}
+
+	// Mesures
+	volatile size_t sink(0);
+	_show("toBase64",
+		_throughput(size, count, [&]() { sink += refToBase64(bytes, size).size(); }),
+		_throughput(size, count, [&]() { sink += encoder.toBase64(bytes, size).size(); }));
+	_show("fromBase64",
+		_throughput(encoded.size(), count, [&]() { sink += refFromBase64(encoded).size(); }),
+		_throughput(encoded.size(), count, [&]() { sink += encoder.fromBase64(encoded).size(); }));
+	_show("text2Base64",
+		_throughput(size, count, [&]() { sink += refText2Base64(binary).size(); }),
+		_throughput(size, count, [&]() { sink += encoder.text2Base64(binary).size(); }));
+	_show("isPureASCII",
+		_throughput(size, 10 * count, [&]() { sink += refIsPureASCII(text.c_str()); }),
+		_throughput(size, 10 * count, [&]() { sink += charUtils::isPureASCII(text); }));
+
+	return 0;
+}
+
+// EOF
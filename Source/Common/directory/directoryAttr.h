@@ -69,6 +69,17 @@
 #define LDIF_ATTR_SEP					": "
 #define LDIF_ATTR_ENCODED_SEP			":: "
 
+// Enregistrements de modification
+#define LDIF_CHANGETYPE					"changetype"
+#define LDIF_CHANGETYPE_ADD				"add"
+#define LDIF_CHANGETYPE_MODIFY			"modify"
+#define LDIF_CHANGETYPE_DELETE			"delete"
+
+#define LDIF_MOD_ADD					"add"
+#define LDIF_MOD_REPLACE				"replace"
+#define LDIF_MOD_DELETE					"delete"
+#define LDIF_MOD_END					"-"
+
 
 //---------------------------------------------------------------------------
 //--		
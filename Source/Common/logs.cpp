@@ -28,6 +28,7 @@
 #include <stdarg.h>
 #include <time.h>
 #include <fstream>
+#include <chrono>
 
 #include <sFileSystem.h>
 
@@ -37,8 +38,6 @@
 
 #define TRACE_EXTENSION		".log"
 
-#define MAX_LINE_LENGTH		1023
-
 // Prefixe pour les lignes
 //
 #define PREFIX_DBG			"DBG"
@@ -49,6 +48,10 @@
 
 namespace jhbTools {
 
+	// Préfixe des lignes (propre à chaque thread)
+	//
+	thread_local string logs::tag_("");
+
 	// Initialisations
 	//
 	void logs::init(TRACE_TYPE logMode, const char* sFolder, const char* sFileName)
@@ -60,11 +63,18 @@ namespace jhbTools {
 #endif // #ifdef _UNICODE_LOGS
 #endif // _WIN32
 
+		// Les lignes en attente vont dans l'ancien fichier
+		flush();
+
+		std::lock_guard<std::mutex> lock(mutex_);
 		logMode_ = logMode;
 		folder_ = IS_EMPTY(sFolder)?"":sFolder;
 		fileName_ = IS_EMPTY(sFileName)?"":sFileName;
 
 		valid_ = (sFolder || sFileName);
+
+		// Le thread d'écriture ouvrira le nouveau fichier
+		_closeFile();
 	}
 
 	// Suppression si trop gros ...
@@ -72,10 +82,14 @@ namespace jhbTools {
 	void logs::clear(size_t maxSize)
 	{
 		if (maxSize > 0) {
+			flush();
+
 			// Nom du fichier
+			std::lock_guard<std::mutex> lock(mutex_);
 			string name = _genFileName();
 
 			if (sFileSystem::file_size(name) >= maxSize) {
+				_closeFile();
 				sFileSystem::remove(name);
 			}
 		}
@@ -93,12 +107,17 @@ namespace jhbTools {
 		if (0 == fileName_.size()) {
 			// Récupération de la date et de l'heure
 			time_t now = time(0);
-			tm* ltm = localtime(&now);
+			tm ltm;
+#ifdef _WIN32
+			localtime_s(&ltm, &now);
+#else
+			localtime_r(&now, &ltm);
+#endif // _WIN32
 
 			// Nom court
 			char fileName[MAX_PATH + 1];
 			//sprintf_s(fileName, MAX_PATH, _T("%02d%s"), ltm->tm_mday, TRACE_EXTENSION);
-			snprintf(fileName, MAX_PATH, "%02d%s", ltm->tm_mday, TRACE_EXTENSION);
+			snprintf(fileName, MAX_PATH, "%02d%s", ltm.tm_mday, TRACE_EXTENSION);
 
 			return sFileSystem::merge(folder.c_str(), fileName);
 		}
@@ -107,59 +126,254 @@ namespace jhbTools {
 		return sFileSystem::merge(folder.c_str(), fileName_);
 	}
 
-	//	Ajout d'une ligne
+	// Ecriture des lignes en attente
+	//	retourne lorsque toutes les lignes ajoutées avant l'appel sont dans le fichier
 	//
-	void logs::add(TRACE_TYPE eType, const char* sFormat, ...)
+	void logs::flush()
 	{
-		// Quelque chose à afficher ?
-		if (!valid_ || eType < logMode_) {
-			// Sous le "seuil"
+		if (nullptr == lines_ || !writer_.joinable()) {
 			return;
 		}
 
-		// Date et de l'heure
-		//
-		time_t now = time(0);
-		tm* ltm = localtime(&now);
+		size_t target(enqueue_.load(std::memory_order_acquire));
+		std::unique_lock<std::mutex> lock(mutex_);
+		wake_ = true;
+		wakeUp_.notify_one();
+		flushed_.wait(lock, [this, target] { return written_.load(std::memory_order_acquire) >= target; });
+	}
 
-		char sDate[MAX_LINE_LENGTH + 1];
-		sDate[0] = EOS;
-		//sprintf_s(sDate, MAX_LINE_LENGTH, "%02d/%02d/%04d-%02d:%02d:%02d", ltm->tm_mday, ltm->tm_mon + 1, 1900 + ltm->tm_year, ltm->tm_hour, ltm->tm_min, ltm->tm_sec);
-        snprintf(sDate, MAX_LINE_LENGTH, "%02d/%02d/%04d-%02d:%02d:%02d", ltm->tm_mday, ltm->tm_mon + 1, 1900 + ltm->tm_year, ltm->tm_hour, ltm->tm_min, ltm->tm_sec);
+	//
+	// Méthodes privées
+	//
+
+	// File vide
+	//
+	void logs::_initQueue()
+	{
+		lines_ = nullptr;
+		enqueue_ = 0;
+		dequeue_ = 0;
+		written_ = 0;
+		stop_ = wake_ = false;
+
+		openDay_ = -1;
+		lastTime_ = 0;
+		lastDate_[0] = EOS;
+	}
+
+	// Ajout d'une ligne dans la file
+	//	File MPSC bornée (D. Vyukov) : chaque emplacement porte un n° de séquence
+	//	qui indique s'il est libre (seq == pos) ou prêt à être écrit (seq == pos + 1)
+	//
+	void logs::_add(TRACE_TYPE eType, const char* sFormat, va_list arg)
+	{
+		// Le thread d'écriture est lancé au 1er message
+		std::call_once(started_, &logs::_start, this);
+		if (nullptr == lines_) {
+			return;
+		}
+
+		// Réservation d'un emplacement
+		size_t pos(enqueue_.load(std::memory_order_relaxed)), seq(0);
+		LOGLINE* line(nullptr);
+		for (;;) {
+			line = &lines_[pos & (LOGS_QUEUE_SIZE - 1)];
+			seq = line->seq_.load(std::memory_order_acquire);
+			if (seq == pos) {
+				if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else {
+				if (seq < pos) {
+					// File pleine => on laisse la main au thread d'écriture
+					{
+						std::lock_guard<std::mutex> lock(mutex_);
+						wake_ = true;
+					}
+					wakeUp_.notify_one();
+					std::this_thread::yield();
+				}
+
+				pos = enqueue_.load(std::memory_order_relaxed);
+			}
+		}
 
 		// Génération de la ligne en fonction des arguments
+		line->type_ = eType;
+		line->time_ = time(0);
+		int len(tag_.size() ? snprintf(line->text_, LOGS_LINE_LENGTH, "[%s] ", tag_.c_str()) : 0);
+		if (len < 0 || len >= LOGS_LINE_LENGTH) {
+			len = 0;
+		}
+		vsnprintf(line->text_ + len, LOGS_LINE_LENGTH - len, sFormat, arg);
+		line->seq_.store(pos + 1, std::memory_order_release);
+
+		// Les erreurs (et une file à moitié pleine) sont écrites sans attendre
+		if (TRACE_TYPE::ERR == eType || 0 == ((pos + 1) & (LOGS_QUEUE_SIZE / 2 - 1))) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				wake_ = true;
+			}
+			wakeUp_.notify_one();
+		}
+	}
+
+	// Lancement du thread d'écriture
+	//
+	void logs::_start()
+	{
+		if (nullptr == (lines_ = new LOGLINE[LOGS_QUEUE_SIZE])) {
+			return;
+		}
+
+		for (size_t index = 0; index < LOGS_QUEUE_SIZE; index++) {
+			lines_[index].seq_.store(index, std::memory_order_relaxed);
+		}
+
+		writer_ = std::thread(&logs::_run, this);
+	}
+
+	// Arrêt du thread (les lignes en attente sont écrites)
+	//
+	void logs::_stop()
+	{
+		if (writer_.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+			wakeUp_.notify_one();
+			writer_.join();
+		}
+
+		if (lines_) {
+			delete[] lines_;
+			lines_ = nullptr;
+		}
+	}
+
+	// Thread d'écriture
+	//
+	void logs::_run()
+	{
+		bool stop(false);
+		std::unique_lock<std::mutex> lock(mutex_);
+		while (!stop) {
+			wakeUp_.wait_for(lock, std::chrono::milliseconds(LOGS_FLUSH_DELAY), [this] { return stop_ || wake_; });
+			stop = stop_;
+			wake_ = false;
+
+			lock.unlock();
+			_write();
+			lock.lock();
+
+			flushed_.notify_all();
+		}
+
+		_closeFile();
+	}
+
+	// Ecriture des lignes disponibles
+	//	retourne le nombre de lignes écrites
+	//
+	size_t logs::_write()
+	{
+		LOGLINE* line(nullptr);
+		size_t count(0);
+		int day(openDay_);
+		tm ltm;
+
+		// Formatage
 		//
-		char sLine[MAX_LINE_LENGTH + 1];
-		va_list	arg;
-		va_start(arg, sFormat);
-		//_vsnprintf_s(sLine, MAX_LINE_LENGTH, sFormat, arg);
-		vsnprintf(sLine, MAX_LINE_LENGTH, sFormat, arg);
-		va_end(arg);
-
-		string line(sLine);
+		buffer_.clear();
+		for (;;) {
+			line = &lines_[dequeue_ & (LOGS_QUEUE_SIZE - 1)];
+			if (line->seq_.load(std::memory_order_acquire) != dequeue_ + 1) {
+				// Vide (ou ligne en cours d'écriture)
+				break;
+			}
+
+			// Date et heure (recalculées une fois par seconde)
+			if (line->time_ != lastTime_) {
+				lastTime_ = line->time_;
+#ifdef _WIN32
+				localtime_s(&ltm, &lastTime_);
+#else
+				localtime_r(&lastTime_, &ltm);
+#endif // _WIN32
+				snprintf(lastDate_, sizeof(lastDate_), "%02d/%02d/%04d-%02d:%02d:%02d", ltm.tm_mday, ltm.tm_mon + 1, 1900 + ltm.tm_year, ltm.tm_hour, ltm.tm_min, ltm.tm_sec);
+
+				if (0 == count) {
+					day = ltm.tm_mday;
+				}
+			}
+
+			buffer_ += _linePrefix(line->type_);
+			buffer_ += " ";
+			buffer_ += lastDate_;
+			buffer_ += " ";
 #ifdef _WIN32
 #ifdef _UNICODE_LOGS
-		// Sous Windows, on convertit en ASCII/ISO_8859_15 (aie !!!)
-		encoder_.convert_fromUTF8(line);
+			// Sous Windows, on convertit en ASCII/ISO_8859_15 (aie !!!)
+			string text(line->text_);
+			encoder_.convert_fromUTF8(text);
+			buffer_ += text;
+#else
+			buffer_ += line->text_;
 #endif // #ifdef _UNICODE_LOGS
+#else
+			buffer_ += line->text_;
 #endif // _WIN32
+			buffer_ += "\n";
 
-		// Ecriture dans le fichier
-		ofstream oFile;
-		try {
-			oFile.open(_genFileName(), ios::out | ios::app);
+			// L'emplacement est libre
+			line->seq_.store(dequeue_ + LOGS_QUEUE_SIZE, std::memory_order_release);
+			dequeue_++;
+			count++;
+		}
 
-			if (oFile.is_open()) {
-				// Le fichier est ouvert en ecriture
-				oFile << _linePrefix(eType) << " " << sDate << " " << line << endl;
+		if (0 == count) {
+			return 0;
+		}
 
-				// Fin de l'opération
-				oFile.close();
+		// Ecriture dans le fichier (gardé ouvert)
+		//
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			try {
+				// Nouveau jour => le nom du fichier peut changer
+				if (file_.is_open() && day != openDay_ && 0 == fileName_.size()) {
+					_closeFile();
+				}
+
+				if (!file_.is_open()) {
+					file_.open(_genFileName(), ios::out | ios::app);
+					openDay_ = day;
+				}
+
+				if (file_.is_open()) {
+					file_.write(buffer_.c_str(), buffer_.size());
+					file_.flush();
+				}
+			}
+			catch (...) {
 			}
 		}
-		catch (...) {
-			return;
+
+		written_.store(dequeue_, std::memory_order_release);
+		return count;
+	}
+
+	// Fermeture du fichier
+	//	=> mutex_ doit être verrouillé
+	//
+	void logs::_closeFile()
+	{
+		if (file_.is_open()) {
+			file_.close();
 		}
+		file_.clear();
 	}
 
 	// Type de logs
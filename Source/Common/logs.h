@@ -27,6 +27,12 @@
 
 #include <commonTypes.h>
 #include <string>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdarg.h>
 using namespace std;
 
 #ifdef _WIN32
@@ -49,6 +55,12 @@ using namespace std;
 
 #define LOG_LEVEL_ERROR			"Erreur"		// Que les messages d'erreur (ERR)
 
+// Ecriture asynchrone
+//
+#define LOGS_QUEUE_SIZE			1024			// Lignes en attente (puissance de 2)
+#define LOGS_LINE_LENGTH		1023
+#define LOGS_FLUSH_DELAY		250				// Dlai max. (en ms) avant l'criture d'une ligne
+
 //---------------------------------------------------------------------------
 //--
 //-- Dfinition de la classe
@@ -69,14 +81,16 @@ namespace jhbTools {
 		// Construction & destruction
 		//
 		logs(TRACE_TYPE logMode = logs::TRACE_TYPE::LOG, const char* sFolder = NULL, const char* sFileName= NULL)
-		{ init(logMode, sFolder, sFileName); }
+		{ _initQueue(); init(logMode, sFolder, sFileName); }
 		logs(const logs& other) {
+			_initQueue();
 			logMode_ = other.logMode_;
 			folder_ = other.folder_;
 			fileName_ = other.fileName_;
 			valid_ = other.valid_;
 		}
-		virtual ~logs(){}
+		virtual ~logs()
+		{ _stop(); }
 
 		// Initialisation
 		void init(const char* sMode, const char* sFolder = NULL, const char* sFileName = NULL)
@@ -95,13 +109,54 @@ namespace jhbTools {
 		void clear(size_t maxSize = 0);
 		void setFileAge(int fileAge) {}
 
+		// La ligne sera-t-elle crite ?
+		bool enabled(TRACE_TYPE eType)
+		{ return (valid_ && eType >= logMode_); }
+
 		// Ajout d'une ligne
-		void add(TRACE_TYPE eType, const char* sFormat, ...);
+		//	le niveau est vrifi avant tout formatage
+		void add(TRACE_TYPE eType, const char* sFormat, ...){
+			if (!enabled(eType)) {
+				return;
+			}
+
+			va_list	arg;
+			va_start(arg, sFormat);
+			_add(eType, sFormat, arg);
+			va_end(arg);
+		}
+
+		// Ecriture des lignes en attente
+		void flush();
+
+		// Prfixe des lignes ajoutes par le thread appelant (NULL => pas de prfixe)
+		static void setTag(const char* tag)
+		{ tag_ = (IS_EMPTY(tag) ? "" : tag); }
 
 		// Mthodes prives
 		//
 	protected:
 
+		// Ligne en attente d'criture
+		typedef struct _LOGLINE
+		{
+			std::atomic<size_t>	seq_;		// Numro de squence (file MPSC)
+			TRACE_TYPE			type_;
+			time_t				time_;
+			char				text_[LOGS_LINE_LENGTH + 1];
+		} LOGLINE;
+
+		// File d'attente
+		void _initQueue();
+		void _add(TRACE_TYPE eType, const char* sFormat, va_list arg);
+
+		// Ecriture
+		void _start();
+		void _stop();
+		void _run();
+		size_t _write();
+		void _closeFile();
+
 		// Type de logs
 		TRACE_TYPE _str2Type(const char* sType);
 
@@ -120,6 +175,30 @@ namespace jhbTools {
 
 		bool        valid_;
 
+		// Ecriture asynchrone
+		LOGLINE*				lines_;			// File circulaire (alloue au 1er message)
+		std::atomic<size_t>		enqueue_;		// Prochaine position en criture (producteurs)
+		size_t					dequeue_;		// Prochaine position en lecture (thread d'criture)
+		std::atomic<size_t>		written_;		// Lignes crites dans le fichier
+
+		std::thread				writer_;
+		std::mutex				mutex_;
+		std::condition_variable	wakeUp_;		// Des lignes  crire
+		std::condition_variable	flushed_;		// Les lignes ont t crites
+		bool					stop_;
+		bool					wake_;			// Rveil demand
+
+		std::once_flag			started_;
+
+		static thread_local string	tag_;	// Prfixe des lignes du thread
+
+		// Donnes du thread d'criture
+		ofstream				file_;			// Fichier ouvert (protg par mutex_)
+		int						openDay_;
+		time_t					lastTime_;		// Horodatage en cache ( la seconde)
+		char					lastDate_[32];
+		string					buffer_;		// Lignes formates
+
 #ifdef _WIN32	
 #ifdef _UNICODE_LOGS
 		charUtils	encoder_;
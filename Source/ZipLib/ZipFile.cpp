@@ -72,10 +72,18 @@ void ZipFile::SaveAndClose(ZipArchive::Ptr zipArchive, const std::string& zipPat
   }
 
   zipArchive->WriteToStream(outZipFile);
+  bool written = !outZipFile.fail();
   outZipFile.close();
 
   zipArchive->InternalDestroy();
 
+  // keep the previous archive
+  if (!written)
+  {
+    remove(tempZipPath.c_str());
+    throw std::runtime_error("cannot save zip file");
+  }
+
   remove(zipPath.c_str());
   rename(tempZipPath.c_str(), zipPath.c_str());
 }
@@ -104,6 +112,7 @@ void ZipFile::AddEncryptedFile(const std::string& zipPath, const std::string& fi
 void ZipFile::AddEncryptedFile(const std::string& zipPath, const std::string& fileName, const std::string& inArchiveName, const std::string& password, ICompressionMethod::Ptr method)
 {
   std::string tmpName = MakeTempFilename(zipPath);
+  bool written = false;
 
   {
     ZipArchive::Ptr zipArchive = ZipFile::Open(zipPath);
@@ -144,11 +153,19 @@ void ZipFile::AddEncryptedFile(const std::string& zipPath, const std::string& fi
     }
 
     zipArchive->WriteToStream(outFile);
+    written = !outFile.fail();
     outFile.close();
   
     // force closing the input zip stream
   }
 
+  // keep the previous archive
+  if (!written)
+  {
+    remove(tmpName.c_str());
+    throw std::runtime_error("cannot write output file");
+  }
+
   remove(zipPath.c_str());
   rename(tmpName.c_str(), zipPath.c_str());
 }
@@ -0,0 +1,314 @@
+#pragma once
+#include "../compression_interface.h"
+
+#include "deflate_mt_encoder_properties.h"
+
+#include "../../extlibs/zlib/zlib.h"
+#include "../../utils/crc32_utils.h"
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+/**
+ * \brief Multithreaded deflate encoder (pigz-like).
+ *
+ * The input is split into blocks of BlockSize bytes. Each block is compressed
+ * on its own thread, primed with the last 32 KiB of the previous block,
+ * and ends with a sync flush (the last one with a final block), so that
+ * the concatenation of the compressed blocks, written in order, is a single
+ * valid raw deflate stream. The CRC32 of every block is combined as well.
+ * A block that cannot be compressed sets the badbit of the output stream:
+ * the entry would be truncated, the archive must not be kept.
+ */
+template <typename ELEM_TYPE, typename TRAITS_TYPE>
+class basic_deflate_mt_encoder
+  : public compression_encoder_interface_basic<ELEM_TYPE, TRAITS_TYPE>
+{
+  public:
+    typedef typename compression_interface_basic<ELEM_TYPE, TRAITS_TYPE>::istream_type istream_type;
+    typedef typename compression_interface_basic<ELEM_TYPE, TRAITS_TYPE>::ostream_type ostream_type;
+
+    basic_deflate_mt_encoder()
+      : _stream(nullptr)
+      , _compressionLevel(6)
+      , _blockSize(0)
+      , _threadCount(1)
+      , _bufferCapacity(0)
+      , _inputBuffer(nullptr)
+      , _bytesRead(0)
+      , _bytesWritten(0)
+      , _crc32(0)
+      , _finished(false)
+    {
+
+    }
+
+    ~basic_deflate_mt_encoder()
+    {
+      if (is_init())
+      {
+        // do not leave running jobs behind
+        for (auto& job : _jobs)
+        {
+          job.second.wait();
+        }
+
+        uninit_buffers();
+      }
+    }
+
+    void init(ostream_type& stream) override
+    {
+      deflate_mt_encoder_properties props;
+      props.normalize();
+      init(stream, props);
+    }
+
+    void init(ostream_type& stream, compression_encoder_properties_interface& props) override
+    {
+      // init stream
+      _stream = &stream;
+
+      // init values
+      _bytesRead = _bytesWritten = 0;
+      _crc32 = crc32(0L, Z_NULL, 0);
+      _finished = false;
+      _jobs.clear();
+      _dictionary.clear();
+
+      deflate_mt_encoder_properties& deflateProps = static_cast<deflate_mt_encoder_properties&>(props);
+      _compressionLevel = deflateProps.CompressionLevel;
+      _blockSize = deflateProps.BlockSize;
+      _threadCount = deflateProps.ThreadCount;
+      _bufferCapacity = deflateProps.BufferCapacity;
+
+      // init buffers
+      uninit_buffers();
+      _inputBuffer = new ELEM_TYPE[_bufferCapacity];
+
+      _block.clear();
+      _block.reserve(_blockSize + _bufferCapacity * sizeof(ELEM_TYPE));
+    }
+
+    bool is_init() const override
+    {
+      return _stream != nullptr;
+    }
+
+    size_t get_bytes_read() const override
+    {
+      return _bytesRead;
+    }
+
+    size_t get_bytes_written() const override
+    {
+      return _bytesWritten;
+    }
+
+    uint32_t get_crc32() const
+    {
+      return _crc32;
+    }
+
+    ELEM_TYPE* get_buffer_begin() override
+    {
+      return _inputBuffer;
+    }
+
+    ELEM_TYPE* get_buffer_end() override
+    {
+      return _inputBuffer + _bufferCapacity;
+    }
+
+    void encode_next(size_t length) override
+    {
+      if (_finished)
+      {
+        return;
+      }
+
+      const uint8_t* input = reinterpret_cast<const uint8_t*>(_inputBuffer);
+      _block.insert(_block.end(), input, input + length * sizeof(ELEM_TYPE));
+
+      _bytesRead += length;
+
+      bool flush = length < _bufferCapacity;
+
+      // full blocks are compressed as soon as possible
+      while (_block.size() >= _blockSize && (!flush || _block.size() > _blockSize))
+      {
+        std::vector<uint8_t> next(_block.begin() + _blockSize, _block.end());
+        _block.resize(_blockSize);
+        submit_block(false);
+        _block.swap(next);
+        _block.reserve(_blockSize + _bufferCapacity * sizeof(ELEM_TYPE));
+      }
+
+      if (flush)
+      {
+        // last block (possibly empty) carries the final deflate block
+        submit_block(true);
+        write_blocks(true);
+        _finished = true;
+      }
+      else
+      {
+        write_blocks(false);
+      }
+    }
+
+    void sync() override
+    {
+
+    }
+
+  private:
+    enum : size_t
+    {
+      DICTIONARY_SIZE = 1 << 15
+    };
+
+    struct block_job
+    {
+      std::vector<uint8_t> input;
+      std::vector<uint8_t> dictionary;
+      std::vector<uint8_t> output;
+      uint32_t             crc;
+      bool                 last;
+      bool                 succeeded;
+    };
+
+    typedef std::shared_ptr<block_job> block_job_ptr;
+
+    static void compress_block(block_job& job, int level)
+    {
+      job.crc = utils::crc32::update(0, job.input.data(), job.input.size());
+
+      z_stream zstream;
+      std::memset(&zstream, 0, sizeof(zstream));
+
+      job.succeeded = (Z_OK == deflateInit2(&zstream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY));
+      if (!job.succeeded)
+      {
+        return;
+      }
+
+      if (!job.dictionary.empty())
+      {
+        deflateSetDictionary(&zstream, job.dictionary.data(), static_cast<uInt>(job.dictionary.size()));
+      }
+
+      // room for the whole block + sync marker
+      job.output.resize(deflateBound(&zstream, static_cast<uLong>(job.input.size())) + 16);
+
+      zstream.next_in = job.input.data();
+      zstream.avail_in = static_cast<uInt>(job.input.size());
+
+      int result = Z_OK;
+      do {
+        if (zstream.total_out >= job.output.size())
+        {
+          job.output.resize(job.output.size() * 2);
+        }
+
+        zstream.next_out = job.output.data() + zstream.total_out;
+        zstream.avail_out = static_cast<uInt>(job.output.size() - zstream.total_out);
+
+        result = deflate(&zstream, job.last ? Z_FINISH : Z_SYNC_FLUSH);
+      } while (result != Z_STREAM_ERROR && zstream.avail_out == 0);
+
+      job.succeeded = job.last ? (result == Z_STREAM_END) : (result == Z_OK || result == Z_BUF_ERROR);
+      job.output.resize(zstream.total_out);
+
+      deflateEnd(&zstream);
+    }
+
+    void submit_block(bool last)
+    {
+      block_job_ptr job = std::make_shared<block_job>();
+      job->input.swap(_block);
+      job->dictionary = _dictionary;
+      job->crc = 0;
+      job->last = last;
+      job->succeeded = false;
+
+      // dictionary of the next block
+      size_t dictionarySize = (std::min)(job->input.size(), static_cast<size_t>(DICTIONARY_SIZE));
+      _dictionary.assign(job->input.end() - dictionarySize, job->input.end());
+
+      // not too many blocks in flight
+      while (_jobs.size() >= _threadCount)
+      {
+        write_front_block();
+      }
+
+      int level = _compressionLevel;
+      _jobs.emplace_back(job, std::async(std::launch::async, [job, level]() { compress_block(*job, level); }));
+    }
+
+    void write_front_block()
+    {
+      auto& front = _jobs.front();
+      front.second.wait();
+
+      block_job& job = *front.first;
+      if (!job.succeeded)
+      {
+        _stream->setstate(std::ios::badbit);
+      }
+      else if (!job.output.empty())
+      {
+        _stream->write(reinterpret_cast<const ELEM_TYPE*>(job.output.data()), job.output.size() / sizeof(ELEM_TYPE));
+        _bytesWritten += job.output.size();
+      }
+
+      _crc32 = static_cast<uint32_t>(crc32_combine(_crc32, job.crc, static_cast<z_off_t>(job.input.size())));
+
+      _jobs.pop_front();
+    }
+
+    void write_blocks(bool all)
+    {
+      // blocks are written in order, as soon as they are ready
+      while (!_jobs.empty() &&
+             (all || _jobs.front().second.wait_for(std::chrono::seconds(0)) == std::future_status::ready))
+      {
+        write_front_block();
+      }
+    }
+
+    void uninit_buffers()
+    {
+      if (_inputBuffer != nullptr)
+      {
+        delete[] _inputBuffer;
+        _inputBuffer = nullptr;
+      }
+    }
+
+    ostream_type* _stream;
+
+    int        _compressionLevel;
+    size_t     _blockSize;
+    unsigned   _threadCount;
+
+    size_t     _bufferCapacity;
+    ELEM_TYPE* _inputBuffer;      // pointer to the start of the input buffer
+
+    std::vector<uint8_t> _block;        // block being filled
+    std::vector<uint8_t> _dictionary;   // end of the previous block
+    std::deque<std::pair<block_job_ptr, std::future<void>>> _jobs;
+
+    size_t   _bytesRead;
+    size_t   _bytesWritten;
+    uint32_t _crc32;
+    bool     _finished;
+};
+
+typedef basic_deflate_mt_encoder<uint8_t, std::char_traits<uint8_t>>  byte_deflate_mt_encoder;
+typedef basic_deflate_mt_encoder<char, std::char_traits<char>>        deflate_mt_encoder;
+typedef basic_deflate_mt_encoder<wchar_t, std::char_traits<wchar_t>>  wdeflate_mt_encoder;
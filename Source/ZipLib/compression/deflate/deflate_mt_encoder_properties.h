@@ -0,0 +1,31 @@
+#pragma once
+#include "deflate_encoder_properties.h"
+
+#include <thread>
+
+struct deflate_mt_encoder_properties
+  : deflate_encoder_properties
+{
+  deflate_mt_encoder_properties()
+    : BlockSize(1 << 17)
+    , ThreadCount(0)
+  {
+
+  }
+
+  void normalize() override
+  {
+    deflate_encoder_properties::normalize();
+
+    // blocks must be large enough to hold a full deflate window
+    BlockSize = (std::max)(BlockSize, static_cast<size_t>(1 << 15));
+
+    if (ThreadCount == 0)
+    {
+      ThreadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+  }
+
+  size_t   BlockSize;     // size of the independently compressed blocks
+  unsigned ThreadCount;   // number of blocks compressed simultaneously (0 = number of cores)
+};
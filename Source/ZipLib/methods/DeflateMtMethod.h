@@ -0,0 +1,44 @@
+#pragma once
+#include "ICompressionMethod.h"
+#include "DeflateMethod.h"
+#include "../compression/deflate/deflate_mt_encoder.h"
+#include "../compression/deflate/deflate_decoder.h"
+
+#include <memory>
+
+/**
+ * \brief Deflate method whose encoder compresses blocks on several threads.
+ *
+ * The produced stream is a regular deflate stream: entries are stored with
+ * the deflate compression method and decoded by DeflateMethod.
+ */
+class DeflateMtMethod :
+  public ICompressionMethod
+{
+  public:
+    ZIP_METHOD_CLASS_PROLOGUE(
+      DeflateMtMethod,
+      deflate_mt_encoder, deflate_decoder,
+      _encoderProps, _decoderProps,
+      /* CompressionMethod */ 8,
+      /* VersionNeededToExtract */ 20
+    );
+
+    typedef DeflateMethod::CompressionLevel CompressionLevel;
+
+    size_t GetBufferCapacity() const { return _encoderProps.BufferCapacity; }
+    void SetBufferCapacity(size_t bufferCapacity) { _encoderProps.BufferCapacity = bufferCapacity; }
+
+    CompressionLevel GetCompressionLevel() const { return static_cast<CompressionLevel>(_encoderProps.CompressionLevel); }
+    void SetCompressionLevel(CompressionLevel compressionLevel) { _encoderProps.CompressionLevel = static_cast<int>(compressionLevel); }
+
+    size_t GetBlockSize() const { return _encoderProps.BlockSize; }
+    void SetBlockSize(size_t blockSize) { _encoderProps.BlockSize = blockSize; }
+
+    unsigned GetThreadCount() const { return _encoderProps.ThreadCount; }
+    void SetThreadCount(unsigned threadCount) { _encoderProps.ThreadCount = threadCount; }
+
+  private:
+    deflate_mt_encoder_properties _encoderProps;
+    deflate_decoder_properties    _decoderProps;
+};
@@ -3,7 +3,7 @@
 #include <cstdint>
 
 #include "../substream.h"
-#include "../../extlibs/zlib/zlib.h"
+#include "../../utils/crc32_utils.h"
 
 template <typename ELEM_TYPE, typename TRAITS_TYPE>
 class crc32_streambuf
@@ -22,6 +22,7 @@ class crc32_streambuf
       : _inputStream(nullptr)
       , _internalBufferPosition(_internalBuffer + INTERNAL_BUFFER_SIZE)
       , _internalBufferEnd(_internalBuffer + INTERNAL_BUFFER_SIZE)
+      , _crc32Position(_internalBuffer + INTERNAL_BUFFER_SIZE)
       , _bytesRead(0)
       , _crc32(0)
     {
@@ -40,6 +41,7 @@ class crc32_streambuf
 
       ELEM_TYPE* endOfBuffer = _internalBuffer + INTERNAL_BUFFER_SIZE;
       this->setg(endOfBuffer, endOfBuffer, endOfBuffer);
+      _crc32Position = endOfBuffer;
     }
 
     bool is_init() const
@@ -54,7 +56,8 @@ class crc32_streambuf
 
     uint32_t get_crc32() const
     {
-      return _crc32;
+      // checksum of what really has been read so far
+      return update_crc32(_crc32, _crc32Position, this->gptr());
     }
 
   protected:
@@ -63,6 +66,9 @@ class crc32_streambuf
       // buffer exhausted
       if (this->gptr() >= _internalBufferEnd)
       {
+        // the whole buffer has been read, update the checksum at once
+        _crc32 = update_crc32(_crc32, _crc32Position, _internalBufferEnd);
+
         _inputStream->read(_internalBuffer, static_cast<std::streamsize>(INTERNAL_BUFFER_SIZE));
         size_t n = static_cast<size_t>(_inputStream->gcount());
 
@@ -70,6 +76,11 @@ class crc32_streambuf
 
         _internalBufferPosition = _internalBuffer;
         _internalBufferEnd = _internalBuffer + n;
+        _crc32Position = _internalBuffer;
+
+        // the whole buffer is exposed, the checksum is computed lazily
+        // on the part that really has been read (see get_crc32())
+        this->setg(_internalBuffer, _internalBuffer, _internalBufferEnd);
 
         if (n == 0)
         {
@@ -77,19 +88,17 @@ class crc32_streambuf
         }
       }
 
-      // set buffer pointers, increment current position
-      ELEM_TYPE* base = _internalBufferPosition++;
-
-      // setting all pointers to the same position forces calling of this method each time,
-      // so crc32 really represents the checksum of what really has been read
-      this->setg(base, base, base + 1);
-
-      _crc32 = crc32(_crc32, reinterpret_cast<Bytef*>(this->gptr()), static_cast<uInt>(sizeof(ELEM_TYPE)));
-
       return traits_type::to_int_type(*this->gptr());
     }
     
   private:
+    static uint32_t update_crc32(uint32_t crc, const ELEM_TYPE* from, const ELEM_TYPE* to)
+    {
+      return (to > from)
+        ? utils::crc32::update(crc, from, static_cast<size_t>(to - from) * sizeof(ELEM_TYPE))
+        : crc;
+    }
+
     enum : size_t
     {
       INTERNAL_BUFFER_SIZE = 1 << 15
@@ -98,6 +107,7 @@ class crc32_streambuf
     ELEM_TYPE  _internalBuffer[INTERNAL_BUFFER_SIZE];
     ELEM_TYPE* _internalBufferPosition;
     ELEM_TYPE* _internalBufferEnd;
+    ELEM_TYPE* _crc32Position;    // first byte not yet in _crc32
 
     std::basic_istream<ELEM_TYPE, TRAITS_TYPE>* _inputStream;
     size_t _bytesRead;
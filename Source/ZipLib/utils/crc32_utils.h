@@ -0,0 +1,241 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# define ZIPLIB_CRC32_X86 1
+# include <intrin.h>
+# include <immintrin.h>
+# define ZIPLIB_CRC32_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# define ZIPLIB_CRC32_X86 1
+# include <cpuid.h>
+# include <immintrin.h>
+# define ZIPLIB_CRC32_TARGET __attribute__((target("sse4.1,pclmul")))
+#endif
+
+/**
+ * \brief CRC32 (ISO-HDLC, the zip/zlib one) computation.
+ *
+ * Uses PCLMULQDQ folding when the CPU supports it (checked once at runtime)
+ * and slice-by-16 tables otherwise. Results are the same as zlib's crc32().
+ */
+namespace utils { namespace crc32 {
+
+namespace detail {
+
+struct tables
+{
+  uint32_t t[16][256];
+
+  tables()
+  {
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k)
+      {
+        c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+      }
+      t[0][i] = c;
+    }
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      for (int s = 1; s < 16; ++s)
+      {
+        t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+      }
+    }
+  }
+};
+
+inline const tables& get_tables()
+{
+  static const tables crcTables;
+  return crcTables;
+}
+
+inline uint32_t load_le32(const uint8_t* p)
+{
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// crc is the internal (not inverted) value
+inline uint32_t update_slice16(uint32_t crc, const uint8_t* buf, size_t len)
+{
+  const tables& tb = get_tables();
+
+  while (len >= 16)
+  {
+    uint32_t a = load_le32(buf) ^ crc;
+    uint32_t b = load_le32(buf + 4);
+    uint32_t c = load_le32(buf + 8);
+    uint32_t d = load_le32(buf + 12);
+
+    crc = tb.t[15][a & 0xFF] ^ tb.t[14][(a >> 8) & 0xFF] ^ tb.t[13][(a >> 16) & 0xFF] ^ tb.t[12][a >> 24] ^
+          tb.t[11][b & 0xFF] ^ tb.t[10][(b >> 8) & 0xFF] ^ tb.t[9][(b >> 16) & 0xFF]  ^ tb.t[8][b >> 24] ^
+          tb.t[7][c & 0xFF]  ^ tb.t[6][(c >> 8) & 0xFF]  ^ tb.t[5][(c >> 16) & 0xFF]  ^ tb.t[4][c >> 24] ^
+          tb.t[3][d & 0xFF]  ^ tb.t[2][(d >> 8) & 0xFF]  ^ tb.t[1][(d >> 16) & 0xFF]  ^ tb.t[0][d >> 24];
+
+    buf += 16;
+    len -= 16;
+  }
+
+  while (len--)
+  {
+    crc = (crc >> 8) ^ tb.t[0][(crc ^ *buf++) & 0xFF];
+  }
+
+  return crc;
+}
+
+#ifdef ZIPLIB_CRC32_X86
+inline bool has_pclmul()
+{
+  static const bool supported = []() {
+    unsigned int regs[4] = { 0, 0, 0, 0 };
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned int>(info[i]);
+#else
+    __get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+    // ecx: bit 1 = PCLMULQDQ, bit 19 = SSE4.1
+    return ((regs[2] & (1u << 1)) != 0) && ((regs[2] & (1u << 19)) != 0);
+  }();
+
+  return supported;
+}
+
+// folding by 4 x 128 bits, len must be >= 64 and a multiple of 16
+// crc is the internal (not inverted) value
+ZIPLIB_CRC32_TARGET
+inline uint32_t update_pclmul(uint32_t crc, const uint8_t* buf, size_t len)
+{
+  alignas(16) static const uint64_t k1k2[] = { 0x0154442bd4ull, 0x01c6e41596ull };
+  alignas(16) static const uint64_t k3k4[] = { 0x01751997d0ull, 0x00ccaa009eull };
+  alignas(16) static const uint64_t k5k0[] = { 0x0163cd6124ull, 0x0000000000ull };
+  alignas(16) static const uint64_t poly[] = { 0x01db710641ull, 0x01f7011641ull };
+
+  __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+  x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+  x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+  x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+  x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+  x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+
+  buf += 64;
+  len -= 64;
+
+  // fold 512 bits at a time
+  while (len >= 64)
+  {
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+    y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+    y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+    y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+    y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+    buf += 64;
+    len -= 64;
+  }
+
+  // fold into 128 bits
+  x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  // remaining 128 bits blocks
+  while (len >= 16)
+  {
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    buf += 16;
+    len -= 16;
+  }
+
+  // fold 128 bits to 64 bits
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1 = _mm_srli_si128(x1, 8);
+  x1 = _mm_xor_si128(x1, x2);
+
+  x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, x3);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits
+  x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+
+  x2 = _mm_and_si128(x1, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+  x2 = _mm_and_si128(x2, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+#endif // ZIPLIB_CRC32_X86
+
+}
+
+/**
+ * \brief Updates a CRC32 (same convention as zlib: start with 0).
+ */
+inline uint32_t update(uint32_t crc, const void* data, size_t length)
+{
+  const uint8_t* buf = static_cast<const uint8_t*>(data);
+  uint32_t c = ~crc;
+
+#ifdef ZIPLIB_CRC32_X86
+  if (length >= 64 && detail::has_pclmul())
+  {
+    size_t chunk = length & ~static_cast<size_t>(15);
+    c = detail::update_pclmul(c, buf, chunk);
+    buf += chunk;
+    length -= chunk;
+  }
+#endif
+
+  return ~detail::update_slice16(c, buf, length);
+}
+
+} }
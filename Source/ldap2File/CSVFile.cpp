@@ -158,11 +158,7 @@ bool CSVFile::addAt(size_t colIndex, string& value)
 	}
 
 	// Est-ce un numéro de mobile ?
-	if (value.size() == 10 &&
-		(value.find("04") == 0 ||
-		(value.find("06")==0 ||
-		 value.find("07")==0 ||
-		 value.find("09") == 0))){
+	if (_isMobile(value)){
 		_formatTelephoneNumber(value);
 	}
 
@@ -291,40 +287,115 @@ bool CSVFile::saveLine(bool header, LPAGENTINFOS agent)
 
 		// Ajout de la ligne courante à la liste des lignes "ecrites"
 		if (currentLine.size() && !clearLine_) {
-#ifdef _DEBUG
-			if (0 != strstr(currentLine.c_str(), STR_VACANT_JOB)) {
-				int i(5);
-				i++;
+			_addLine(currentLine);
+		}
+
+		// Méthode héritée
+		outputFile::_saveLine(header);
+	}
+
+	// On repart a "0"
+	_emptyLine();
+	colIndex_ = 0;
+	return true;
+}
+
+// Lot de lignes
+//	les lignes sont construites directement à partir des cellules du lot (sans passer par line_)
+//	seules les valeurs mises en forme (mobiles, valeurs multiples) sont copiées
+//
+size_t CSVFile::writeRows(outputRows& rows)
+{
+	size_t saved(0);
+	deque<const string*> line;			// Valeur de chaque colonne (dans le lot)
+	deque<string> formatted;			// Valeurs mises en forme
+	outputRows::LPROWCELL cell(nullptr);
+	string currentLine("");
+
+	for (size_t index = 0; index < rows.size(); index++) {
+		outputRows::row& row(rows[index]);
+		line.assign(values_, nullptr);
+		formatted.clear();
+
+		for (size_t cIndex = 0; cIndex < row.size(); cIndex++) {
+			cell = row[cIndex];
+			if (cell->colIndex_ >= values_) {
+				continue;
 			}
-#endif // _DEBUG
 
-			bool add(true);
+			switch (cell->op_) {
+			case outputRows::CELL_OP::ADD:
+			case outputRows::CELL_OP::REPLACE:
+				if (_isMobile(cell->value_)) {
+					formatted.push_back(cell->value_);
+					_formatTelephoneNumber(formatted.back());
+					line[cell->colIndex_] = &formatted.back();
+				}
+				else {
+					line[cell->colIndex_] = &cell->value_;
+				}
+				break;
 
-			// Un poste vacant
-			if (0 != strstr(currentLine.c_str(), STR_VACANT_JOB)) {
-				add = showVacant_;
+			case outputRows::CELL_OP::ADD_VALUES:
+				formatted.push_back(_cat(cell->values_, sepValues_));
+				if (_isMobile(formatted.back())) {
+					_formatTelephoneNumber(formatted.back());
+				}
+				line[cell->colIndex_] = &formatted.back();
+				break;
+
+			case outputRows::CELL_OP::REMOVE:
+				// Pas de suppression dans un fichier plat
+				break;
 			}
+		}
 
-			if (add) {
-#ifdef _WIN32
-				// Doit-on encoder en UTF8 ?
-				if (utf8_) {
-					encoder_.convert_toUTF8(currentLine, false);
+		// Création de la ligne (cf. saveLine)
+		currentLine.clear();
+		for (size_t col = 0; col < values_; col++) {
+			if (line_[col].visible_) {
+				if (line[col]) {
+					currentLine += *line[col];
 				}
-#endif // _WIN32
 
-				lines_.push_back(currentLine);
+				currentLine += sepCols_;
 			}
 		}
 
-		// Méthode héritée
-		outputFile::_saveLine(header);
+		// Retrait du dernier sep.
+		if (currentLine.size()) {
+			currentLine.resize(currentLine.size() - 1);
+		}
+
+		if (currentLine.size() && !clearLine_) {
+			_addLine(currentLine);
+		}
+
+		outputFile::_saveLine(false);
+		saved++;
 	}
 
-	// On repart a "0"
-	_emptyLine();
 	colIndex_ = 0;
-	return true;
+	return saved;
+}
+
+// Ajout d'une ligne à la liste des lignes "écrites"
+//
+void CSVFile::_addLine(string& currentLine)
+{
+	// Un poste vacant
+	if (0 != strstr(currentLine.c_str(), STR_VACANT_JOB) && !showVacant_) {
+		return;
+	}
+
+#ifdef _WIN32
+	// Doit-on encoder en UTF8 ?
+	if (utf8_) {
+		encoder_.convert_toUTF8(currentLine, false);
+	}
+#endif // _WIN32
+
+	lines_.push_back(currentLine);
 }
 
 // EOF
@@ -75,6 +75,9 @@ public:
 	// Enregistrement de la "ligne" / nouvelle ligne
 	virtual bool saveLine(bool header = false, LPAGENTINFOS agent = NULL);
 
+	// Lot de lignes
+	virtual size_t writeRows(outputRows& rows);
+
 	//
 	// Gestion de l'organigramme
 	//
@@ -101,11 +104,19 @@ public:
 	//
 private:
 
+	// Numéro de mobile (à mettre en forme) ?
+	bool _isMobile(const string& value) {
+		return (value.size() == 10 &&
+			(value.find("04") == 0 || value.find("06") == 0 || value.find("07") == 0 || value.find("09") == 0));
+	}
 	void _formatTelephoneNumber(string& value);
 
 	void _addHeader();
 	void _emptyLine();
 
+	// Ajout d'une ligne (mise en forme) à la liste des lignes
+	void _addLine(string& currentLine);
+
 protected:
 
 	// Une valeur
@@ -51,6 +51,18 @@
 #define JS_VAR_LEVEL                _T("structLevel")
 #define JS_VAR_STATUS               _T("status")
 
+// Mode compact
+#define JS_VAR_COMPACT_ROWS			_T("l2fRows")		// Agents (tableaux d'indices)
+#define JS_VAR_COMPACT_KEYS			_T("l2fKeys")		// Noms des attributs
+#define JS_VAR_COMPACT_DICT			_T("l2fValues")		// Dictionnaire des valeurs
+#define JS_COMPACT_EXPAND			_T("function(k,d,p,r){var a=[],i,j,o,x,m,v;for(i=0;i<r.length;i++){x=r[i];o={};for(j=0;j<x.length;j+=2){m=x[j]&3;v=x[j+1];o[k[x[j]>>2]]=(0==m?v:(1==m?d[v]:p+d[v]));}a.push(o);}return a;}")
+
+#define JS_COMPACT_LITERAL			0		// Valeur non "quote" inscrite telle quelle
+#define JS_COMPACT_VALUE			1		// Indice dans le dictionnaire
+#define JS_COMPACT_PHOTO			2		// URL de la photo (prfixe + indice dans le dictionnaire)
+
+#define JS_GZIP_EXT					_T(".gz")
+
 //#define JS_DEFAULT_LINK				_T(", color: primitives.common.Colors.Blue, connectorShapeType: primitives.common.ConnectorShapeType.BothWay, lineType: primitives.common.LineType.Solid")
 
 //
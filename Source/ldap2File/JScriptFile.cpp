@@ -27,6 +27,12 @@
 #include "JScriptFile.h"
 #include <iomanip>
 
+#ifdef _WIN32
+#include "../ZipLib/extlibs/zlib/zlib.h"
+#else
+#include <zlib.h>
+#endif // _WIN32
+
 //----------------------------------------------------------------------
 //--
 //-- Implémentation des classes
@@ -57,6 +63,10 @@ JScriptFile::JScriptFile(const LPOPFI fileInfos, columnList* columns, confFile*
 	// Attributs vides
 	commandFile* cmdFile = configurationFile_->cmdFile();
 	addEmptyAttributes_ = (cmdFile?cmdFile->showEmptyAttributes():false);
+
+	// Génération compacte ?
+	compact_ = (cmdFile?cmdFile->compactOutput():false);
+	gzFile_ = "";
 }
 
 // Destruction
@@ -94,6 +104,11 @@ JScriptFile::~JScriptFile()
 			delete (*it);
 		}
 	}
+
+	// La copie compressée est supprimée avec le fichier
+	if (gzFile_.size()){
+		sFileSystem::remove(gzFile_);
+	}
 }
 
 // Initialisation(s)
@@ -132,6 +147,12 @@ bool JScriptFile::_init()
 		logs_->add(logs::TRACE_TYPE::NORMAL, "\t-  Photo par défaut : \'%s\'", photoServer_.nophoto_.c_str());
 	}
 
+	// Les URL des photos ne seront pas répétées en mode compact
+	photoPrefix_ = photoServer_.baseFolder_;
+	if (photoPrefix_.size()){
+		photoPrefix_ += POSIX_FILENAME_SEP;
+	}
+
 	// Création d'une ligne vierge
 	_newLine();
 	newFile_ = true;
@@ -144,7 +165,7 @@ bool JScriptFile::_init()
 //
 void JScriptFile::_newLine()
 {
-	line_ = new JSData();
+	line_ = new JSData(&table_);
 	//keepLine_ = true;
 
 	// Valeur par défaut des attributs
@@ -291,22 +312,8 @@ bool JScriptFile::removeAt(size_t colIndex)
 	string colName = columns_->at(colIndex, false)->name_;
 	//columnList::LPCOLINFOS test = columns_->at(colIndex, false);
 
-	// Recherche de l'attribut
-	if (line_){
-		deque<JSATTRIBUTE*>::iterator it = line_->otherAttributes_.begin();
-		while (it != line_->otherAttributes_.end()){
-			if ((*it) && (*it)->name_ == colName){
-				(*it)->value_ = "";
-
-				// Supprimé
-				return true;
-			}
-			it++;
-		}
-	}
-
-	// Rien fait ...
-	return false;
+	// L'attribut est vidé (s'il existe)
+	return (line_ ? table_.set(line_->row(), colName.c_str(), "", true, false) : false);
 }
 
 // Remplacement d'une valeur
@@ -316,22 +323,8 @@ bool JScriptFile::replaceAt(size_t colIndex, string& singleValue)
 	// Nom de la colonne associée ...
 	string colName = columns_->at(colIndex, false)->name_;
 
-	// Recherche de l'attribut
-	if (line_){
-		deque<JSATTRIBUTE*>::iterator it = line_->otherAttributes_.begin();
-		while (it != line_->otherAttributes_.end()){
-			if ((*it) && (*it)->name_ == colName){
-				(*it)->value_ = singleValue;
-
-				// Remplacé
-				return true;
-			}
-			it++;
-		}
-	}
-
-	// Rien fait ...
-	return false;
+	// Remplacement de la valeur (si l'attribut existe)
+	return (line_ ? table_.set(line_->row(), colName.c_str(), singleValue.c_str(), true, false) : false);
 }
 
 // Initialisation de l'organigramme
@@ -354,17 +347,23 @@ orgChartFile* JScriptFile::addOrgChartFile(bool flatMode, bool fullMode, bool& n
 	// Ajout de l'entête du fichier
 	//
 	time_t now = time(0);
-	tm *ltm = localtime(&now);
+	tm ltm;
+#ifdef _WIN32
+	localtime_s(&ltm, &now);
+#else
+	localtime_r(&now, &ltm);
+#endif // _WIN32
 	file_ << "/*\t\t" << fileName(false) << "\t*/" << eol_;
-	file_ << "/*\t\tGénéré le " << std::setfill('0') << std::setw(2) << ltm->tm_mday << "/" << std::setfill('0') << std::setw(2) << ltm->tm_mon + 1 << "/" << std::setfill('0') << std::setw(4) << ltm->tm_year + 1900 << "\t*/" << eol_;
-	file_ << "/*\t\t à " << std::setfill('0') << std::setw(2) << ltm->tm_hour << " h ";
-	file_ << std::setfill('0') << std::setw(2) << ltm->tm_min << " min ";
-	file_ << std::setfill('0') << std::setw(2) << ltm->tm_sec << " sec. \t*/" << eol_;
+	file_ << "/*\t\tGénéré le " << std::setfill('0') << std::setw(2) << ltm.tm_mday << "/" << std::setfill('0') << std::setw(2) << ltm.tm_mon + 1 << "/" << std::setfill('0') << std::setw(4) << ltm.tm_year + 1900 << "\t*/" << eol_;
+	file_ << "/*\t\t à " << std::setfill('0') << std::setw(2) << ltm.tm_hour << " h ";
+	file_ << std::setfill('0') << std::setw(2) << ltm.tm_min << " min ";
+	file_ << std::setfill('0') << std::setw(2) << ltm.tm_sec << " sec. \t*/" << eol_;
 	file_ << "/*\t\t" << APP_COPYRIGHT << "\t*/" << eol_;
 
 	// Liste des agents
+	//	en mode compact, les agents sont des tableaux d'indices "décompressés" à la fin du fichier
 	//
-	file_ << "var "<< (const char*)JS_VAR_AGENTS << " = [";
+	file_ << "var "<< (const char*)(compact_ ? JS_VAR_COMPACT_ROWS : JS_VAR_AGENTS) << " = [";
 	file_.flush();
 
 	newFile_ = true;
@@ -381,6 +380,21 @@ void JScriptFile::closeOrgChartFile()
 	if (file_.is_open()){
 		// Fin de la liste des agents
 		file_ << eol_ << "];" << eol_;
+
+		if (compact_){
+			// Dictionnaires
+			_writeCompactDictionary(JS_VAR_COMPACT_KEYS, keys_);
+			_writeCompactDictionary(JS_VAR_COMPACT_DICT, dict_);
+
+			// Reconstruction de la liste des agents
+			string prefix(photoPrefix_);
+#ifdef _WIN32
+			encoder_.convert_toUTF8(prefix, false);
+#endif // _WIN32
+			_quote(prefix);
+			file_ << "var " << (const char*)JS_VAR_AGENTS << " = (" << JS_COMPACT_EXPAND << ")(";
+			file_ << JS_VAR_COMPACT_KEYS << ", " << JS_VAR_COMPACT_DICT << ", " << prefix << ", " << JS_VAR_COMPACT_ROWS << ");" << eol_;
+		}
 		file_.flush();
 
 		bool first(true);
@@ -462,7 +476,12 @@ void JScriptFile::closeOrgChartFile()
 		file_ << eol_ << "];" << eol_;
 
 		// Fermeture du fichier
-		file_.close();
+		_close();
+
+		// Copie compressée, pour les serveurs Web (inutile si le fichier est déja compressé)
+		if (compact_ && COMPRESSION_TYPE::NONE == file_.compression()){
+			_gzipFile();
+		}
 	}
 }
 
@@ -532,20 +551,19 @@ void JScriptFile::add2Chart(LPAGENTINFOS agent)
 	size_t count(0);
 	JSData* otherDatas((JSData*)agent->ownData());
 	if (otherDatas){
-		otherDatas->newAttribute(JS_LABEL_PHOTO, photoServer_.URL(photoServer_.shortFileName(otherDatas->photo_).c_str()).c_str());
+		photoServer_.fullURL(photoLink_, otherDatas->photo_.c_str());
+		otherDatas->newAttribute(JS_LABEL_PHOTO, photoLink_.c_str());
 
 		otherDatas->newAttribute(JS_LABEL_CONTAINER_COLOR, otherDatas->containerColor_.c_str());
 		otherDatas->newAttribute(JS_LABEL_BK_COLOR, otherDatas->bkColor_.c_str());
 
-		// Tous les attributs dans l'ordre demandé ...
-		JSATTRIBUTE* pAttribute(nullptr);
-		for (deque<JSATTRIBUTE*>::iterator it = otherDatas->otherAttributes_.begin(); it != otherDatas->otherAttributes_.end(); it++){
-			if (nullptr != (pAttribute = (*it))){
-#ifdef _DEBUG
-                string name(pAttribute->name_);
-                //bool quoted(pAttribute->quoted_);
-#endif // _DEBUG
-				_add(line, pAttribute->name_.c_str(), pAttribute->value_.c_str(), pAttribute->quoted_);
+		// Tous les attributs de la ligne, colonne par colonne
+		size_t row(otherDatas->row());
+		const string* value(nullptr);
+		bool quoted(true);
+		for (size_t col = 0; col < table_.size(); col++){
+			if (nullptr != (value = table_.value(col, row, quoted))){
+				_add(line, table_.name(col).c_str(), value->c_str(), quoted);
 				count++;
 			}
 		}
@@ -571,7 +589,7 @@ void JScriptFile::add2Chart(LPAGENTINFOS agent)
 	}
 
 	file_ << eol_;			// Saut de ligne précédent
-	file_ << "{";
+	file_ << (compact_ ? '[' : '{');
 
 
 	// Ajout dans le fichier
@@ -582,7 +600,7 @@ void JScriptFile::add2Chart(LPAGENTINFOS agent)
 
 	// Fin de la ligne
 	//
-	file_ << '}';
+	file_ << (compact_ ? ']' : '}');
 
 	// L'agent est-il le "père" dans un groupe ?
 #ifdef _GENERATE_COLORED_GROUPS_
@@ -601,6 +619,11 @@ void JScriptFile::add2Chart(LPAGENTINFOS agent)
 //
 void JScriptFile::_add(string& line, const char* label, string& value, bool quote)
 {
+	if (compact_){
+		_addCompact(line, label, value, quote);
+		return;
+	}
+
 	if (line.size()){
 		// séparateur de valeurs
 		line += ", ";
@@ -621,6 +644,175 @@ void JScriptFile::_add(string& line, const char* label, int value)
 	return _add(line, label, bidon, false);
 }
 
+// Mode compact
+//	chaque attribut est représenté par deux entiers :
+//		- (indice du nom << 2) | type de la valeur
+//		- la valeur ou son indice dans le dictionnaire
+//
+void JScriptFile::_addCompact(string& line, const char* label, string& value, bool quote)
+{
+	size_t type(JS_COMPACT_LITERAL);
+	size_t valIndex(0);
+
+	if (quote){
+		// L'URL de la photo commence t'elle par le dossier du serveur ?
+		if (photoPrefix_.size() && 0 == strcmp(label, JS_LABEL_PHOTO)
+			&& 0 == value.compare(0, photoPrefix_.size(), photoPrefix_)){
+			type = JS_COMPACT_PHOTO;
+			valIndex = _compactIndex(dict_, dictIndex_, value.c_str() + photoPrefix_.size());
+		}
+		else{
+			type = JS_COMPACT_VALUE;
+			valIndex = _compactIndex(dict_, dictIndex_, value.c_str());
+		}
+	}
+
+	if (line.size()){
+		line += ',';
+	}
+
+	line += charUtils::itoa((int)((_compactIndex(keys_, keyIndex_, label) << 2) | type));
+	line += ',';
+
+	if (JS_COMPACT_LITERAL == type){
+	    // Les valeurs numériques vides sont égales à 0
+		line += (value.size() ? value : "0");
+	}
+	else{
+		line += charUtils::itoa((int)valIndex);
+	}
+}
+
+// Indice d'une valeur dans un dictionnaire (ajout si nécessaire)
+//
+size_t JScriptFile::_compactIndex(deque<string>& values, map<string, size_t>& index, const char* value)
+{
+	string sValue(IS_EMPTY(value) ? "" : value);
+	map<string, size_t>::iterator it = index.find(sValue);
+	if (it != index.end()){
+		return it->second;
+	}
+
+	size_t pos(values.size());
+	values.push_back(sValue);
+	index[sValue] = pos;
+	return pos;
+}
+
+// Ecriture d'un dictionnaire
+//
+void JScriptFile::_writeCompactDictionary(const char* varName, deque<string>& values)
+{
+	file_ << "var " << varName << " = [";
+
+	string value("");
+	for (deque<string>::iterator it = values.begin(); it != values.end(); it++){
+		value = (*it);
+#ifdef _WIN32
+		encoder_.convert_toUTF8(value, false);
+#endif // _WIN32
+		_quote(value);
+		if (it != values.begin()){
+			file_ << ',';
+		}
+		file_ << value;
+	}
+
+	file_ << "];" << eol_;
+}
+
+// Chaîne JS entre guillemets
+//	les guillemets, les \ et les fins de ligne sont échappés
+//
+void JScriptFile::_quote(string& value)
+{
+	string quoted("\"");
+	quoted.reserve(value.size() + 2);
+	for (string::iterator it = value.begin(); it != value.end(); it++){
+		switch (*it){
+		case '\"':
+		case '\\':
+			quoted += '\\';
+			quoted += (*it);
+			break;
+
+		case '\n':
+			quoted += "\\n";
+			break;
+
+		case '\r':
+			quoted += "\\r";
+			break;
+
+		default:
+			quoted += (*it);
+			break;
+		}
+	}
+
+	quoted += '\"';
+	value = quoted;
+}
+
+// Copie compressée (gzip) du fichier généré
+//
+bool JScriptFile::_gzipFile()
+{
+	std::ifstream src(fileName_.c_str(), std::ifstream::in | std::ifstream::binary);
+	if (!src.is_open()){
+		return false;
+	}
+
+	string destName(fileName_);
+	destName += JS_GZIP_EXT;
+	std::ofstream dest(destName.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (!dest.is_open()){
+		if (logs_){
+			logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer le fichier '%s'", destName.c_str());
+		}
+		return false;
+	}
+
+	// Compression au format gzip (16 + MAX_WBITS)
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	if (Z_OK != deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY)){
+		return false;
+	}
+
+	char inBuffer[16384], outBuffer[16384];
+	int flush(Z_NO_FLUSH), ret(Z_OK);
+	do{
+		src.read(inBuffer, sizeof(inBuffer));
+		stream.next_in = (Bytef*)inBuffer;
+		stream.avail_in = (uInt)src.gcount();
+		flush = (src.eof() ? Z_FINISH : Z_NO_FLUSH);
+
+		do{
+			stream.next_out = (Bytef*)outBuffer;
+			stream.avail_out = sizeof(outBuffer);
+			ret = deflate(&stream, flush);
+			dest.write(outBuffer, sizeof(outBuffer) - stream.avail_out);
+		} while (0 == stream.avail_out);
+	} while (Z_FINISH != flush);
+
+	deflateEnd(&stream);
+
+	if (logs_){
+		logs_->add(logs::TRACE_TYPE::NORMAL, "Fichier compressé '%s' : %d -> %d octets", destName.c_str(), (int)stream.total_in, (int)stream.total_out);
+	}
+
+	dest.close();
+	if (Z_STREAM_END != ret || dest.fail()){
+		sFileSystem::remove(destName);
+		return false;
+	}
+
+	// La copie sera transmise avec le fichier
+	gzFile_ = destName;
+	return true;
+}
+
 //
 // JScriptFile::JSDATA
 //
@@ -629,15 +821,10 @@ void JScriptFile::_add(string& line, const char* label, int value)
 // utilisée pour la création des postes vacants
 //
 JScriptFile::JSData* JScriptFile::JSData::lightCopy() {
-	JSData* copyData(new JScriptFile::JSData);
+	JSData* copyData(new JScriptFile::JSData(table_));
 	if (nullptr != copyData) {
 		// Les attributs complémentaires
-		JSATTRIBUTE* pAttribute(nullptr);
-		for (deque<JSATTRIBUTE*>::iterator it = otherAttributes_.begin(); it != otherAttributes_.end(); it++) {
-			if (nullptr != (pAttribute = (*it))) {
-				copyData->newAttribute((*it)->name_, (*it)->value_, (*it)->quoted_);
-			}
-		}
+		table_->copyRow(row_, copyData->row_);
 	}
 
 	// On retourne la copie (ou un pointeur vide)
@@ -654,70 +841,149 @@ void JScriptFile::JSData::_replace(const char* name, bool create, const char* va
 	    return;
 	}
 
-	// Recherche dans la liste
-	//
-	JSATTRIBUTE* pAttribute(nullptr);
-	for (deque<JSATTRIBUTE*>::iterator it = otherAttributes_.begin(); it != otherAttributes_.end(); it++) {
-		if (nullptr != (pAttribute = (*it)) && pAttribute->name_ == name) {
-			// Je l'ai ...
-			//if (!IS_EMPTY(value)) {
-            // Remplacement
-            pAttribute->value_ = value;
-			//}
-
-			// Terminé
-			return;
+	// Remplacement (ou création)
+	table_->set(row_, name, value, quote, create);
+}
+
+//
+// JScriptFile::JSTable
+//
+
+// Construction
+//
+JScriptFile::JSTable::JSTable()
+{
+	rows_ = 0;
+
+	// La valeur vide est toujours la première du dictionnaire
+	_intern("");
+}
+
+// Destruction
+//
+JScriptFile::JSTable::~JSTable()
+{
+	for (vector<JSCOLUMN*>::iterator it = columns_.begin(); it != columns_.end(); it++){
+		if (*it){
+			delete (*it);
 		}
 	}
 
-	// Non trouvé ?
-	// faut'il le créer ?
-	if (create) {
-		newAttribute((const char*)name, value, quote);
-	}
+	columns_.clear();
 }
 
-// Suppression d'un attribut
+// Copie d'une ligne
 //
-void JScriptFile::JSData::remove(const char* name)
+void JScriptFile::JSTable::copyRow(size_t from, size_t to)
 {
-	// Recherche dans la liste
-	//
-	JSATTRIBUTE* pAttribute(nullptr);
-	for (deque<JSATTRIBUTE*>::iterator it = otherAttributes_.begin(); it != otherAttributes_.end(); it++) {
-		if (nullptr != (pAttribute = (*it)) && pAttribute->name_ == name) {
-			// Suppression
-			otherAttributes_.erase(it);
-
-			// Terminé
-			return;
+	JSCOLUMN* column(nullptr);
+	for (vector<JSCOLUMN*>::iterator it = columns_.begin(); it != columns_.end(); it++){
+		if (nullptr != (column = (*it)) && from < column->values_.size() && JS_NO_VALUE != column->values_[from]){
+			if (to >= column->values_.size()){
+				column->values_.resize(to + 1, JS_NO_VALUE);
+				column->quoted_.resize(to + 1, true);
+			}
+
+			column->values_[to] = column->values_[from];
+			column->quoted_[to] = column->quoted_[from];
 		}
 	}
 }
 
-// Ajout d'un attribut et de sa valeur
+// Valeur d'un attribut
 //
-void JScriptFile::JSData::newAttribute(string& attrName, string& attrValue, bool quoted){
+bool JScriptFile::JSTable::set(size_t row, const char* name, const char* value, bool quoted, bool create)
+{
+	JSCOLUMN* column(_column(name, create));
+	if (nullptr == column){
+		return false;
+	}
 
-	if (attrName.size()){
-		// Ai je déja cet attribut en mémoire ?
-		JSATTRIBUTE* pAttribute(nullptr);
-		for (deque<JSATTRIBUTE*>::iterator it = otherAttributes_.begin(); nullptr == pAttribute && it != otherAttributes_.end(); it++){
-			if (nullptr != (*it) && (*it)->name_ == attrName){
-				pAttribute = (*it);
-			}
+	// L'attribut existe t'il déja ?
+	bool exists(row < column->values_.size() && JS_NO_VALUE != column->values_[row]);
+	if (!exists){
+		if (!create){
+			return false;
 		}
 
-		// oui ?
-		if (pAttribute){
-			// La dernière valeur est la bonne !
-			pAttribute->value_ = attrValue;
-		}
-		else{
-			// Non => ajout
-			otherAttributes_.push_back(new JSATTRIBUTE(attrName, attrValue, quoted));
+		if (row >= column->values_.size()){
+			column->values_.resize(row + 1, JS_NO_VALUE);
+			column->quoted_.resize(row + 1, true);
 		}
+
+		column->quoted_[row] = quoted;
 	}
+
+	// La dernière valeur est la bonne !
+	column->values_[row] = _intern(value);
+	return true;
+}
+
+// Suppression d'un attribut
+//
+bool JScriptFile::JSTable::remove(size_t row, const char* name)
+{
+	JSCOLUMN* column(_column(name, false));
+	if (nullptr == column || row >= column->values_.size() || JS_NO_VALUE == column->values_[row]){
+		return false;
+	}
+
+	column->values_[row] = JS_NO_VALUE;
+	return true;
+}
+
+// Valeur d'un attribut pour une ligne
+//
+const string* JScriptFile::JSTable::value(size_t col, size_t row, bool& quoted)
+{
+	JSCOLUMN* column(col < columns_.size() ? columns_[col] : nullptr);
+	if (nullptr == column || row >= column->values_.size() || JS_NO_VALUE == column->values_[row]){
+		return nullptr;
+	}
+
+	quoted = column->quoted_[row];
+	return &values_[column->values_[row]];
+}
+
+// Recherche (et création) d'une colonne
+//
+JScriptFile::JSTable::JSCOLUMN* JScriptFile::JSTable::_column(const char* name, bool create)
+{
+	if (IS_EMPTY(name)){
+		return nullptr;
+	}
+
+	string colName(name);
+	map<string, size_t>::iterator it = colIndex_.find(colName);
+	if (it != colIndex_.end()){
+		return columns_[it->second];
+	}
+
+	// Nouvelle colonne
+	JSCOLUMN* column(create ? new JSCOLUMN(name) : nullptr);
+	if (column){
+		colIndex_[colName] = columns_.size();
+		columns_.push_back(column);
+	}
+
+	return column;
+}
+
+// Indice d'une valeur dans le dictionnaire
+//
+size_t JScriptFile::JSTable::_intern(const char* value)
+{
+	string sValue(IS_EMPTY(value) ? "" : value);
+	map<string, size_t>::iterator it = valIndex_.find(sValue);
+	if (it != valIndex_.end()){
+		return it->second;
+	}
+
+	// Nouvelle valeur
+	size_t index(values_.size());
+	values_.push_back(sValue);
+	valIndex_[sValue] = index;
+	return index;
 }
 
 // EOF
@@ -45,6 +45,9 @@
 // Fond coloré pour les DGA ?
 //#define _GENERATE_COLORED_GROUPS_
 
+// Pas de valeur pour l'attribut
+#define JS_NO_VALUE		((size_t)-1)
+
 //----------------------------------------------------------------------
 //--
 //-- Définition de la classe
@@ -103,6 +106,10 @@ public:
 	virtual bool close()
 	{ return true; }
 
+	// Copie compressée à transmettre avec le fichier
+	virtual const char* sidecarExtension()
+	{ return (gzFile_.size() ? JS_GZIP_EXT : nullptr); }
+
 	//
 	// Organigramme
 	//
@@ -131,19 +138,62 @@ private:
 	// Initialisation(s)
 	virtual bool _init();
 
-	// Un attrribut LDAP
-	typedef struct tagJSATTRIBUTE{
-		// Construction
-		tagJSATTRIBUTE(string& attrName, string& attrValue, bool quoted = true){
-			name_ = attrName;
-			value_ = attrValue;
-			quoted_ = quoted;
-		}
+	// Table des attributs des agents
+	//	Une colonne par libellé JS, chaque colonne contenant pour chaque ligne (ie. agent)
+	//	l'indice de la valeur dans le dictionnaire des valeurs
+	//
+	class JSTable
+	{
+	public:
+		// Construction & destruction
+		JSTable();
+		virtual ~JSTable();
+
+		// Une nouvelle ligne
+		size_t newRow()
+		{ return rows_++; }
+
+		// Copie d'une ligne
+		void copyRow(size_t from, size_t to);
+
+		// Valeur d'un attribut
+		//	si l'attribut existe, seule sa valeur est remplacée
+		//	sinon il est créé si create == true
+		bool set(size_t row, const char* name, const char* value, bool quoted, bool create = true);
+
+		// Suppression d'un attribut
+		bool remove(size_t row, const char* name);
+
+		// Accès aux colonnes
+		size_t size()
+		{ return columns_.size(); }
+		const string& name(size_t col)
+		{ return columns_[col]->name_; }
+		const string* value(size_t col, size_t row, bool& quoted);
+
+	protected:
 
-		string name_;
-		string value_;
-		bool quoted_;
-	}JSATTRIBUTE;
+		// Une colonne
+		typedef struct tagJSCOLUMN{
+			tagJSCOLUMN(const char* name)
+			{ name_ = name; }
+
+			string				name_;
+			vector<size_t>		values_;	// Indice de la valeur pour chaque ligne
+			vector<bool>		quoted_;	// La valeur doit-elle être entre guillemets ?
+		}JSCOLUMN;
+
+		// Méthodes privées
+		JSCOLUMN* _column(const char* name, bool create);
+		size_t _intern(const char* value);
+
+		// Données membres
+		size_t						rows_;		// Nombre de lignes
+		vector<JSCOLUMN*>			columns_;	// Colonnes dans l'ordre de création
+		map<string, size_t>			colIndex_;	// Nom de la colonne => indice
+		deque<string>				values_;	// Dictionnaire des valeurs
+		map<string, size_t>			valIndex_;	// Valeur => indice dans le dictionnaire
+	};
 
 	// Un élément de l'organigramme
 	//
@@ -151,26 +201,19 @@ private:
 	{
 	public:
 		// Construction
-		JSData(){
+		JSData(JSTable* table){
 			uId_ = parentId_ = NO_AGENT_UID;
 			groupOpacity_ = JF_DEF_GROUP_OPACITY;
 			photo_ = JS_DEF_PHOTO;
 			bkColor_ = JS_DEF_BK_COLOR;
 			containerColor_ = JS_DEF_CONTAINER_BK_COLOR;
+			table_ = table;
+			row_ = table_->newRow();
 		}
 
 		// Destruction
 		virtual ~JSData()
-		{
-			JSATTRIBUTE* pAttribute(nullptr);
-			for (deque<JSATTRIBUTE*>::iterator it = otherAttributes_.begin(); it != otherAttributes_.end(); it++){
-				if (nullptr != (pAttribute = (*it))){
-					delete pAttribute;
-				}
-			}
-
-			otherAttributes_.clear();
-		}
+		{}
 
 		// Copie "non conforme"
 		// utilisée pour la création des postes vacants
@@ -189,22 +232,24 @@ private:
 		{ _replace(name, false, "", false); }
 
 		// Suppression d'un attribut
-		virtual void remove(const char* name);
+		virtual void remove(const char* name)
+		{ table_->remove(row_, name); }
 
 		// Ajout d'un attribut et de sa valeur
-		void newAttribute(string& attrName, string& attrValue, bool quoted = true);
-		void newAttribute(string& attrName, const char* attrValue, bool quoted = true){
-			string val = (IS_EMPTY(attrValue) ? "" : attrValue);
-			newAttribute(attrName, val, quoted);
-		}
+		void newAttribute(string& attrName, string& attrValue, bool quoted = true)
+		{ newAttribute(attrName.c_str(), attrValue.c_str(), quoted); }
+		void newAttribute(string& attrName, const char* attrValue, bool quoted = true)
+		{ newAttribute(attrName.c_str(), attrValue, quoted); }
 		void newAttribute(const char* attrName, const char* attrValue, bool quoted = true){
 			if (!IS_EMPTY(attrName)){
-				string name(attrName);
-				string val = (IS_EMPTY(attrValue) ? "" : attrValue);
-				newAttribute(name, val, quoted);
+				table_->set(row_, attrName, attrValue, quoted);
 			}
 		}
 
+		// Indice de la ligne dans la table
+		size_t row()
+		{ return row_; }
+
 		// Données à insérer dans le fichier JS
 		unsigned int	uId_;
 		unsigned int	parentId_;
@@ -213,10 +258,11 @@ private:
 		string			containerColor_;
 		string			photo_;
 
+	protected:
 		// Autres éléments ...
-		deque<JSATTRIBUTE*>	otherAttributes_;
+		JSTable*		table_;
+		size_t			row_;
 
-	protected:
 		// Méthodes privées
 		void _replace(const char* name, bool create, const char* value, bool quote);
 	};
@@ -268,11 +314,23 @@ private:
 	// Nouvelle ligne vierge
 	void _newLine();
 
+	// Mode compact
+	void _addCompact(string& line, const char* label, string& value, bool quote);
+	size_t _compactIndex(deque<string>& values, map<string, size_t>& index, const char* value);
+	void _writeCompactDictionary(const char* varName, deque<string>& values);
+
+	// Copie compressée (gzip) du fichier généré
+	bool _gzipFile();
+
+	// Chaîne JS entre guillemets
+	void _quote(string& value);
+
 
 	// Données membres privées
 	//
 private:
 	charUtils		encoder_;		// Gestion de l'encodage des caractères
+	JSTable			table_;			// Valeurs de tous les agents
 	JSData*			line_;			// Données correspondant à une "ligne"
 
 	bool			newFile_;
@@ -280,6 +338,16 @@ private:
 	bool			fullMode_;
 
 	IMGSERVER		photoServer_;	// Serveur gérant les photos
+	string			photoLink_;		// Tampon pour le lien vers la photo
+
+	// Mode compact
+	bool				compact_;
+	string				photoPrefix_;	// Début commun des URL des photos
+	deque<string>		keys_;			// Noms des attributs
+	map<string, size_t>	keyIndex_;
+	deque<string>		dict_;			// Valeurs "quotées"
+	map<string, size_t>	dictIndex_;
+	string				gzFile_;		// Copie compressée (si générée)
 
 #ifdef _GENERATE_COLORED_GROUPS_
 	deque<LPEGRP>				groups_;		// Regroupements d'agents
@@ -34,6 +34,7 @@
 #include "JScriptFile.h"
 #include "LDIFFile.h"
 #include "vCardFile.h"
+#include "teeFile.h"
 
 #include "sFileSystem.h"
 
@@ -50,6 +51,7 @@
 #include <memory>
 #include <stdexcept>
 #include <array>
+#include <sys/wait.h>
 #endif // _WIN32
 
 // Ne sert à rien car __USE_CMD_LINE_ZIP__ est défini dans ODSFile.h
@@ -77,6 +79,11 @@ LDAPBrowser::LDAPBrowser(logs* pLogs, confFile* configurationFile)
 	logs_ = pLogs;
 	cmdLineFile_ = nullptr;
 	ldapServer_ = nullptr;
+	report_ = nullptr;
+	profiler_ = nullptr;
+	pending_ = nullptr;
+	mails_ = nullptr;
+	fileID_ = 0;
 
 #ifdef __LDAP_USE_ALLIER_TITLES__
 	titles_ = nullptr;
@@ -92,6 +99,9 @@ LDAPBrowser::LDAPBrowser(logs* pLogs, confFile* configurationFile)
 		myServer= ldapSources_[index];
 		if (myServer) {
 			logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Environnement : %s", myServer->environment());
+
+			// Les requêtes identiques des fichiers d'un même lot ne sont émises qu'une fois
+			myServer->setCache(true);
 		}
 	}
 
@@ -141,6 +151,29 @@ LDAPBrowser::LDAPBrowser(logs* pLogs, confFile* configurationFile)
 		}
 	}
 
+	// Mode de transfert
+	bool batchMails(false);
+	configurationFile_->deliveryMode(parallel_, async_, batchMails);
+	logs_->add(logs::TRACE_TYPE::LOG, "Transferts %s%s", (parallel_ ? "simultanés" : "séquentiels"), (async_ ? " en arrière-plan" : ""));
+
+	// Sessions FTP réutilisées
+	unsigned int ftpTimeout(0);
+	if (configurationFile_->ftpSessionsTimeout(ftpTimeout)) {
+		ftpSessions_.SetIdleTimeout(ftpTimeout);
+	}
+
+	if (ftpSessions_.GetIdleTimeout()) {
+		logs_->add(logs::TRACE_TYPE::LOG, "Sessions FTP conservées %u s", ftpSessions_.GetIdleTimeout());
+	}
+	else {
+		logs_->add(logs::TRACE_TYPE::LOG, "Pas de réutilisation des sessions FTP");
+	}
+
+	if (batchMails) {
+		mails_ = new mailQueue(logs_, configurationFile_->getFolders()->find(folders::FOLDER_TYPE::FOLDER_TEMP)->path());
+		logs_->add(logs::TRACE_TYPE::LOG, "Mails envoyés en fin d'analyse");
+	}
+
 	// Tableau des rôles
 	//
 	roles_.setLogs(logs_);
@@ -245,12 +278,42 @@ LDAPBrowser::LDAPBrowser(logs* pLogs, confFile* configurationFile)
 	}
 
 	logs_->add(logs::TRACE_TYPE::LOG, "%d éléments de structure dans le fichier de configuration pour %d niveaux différents", structs_.uniques(), structs_.size());
+
+	// Rapport d'exécution ?
+	LOGINFOS lInfos;
+	if (configurationFile_->logInfos(lInfos) && lInfos.report_) {
+		if (nullptr == (report_ = new runReport())) {
+			logs_->add(logs::TRACE_TYPE::ERR, "Pas de rapport d'exécution - Impossible d'allouer de la mémoire");
+		}
+		else {
+			logs_->add(logs::TRACE_TYPE::LOG, "Génération d'un rapport d'exécution pour chaque fichier de commandes");
+		}
+	}
+
+	// Profilage des requêtes LDAP ?
+	if (lInfos.profile_ || lInfos.prometheus_.size()) {
+		if (nullptr == (profiler_ = new queryProfiler(logs_, lInfos.threshold_))) {
+			logs_->add(logs::TRACE_TYPE::ERR, "Pas de profilage des requêtes - Impossible d'allouer de la mémoire");
+		}
+		else {
+			prometheus_ = lInfos.prometheus_;
+			logs_->add(logs::TRACE_TYPE::LOG, "Profilage des requêtes LDAP - Seuil de répétition : %u", (unsigned int)lInfos.threshold_);
+		}
+	}
 }
 
 // Destruction
 //
 LDAPBrowser::~LDAPBrowser()
 {
+	// Transferts en cours et mails en attente
+	flush();
+
+	if (mails_) {
+		delete mails_;
+		mails_ = nullptr;
+	}
+
 	// Libérations
 	//
 	_dispose(true);
@@ -268,6 +331,21 @@ LDAPBrowser::~LDAPBrowser()
 		titles_ = nullptr;
 	}
 #endif // __LDAP_USE_ALLIER_TITLES__
+
+	if (report_) {
+		delete report_;
+		report_ = nullptr;
+	}
+
+	// Les serveurs ne doivent plus utiliser le profileur
+	for (size_t index = 0; index < ldapSources_.size(); index++) {
+		ldapSources_[index]->setProfiler(nullptr);
+	}
+
+	if (profiler_) {
+		delete profiler_;
+		profiler_ = nullptr;
+	}
 }
 
 // Interrogation du serveur LDAP
@@ -283,6 +361,14 @@ RET_TYPE LDAPBrowser::browse()
 
 	logs_->add(logs::TRACE_TYPE::NORMAL, "Ouverture du fichier de configuration '%s'", cmdFile->fileName());
 
+	if (report_) {
+		report_->start(cmdFile->fileName());
+	}
+
+	if (profiler_) {
+		profiler_->start(_shortName(cmdFile).c_str());
+	}
+
 	// Limite d'utilisation du fichier
 	commandFile::date* pLimit(cmdFile->limit());
 	if (pLimit && pLimit->isSet()) {
@@ -331,6 +417,7 @@ RET_TYPE LDAPBrowser::browse()
 	// Paramètres LDAP
 	//
 	ldapServer_ = newServer;
+	ldapServer_->setProfiler(profiler_);
 	string env(ldapServer_->name());
 
 	if (ldapChanged && logs_) {
@@ -354,6 +441,7 @@ RET_TYPE LDAPBrowser::browse()
 		}
 
 		// Connexion à LDAP
+		runReport::timer connectTimer(report_, runReport::PHASE::CONNECT);
 		if (!_initLDAP()){
 			return RET_TYPE::RET_LDAP_ERROR;
 		}
@@ -421,7 +509,102 @@ RET_TYPE LDAPBrowser::browse()
 
 	// Création du fichier
 	//
-	return _createFile();
+	size_t requests(ldapServer_->requests());
+	RET_TYPE ret(_createFile());
+
+	if (report_) {
+		_count(runReport::COUNTER::LDAP_REQUESTS, ldapServer_->requests() - requests);
+	}
+
+	_saveReports(cmdFile, ret);
+	return ret;
+}
+
+// Fin d'une analyse : transferts en cours et mails en attente
+//
+bool LDAPBrowser::flush()
+{
+	_waitDeliveries();
+
+	size_t mailErrors(0);
+	if (mails_ && mails_->size()) {
+		mailErrors = mails_->flush();
+	}
+
+	// Fin du lot => libération des résultats partagés
+	LDAPServer* server(nullptr);
+	for (size_t index = 0; index < ldapSources_.size(); index++) {
+		if (nullptr != (server = ldapSources_[index])) {
+			if (server->cacheHits()) {
+				logs_->add(logs::TRACE_TYPE::LOG, "Environnement '%s' : %u requête(s) LDAP partagée(s) entre les fichiers de commandes", server->name(), (unsigned int)server->cacheHits());
+			}
+
+			server->clearCache();
+		}
+	}
+
+#ifdef __LDAP_USE_ALLIER_TITLES__
+	// Les intitulés seront relus pour le lot suivant (mode démon)
+	if (titles_) {
+		titles_->clear();
+	}
+#endif // #ifdef __LDAP_USE_ALLIER_TITLES__
+
+	return (0 == mailErrors);
+}
+
+// Nom du fichier de commandes sans dossier ni extension
+//
+string LDAPBrowser::_shortName(commandFile* cmdFile)
+{
+	string name(sFileSystem::split(cmdFile->fileName()));
+	size_t pos(name.rfind("."));
+	if (name.npos != pos) {
+		name = name.substr(0, pos);
+	}
+
+	return name;
+}
+
+// Enregistrement du rapport d'exécution dans le dossier des logs
+// et des statistiques des requêtes pour Prometheus
+//
+void LDAPBrowser::_saveReports(commandFile* cmdFile, RET_TYPE ret)
+{
+	if (nullptr == cmdFile) {
+		return;
+	}
+
+	string name(_shortName(cmdFile)), fullName("");
+
+	folders::folder* logFolder(configurationFile_->getFolders()->find(folders::FOLDER_TYPE::FOLDER_LOGS));
+	if (report_ && logFolder) {
+		fullName = sFileSystem::merge(logFolder->path(), name + RUN_REPORT_FILE_EXT);
+		if (pending_ && !pending_->reported()) {
+			// Transferts du fichier en arrière-plan : une copie du rapport sera complétée
+			//	puis enregistrée à leur fin
+			pending_->ownReport(new runReport(*report_), fullName, (int)ret, (profiler_ ? new queryProfiler(*profiler_) : nullptr));
+		}
+		else if (report_->save(fullName, (int)ret, profiler_)) {
+			logs_->add(logs::TRACE_TYPE::NORMAL, "Rapport d'exécution enregistré dans '%s'", fullName.c_str());
+		}
+		else {
+			logs_->add(logs::TRACE_TYPE::ERR, "Impossible d'enregistrer le rapport d'exécution '%s'", fullName.c_str());
+		}
+	}
+
+	if (profiler_) {
+		if (profiler_->repeated()) {
+			logs_->add(logs::TRACE_TYPE::LOG, "%u forme(s) de requête LDAP répétée(s) plus de %u fois", (unsigned int)profiler_->repeated(), (unsigned int)profiler_->threshold());
+		}
+
+		if (prometheus_.size()) {
+			fullName = sFileSystem::merge(prometheus_, QUERY_PROFILER_PROM_PREFIX + name + QUERY_PROFILER_PROM_EXT);
+			if (!profiler_->savePrometheus(fullName)) {
+				logs_->add(logs::TRACE_TYPE::ERR, "Impossible d'enregistrer les statistiques des requêtes dans '%s'", fullName.c_str());
+			}
+		}
+	}
 }
 
 // Libération de la mémoire
@@ -456,6 +639,7 @@ void LDAPBrowser::_dispose(bool freeLDAP)
 		delete file_;
 		file_ = nullptr;
 	}
+	rows_.clear();
 
 	// Effacement des colonnes
 	cols_.empty();
@@ -526,8 +710,10 @@ RET_TYPE LDAPBrowser::_createFile()
 	}
 
 	// Nom et type du fichier de sortie
+	//	en mode asynchrone, les paramètres sont conservés jusqu'à la fin des transferts
 	//
-	OPFI opfi;
+	std::unique_ptr<OPFI> opfiOwner(new OPFI);
+	OPFI& opfi(*opfiOwner);
 	if (!cmdFile->outputFileInfos(aliases_, opfi)){
 		logs_->add(logs::TRACE_TYPE::ERR, "Les informations sur le fichier à générer sont invalides");
 		return RET_TYPE::RET_INVALID_PARAMETERS;
@@ -573,83 +759,36 @@ RET_TYPE LDAPBrowser::_createFile()
 
 	// Création du générateur de fichier de sortie
 	//
-	switch (opfi.format_) {
-		// Les fichiers plats
-		case FILE_TYPE::FILE_TXT:
-		case FILE_TYPE::FILE_CSV: {
-			file_ = (outputFile*)new CSVFile(&opfi, &cols_, configurationFile_);
-			break;
-		}
-
-		// Les fichiers ODS
-		case FILE_TYPE::FILE_ODS: {
-			file_ = (outputFile*)new ODSFile(&opfi, &cols_, configurationFile_);
-#ifdef __USE_CMD_LINE_ZIP__
-			if (file_) {
-                // Recherche des alias sur zip/unzip
-				aliases::alias *aZip(aliases_.find(ALIAS_NAME_ZIP)), *aUnzip(aliases_.find(ALIAS_NAME_UNZIP));
-				if (nullptr == aZip || nullptr == aUnzip) {
-					logs_->add(logs::TRACE_TYPE::ERR, "Les alias '%s' et '%s' doivent être définis dans le fichier de configuration.", ALIAS_NAME_ZIP, ALIAS_NAME_UNZIP);
-					return RET_TYPE::RET_INVALID_PARAMETERS;
-				}
-
-				// Ils doivent pointer sur des objets existants.
-				if (false == aZip->exists()) {
-					logs_->add(logs::TRACE_TYPE::ERR, "La commande de l'alias '%s' n'existe pas", ALIAS_NAME_ZIP);
-					return RET_TYPE::RET_INVALID_PARAMETERS;
-				}
-
-				if (false == aUnzip->exists()) {
-					logs_->add(logs::TRACE_TYPE::ERR, "La commande de l'alias '%s' n'existe pas", ALIAS_NAME_UNZIP);
-					return RET_TYPE::RET_INVALID_PARAMETERS;
-				}
-
-				logs_->add(logs::TRACE_TYPE::NORMAL, "2 alias définis pour la gestion des fichiers ODS:");
-				logs_->add(logs::TRACE_TYPE::NORMAL, "\t- '%s' -  App : %s - Commande : %s", ALIAS_NAME_ZIP, aZip->application(), aZip->command());
-				logs_->add(logs::TRACE_TYPE::NORMAL, "\t- '%s' - App : %s - Commande : %s", ALIAS_NAME_UNZIP, aUnzip->application(), aZip->command());
-
-				// On passe les pointeurs
-				((ODSFile*)file_)->setAliases(aZip, aUnzip);
+	RET_TYPE ret(RET_TYPE::RET_OK);
+	teeFile* tee(nullptr);
+	if (opfi.formats_.size() > 1) {
+		// Plusieurs formats pour un même parcours de l'annuaire
+		file_ = tee = new teeFile(&opfi, &cols_, configurationFile_);
+
+		LPOPFI infos(nullptr);
+		outputFile* output(nullptr);
+		for (deque<FILE_TYPE>::iterator it = opfi.formats_.begin(); it != opfi.formats_.end(); it++) {
+			// Chaque fichier a ses propres informations
+			infos = new OPFI(opfi);
+			infos->format_ = (*it);
+
+			if (nullptr == (output = _newOutputFile(infos, ret))) {
+				delete infos;
+				return ret;
 			}
-#endif // __USE_CMD_LINE_ZIP__
 
-			break;
+			tee->addFile(output, infos);
 		}
 
-		// Les fichiers HTML ou JS
-		case FILE_TYPE::FILE_JS: {
-			file_ = (outputFile*)new JScriptFile(&opfi, &cols_, configurationFile_);
-			break;
-		}
-
-		// Un fichier LDIF
-		case FILE_TYPE::FILE_LDIF: {
-			file_ = (outputFile*)new LDIFFile(&opfi, &cols_, configurationFile_);
-			break;
-		}
-
-		// Un fichier VCARD / VCF
-		case FILE_TYPE::FILE_VCARD: {
-			file_ = (outputFile*)new vCardFile(&opfi, &cols_, configurationFile_);
-			break;
-		}
-
-		// Les autres ...
-		default: {
-			if (opfi.formatName_.length()) {
-				logs_->add(logs::TRACE_TYPE::ERR, "Le type \"%s\" ne correspond à aucun type de fichier pris en charge", opfi.formatName_.c_str());
-			}
-			else {
-				logs_->add(logs::TRACE_TYPE::ERR, "Le type %d ne correspond à aucun type de fichier pris en charge", opfi.format_);
-			}
-
-			return RET_TYPE::RET_INVALID_OUTPUT_FORMAT;
+		logs_->add(logs::TRACE_TYPE::LOG, "%d fichiers générés simultanément : %s", tee->files(), tee->fileExtension());
+		if (opfi.actions_.size()) {
+			logs_->add(logs::TRACE_TYPE::ERR, "Les actions postgen ne sont pas appliquées lorsque plusieurs formats sont demandés");
 		}
 	}
-
-	if (nullptr == file_) {
-		logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer le générateur de fichier");
-		return RET_TYPE::RET_BLOCKING_ERROR;
+	else {
+		if (nullptr == (file_ = _newOutputFile(&opfi, ret))) {
+			return ret;
+		}
 	}
 
 	// Lecture des paramètres spécifiques au format du fichier destination
@@ -668,6 +807,12 @@ RET_TYPE LDAPBrowser::_createFile()
         cols_.append((*it).name_.c_str(), (*it).type_.c_str());
     }
 
+	// Les transferts d'un fichier précédent de même nom doivent être terminés
+	//	avant l'initialisation : LDIF et VCARD ouvrent (et vident) le fichier à ce moment
+	if (pending_ && pending_->uses(file_->fileName())) {
+		_waitDeliveries();
+	}
+
 	// Initialisation du fichier (création des entetes)
 	if (!file_->initialize()) {
 		logs_->add(logs::TRACE_TYPE::ERR, "Erreur lors de l'initialisation du fichier de sortie");
@@ -781,6 +926,11 @@ RET_TYPE LDAPBrowser::_createFile()
 
 	logs_->add(logs::TRACE_TYPE::LOG, "Demande de création d'un fichier au format '%s' : '%s'", file_->fileExtension(), file_->fileName());
 
+	// ... et avant la création si le nom définitif est différent
+	if (pending_ && pending_->uses(file_->fileName())) {
+		_waitDeliveries();
+	}
+
 	// Création du fichier
 	if (!file_->create()) {
 		logs_->add(logs::TRACE_TYPE::ERR, "Erreur lors de la création du fichier de sortie");
@@ -954,94 +1104,48 @@ RET_TYPE LDAPBrowser::_createFile()
 	// Enregistrement du fichier temporaire
 	//
 	//RET_TYPE done(RET_TYPE::RET_OK);
-	if (!file_->close()){
+	runReport::timer closeTimer(report_, runReport::PHASE::CLOSE);
+	bool closed(file_->close());
+	closeTimer.stop();
+
+	if (!closed){
 		logs_->add(logs::TRACE_TYPE::ERR, "Le fichier temporaire n'a pu être sauvegardé");
 		//done = RET_TYPE::RET_UNABLE_TO_SAVE;
 	}
 	else{
+		deliveries* jobs(new deliveries(logs_, parallel_));
 
-		if (0 != sFileSystem::file_size(file_->fileName())) {
-			logs_->add(logs::TRACE_TYPE::LOG, "Fichier temporaire enregistré avec succès");
-
-			// Y a t'il des traitements "postgen" ?
-			_handlePostGenActions(opfi);
-
-			// On s'occupe maintenant des différentes destinations
-			//
-			fileDestination* dest(nullptr), * destination(nullptr);
-			//mailDestination* pMail(nullptr);
-			string fullName("");
-			for (deque<fileDestination*>::iterator it = opfi.dests_.begin(); it != opfi.dests_.end(); it++) {
-				destination = (*it);
-
-				// Est-ce une destination "nommée" (ie elle doit correspondre à une entrée dans
-				// la liste des serveurs)
-				if (destination && strlen(destination->name())) {
-					if (nullptr == (dest = servers_.getDestinationByName(destination->name()))) {
-						// A priori ce cas a été détecté ...
-						logs_->add(logs::TRACE_TYPE::ERR, "La destination '%s' n'est pas définie", destination->name());
-					}
-					else {
-						logs_->add(logs::TRACE_TYPE::NORMAL, "Utilisation de la destination '%s'", destination->name());
-					}
+		if (nullptr != tee) {
+			// Chaque fichier est transmis à toutes les destinations
+			for (size_t index = 0; index < tee->files(); index++) {
+				if (false == _deliver((*tee)[index], opfi, *jobs)) {
+					atLeastOneError = true;
 				}
-				else {
-					// Sinon on utilise les informations contenues dans le fichier
-					dest = destination;
-				}
-
-				if (nullptr != dest) {
-					switch (dest->type()) {
-                    // Une copie de fichier
-                    case DEST_TYPE::DEST_FS: {
-                        string name(sFileSystem::split(file_->fileName()));
-						fullName = sFileSystem::merge(dest->folder(), name);
-						//fullName = sFileSystem::merge(dest->folder(), opfi.name_);
-
-						if (!sFileSystem::copy_file(file_->fileName(), fullName.c_str())) {
-							atLeastOneError = true;
-							logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer le fichier '%s'", fullName.c_str());
-						}
-						else {
-							logs_->add(logs::TRACE_TYPE::LOG, "Le fichier a été copié avec succès vers '%s'", fullName.c_str());
-						}
-						break;
-					}
-
-                    // Envoi par mail
-					case DEST_TYPE::DEST_EMAIL: {
-						if (!_SMTPTransfer((mailDestination*)dest)) {
-							atLeastOneError = true;
-						}
-						break;
-					}
-
-                    // Transfert par FTP
-					case DEST_TYPE::DEST_FTP: {
-						if (!_FTPTransfer((FTPDestination*)dest)) {
-							atLeastOneError = true;
-						}
-						break;
-					}
+			}
+		}
+		else {
+			if (false == _deliver(file_, opfi, *jobs)) {
+				atLeastOneError = true;
+			}
+		}
 
-                    // Transfert par SCP
-					case DEST_TYPE::DEST_SCP: {
-						if (!_SCPTransfer((SCPDestination*)dest)) {
-							atLeastOneError = true;
-						}
-						break;
-					}
+		if (async_ && jobs->size()) {
+			// Les transferts se poursuivent pendant la génération du fichier suivant
+			//	la liste devient propriétaire du fichier et de ses paramètres
+			_waitDeliveries();
 
-					default:
-						// ????
-						break;
-					}
-				}
-			}
+			jobs->own(file_, opfiOwner.release(), atLeastOneError);
+			file_ = nullptr;
+			pending_ = jobs;
 		}
 		else {
-			logs_->add(logs::TRACE_TYPE::LOG, "Pas de fichier temporaire enregistré (ou taille nulle)");
-			atLeastOneError = true;
+			if (jobs->wait(report_)) {
+				atLeastOneError = true;
+			}
+
+			delete jobs;
+
+			file_->delivered(!atLeastOneError);
 		}
 	}
 
@@ -1069,6 +1173,254 @@ RET_TYPE LDAPBrowser::_createFile()
 	return (atLeastOneError? RET_TYPE::RET_NON_BLOCKING_ERROR : RET_TYPE::RET_OK);
 }
 
+// Transfert d'un fichier généré vers toutes les destinations
+//
+bool LDAPBrowser::_deliver(outputFile* file, OPFI& opfi, deliveries& jobs)
+{
+	if (0 == sFileSystem::file_size(file->fileName())) {
+		logs_->add(logs::TRACE_TYPE::LOG, "Pas de fichier temporaire enregistré (ou taille nulle)");
+		return false;
+	}
+
+	logs_->add(logs::TRACE_TYPE::LOG, "Fichier temporaire '%s' enregistré avec succès", file->fileName(false));
+
+	// Y a t'il des traitements "postgen" ? (uniquement pour un fichier seul)
+	if (file == file_) {
+		_handlePostGenActions(file, opfi);
+	}
+
+	// Taille du fichier transmis (pour le rapport d'exécution)
+	size_t fileSize(sFileSystem::file_size(file->fileName()));
+	_count(runReport::COUNTER::FILE_BYTES, fileSize);
+
+	// Copie complémentaire (fichier JS compressé ...) transmise avec le fichier
+	const char* sidecar(file->sidecarExtension());
+	if (sidecar) {
+		string sidecarName(file->fileName());
+		sidecarName += sidecar;
+		if (!sFileSystem::exists(sidecarName)) {
+			sidecar = nullptr;
+		}
+	}
+
+	// On s'occupe maintenant des différentes destinations
+	//	chaque transfert est confié à la liste (et exécuté en parallèle si demandé)
+	//
+	fileDestination* dest(nullptr), * destination(nullptr);
+	int timeout(0);
+	bool done(true);
+	fileID_++;
+	for (deque<fileDestination*>::iterator it = opfi.dests_.begin(); it != opfi.dests_.end(); it++) {
+		destination = (*it);
+
+		// Est-ce une destination "nommée" (ie elle doit correspondre à une entrée dans
+		// la liste des serveurs)
+		if (destination && strlen(destination->name())) {
+			if (nullptr == (dest = servers_.getDestinationByName(destination->name()))) {
+				// A priori ce cas a été détecté ...
+				logs_->add(logs::TRACE_TYPE::ERR, "La destination '%s' n'est pas définie", destination->name());
+			}
+			else {
+				logs_->add(logs::TRACE_TYPE::NORMAL, "Utilisation de la destination '%s'", destination->name());
+			}
+		}
+		else {
+			// Sinon on utilise les informations contenues dans le fichier
+			dest = destination;
+		}
+
+		if (nullptr != dest) {
+			// Le délai du fichier de commandes est prioritaire
+			timeout = ((destination && destination->timeout()) ? destination->timeout() : dest->timeout());
+
+			switch (dest->type()) {
+			// Une copie de fichier
+			case DEST_TYPE::DEST_FS: {
+				jobs.add(dest, file->fileName(), fileSize, [this, file, dest, sidecar]() {
+					string fullName(sFileSystem::merge(dest->folder(), sFileSystem::split(file->fileName())));
+					if (!sFileSystem::copy_file(file->fileName(), fullName.c_str())) {
+						logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer le fichier '%s'", fullName.c_str());
+						return false;
+					}
+
+					logs_->add(logs::TRACE_TYPE::LOG, "Le fichier a été copié avec succès vers '%s'", fullName.c_str());
+
+					// et sa copie complémentaire
+					if (sidecar) {
+						string source(file->fileName());
+						source += sidecar;
+						fullName += sidecar;
+						if (!sFileSystem::copy_file(source.c_str(), fullName.c_str())) {
+							logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer le fichier '%s'", fullName.c_str());
+							return false;
+						}
+					}
+
+					return true;
+				});
+				break;
+			}
+
+			// Envoi par mail
+			case DEST_TYPE::DEST_EMAIL: {
+				// Envoi différé (en fin d'analyse) ?
+				if (mails_) {
+					if (!mails_->add((mailDestination*)dest, file->fileName(), fileID_, timeout)) {
+						done = false;
+					}
+					break;
+				}
+
+				jobs.add(dest, file->fileName(), fileSize, [this, file, dest, timeout]() {
+					return _SMTPTransfer(file, (mailDestination*)dest, timeout);
+				});
+				break;
+			}
+
+			// Transfert par FTP
+			case DEST_TYPE::DEST_FTP: {
+				jobs.add(dest, file->fileName(), fileSize, [this, file, dest, timeout, sidecar]() {
+					return (_FTPTransfer(file, (FTPDestination*)dest, timeout)
+						&& (nullptr == sidecar || _FTPTransfer(file, (FTPDestination*)dest, timeout, sidecar)));
+				});
+				break;
+			}
+
+			// Transfert par SCP
+			case DEST_TYPE::DEST_SCP: {
+				jobs.add(dest, file->fileName(), fileSize, [this, file, dest, timeout, sidecar]() {
+					return (_SCPTransfer(file, (SCPDestination*)dest, timeout)
+						&& (nullptr == sidecar || _SCPTransfer(file, (SCPDestination*)dest, timeout, sidecar)));
+				});
+				break;
+			}
+
+			default:
+				// ????
+				break;
+			}
+		}
+	}
+
+	return done;
+}
+
+// Attente de la fin des transferts en arrière-plan
+//	les erreurs ne sont plus que tracées
+//
+void LDAPBrowser::_waitDeliveries()
+{
+	if (nullptr == pending_) {
+		return;
+	}
+
+	logs_->add(logs::TRACE_TYPE::DBG, "Attente de la fin des transferts en cours");
+
+	// Les transferts du fichier en cours complètent son rapport
+	size_t errors(pending_->wait(pending_->reported() ? nullptr : report_));
+	if (errors) {
+		logs_->add(logs::TRACE_TYPE::ERR, "%u transfert(s) en arrière-plan en erreur", (unsigned int)errors);
+	}
+
+	delete pending_;
+	pending_ = nullptr;
+}
+
+// Création d'un générateur de fichier de sortie
+//
+outputFile* LDAPBrowser::_newOutputFile(LPOPFI opfi, RET_TYPE& ret)
+{
+	outputFile* file(nullptr);
+	ret = RET_TYPE::RET_OK;
+	switch (opfi->format_) {
+		// Les fichiers plats
+		case FILE_TYPE::FILE_TXT:
+		case FILE_TYPE::FILE_CSV: {
+			file = (outputFile*)new CSVFile(opfi, &cols_, configurationFile_);
+			break;
+		}
+
+		// Les fichiers ODS
+		case FILE_TYPE::FILE_ODS: {
+			file = (outputFile*)new ODSFile(opfi, &cols_, configurationFile_);
+#ifdef __USE_CMD_LINE_ZIP__
+			if (file) {
+                // Recherche des alias sur zip/unzip
+				aliases::alias *aZip(aliases_.find(ALIAS_NAME_ZIP)), *aUnzip(aliases_.find(ALIAS_NAME_UNZIP));
+				if (nullptr == aZip || nullptr == aUnzip) {
+					logs_->add(logs::TRACE_TYPE::ERR, "Les alias '%s' et '%s' doivent être définis dans le fichier de configuration.", ALIAS_NAME_ZIP, ALIAS_NAME_UNZIP);
+					delete file;
+					ret = RET_TYPE::RET_INVALID_PARAMETERS;
+					return nullptr;
+				}
+
+				// Ils doivent pointer sur des objets existants.
+				if (false == aZip->exists()) {
+					logs_->add(logs::TRACE_TYPE::ERR, "La commande de l'alias '%s' n'existe pas", ALIAS_NAME_ZIP);
+					delete file;
+					ret = RET_TYPE::RET_INVALID_PARAMETERS;
+					return nullptr;
+				}
+
+				if (false == aUnzip->exists()) {
+					logs_->add(logs::TRACE_TYPE::ERR, "La commande de l'alias '%s' n'existe pas", ALIAS_NAME_UNZIP);
+					delete file;
+					ret = RET_TYPE::RET_INVALID_PARAMETERS;
+					return nullptr;
+				}
+
+				logs_->add(logs::TRACE_TYPE::NORMAL, "2 alias définis pour la gestion des fichiers ODS:");
+				logs_->add(logs::TRACE_TYPE::NORMAL, "\t- '%s' -  App : %s - Commande : %s", ALIAS_NAME_ZIP, aZip->application(), aZip->command());
+				logs_->add(logs::TRACE_TYPE::NORMAL, "\t- '%s' - App : %s - Commande : %s", ALIAS_NAME_UNZIP, aUnzip->application(), aZip->command());
+
+				// On passe les pointeurs
+				((ODSFile*)file)->setAliases(aZip, aUnzip);
+			}
+#endif // __USE_CMD_LINE_ZIP__
+
+			break;
+		}
+
+		// Les fichiers HTML ou JS
+		case FILE_TYPE::FILE_JS: {
+			file = (outputFile*)new JScriptFile(opfi, &cols_, configurationFile_);
+			break;
+		}
+
+		// Un fichier LDIF
+		case FILE_TYPE::FILE_LDIF: {
+			file = (outputFile*)new LDIFFile(opfi, &cols_, configurationFile_);
+			break;
+		}
+
+		// Un fichier VCARD / VCF
+		case FILE_TYPE::FILE_VCARD: {
+			file = (outputFile*)new vCardFile(opfi, &cols_, configurationFile_);
+			break;
+		}
+
+		// Les autres ...
+		default: {
+			if (opfi->formatName_.length()) {
+				logs_->add(logs::TRACE_TYPE::ERR, "Le type \"%s\" ne correspond à aucun type de fichier pris en charge", opfi->formatName_.c_str());
+			}
+			else {
+				logs_->add(logs::TRACE_TYPE::ERR, "Le type %d ne correspond à aucun type de fichier pris en charge", opfi->format_);
+			}
+
+			ret = RET_TYPE::RET_INVALID_OUTPUT_FORMAT;
+			return nullptr;
+		}
+	}
+
+	if (nullptr == file) {
+		logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer le générateur de fichier");
+		ret = RET_TYPE::RET_BLOCKING_ERROR;
+	}
+
+	return file;
+}
+
 // Execution d'une requete
 // Tous les agents seront ajoutés dans un onglet
 //
@@ -1090,6 +1442,20 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 	keyValTuple* role = roles_[ROLE_MANAGER];
 	string managersAttr((role && 0 != role->value().size())?role->value():"");
 
+	// Attributs interprétés quelles que soient les colonnes
+	//	les autres attributs sans colonne sont ignorés => la recherche est partagée avec les fichiers
+	//	du lot qui affichent d'autres colonnes
+	set<string> reserved;
+	const char* decoded[] = { STR_ATTR_PRENOM, STR_ATTR_NOM, STR_ATTR_EMAIL, STR_ATTR_GROUP_ID_NUMBER, STR_ATTR_USER_ID_NUMBER,
+		STR_ATTR_ALLIER_STATUS, STR_ATTR_ALLIER_REMPLACEMENT, STR_ATTR_ALLIER_OTHER_DN, STR_ATTR_ALLIER_MATRICULE, STR_ATTR_ALLIER_ID_POSTE };
+	for (size_t index = 0; index < sizeof(decoded) / sizeof(decoded[0]); index++) {
+		reserved.insert(charUtils::strlwr(decoded[index]));
+	}
+
+	if (managersAttr.size()) {
+		reserved.insert(charUtils::strlwr(managersAttr.c_str()));
+	}
+
 	// Le remplaçant
 	//size_t colRemplacement = cols_.getColumnByType(STR_ATTR_ALLIER_REMPLACEMENT);
 	LPAGENTINFOS replacement(nullptr);
@@ -1099,12 +1465,13 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 	size_t colPoste = cols_.getColumnByType(COL_ID_POSTE);
 	if (colPoste != cols_.npos) {
 		// on demandes intitulés => on s'assure que la liste est chargée
-		if (nullptr == titles_) {
-			if (nullptr == (titles_ = new jhbLDAPTools::titles(logs_))) {
-				logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer la liste des postes => pas d'intitulés");
-				colPoste = cols_.npos;
-			}
-			else {
+		//	elle est vidée à chaque changement de serveur et à la fin de chaque lot
+		if (nullptr == titles_ && nullptr == (titles_ = new jhbLDAPTools::titles(logs_))) {
+			logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer la liste des postes => pas d'intitulés");
+			colPoste = cols_.npos;
+		}
+		else {
+			if (0 == titles_->size()) {
 				// Récupération des intitulés de poste
 				if (!_getTitles()) {
 					logs_->add(logs::TRACE_TYPE::ERR, "Erreur de la récupération des intitulés de poste");
@@ -1221,12 +1588,16 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 		string nodeDN = searchDN ? searchDN : ldapServer_->baseDN();
 #ifdef __LDAP_OWN_SCOPE_BASE__
 		/// Seules les recherches en mode LDAP_SCOPE_SUBTREE fonctionnent ...
-		retCode = ldapServer_->searchExtS((char*)(nodeDN.c_str()), LDAP_SCOPE_SUBTREE, (char*)currentFilter.c_str(), attributes, 0, serverControls, nullptr, nullptr, 0, &searchResult);
+		runReport::timer searchTimer(report_, runReport::PHASE::SEARCH);
+		retCode = ldapServer_->searchExtS((char*)(nodeDN.c_str()), LDAP_SCOPE_SUBTREE, (char*)currentFilter.c_str(), attributes, 0, serverControls, nullptr, nullptr, 0, &searchResult, &reserved);
 #else
 		// ... et lorsque le scope LDAP_SCOPE_BASE fonctionne
-		retCode = ldapServer_->searchExtS((char*)(searchDN ? searchDN : ldapServer_->baseDN()), treeSearch ? LDAP_SCOPE_SUBTREE : LDAP_SCOPE_BASE, (char*)currentFilter.c_str(), attributes, 0, serverControls, nullptr, nullptr, 0, &searchResult);
+		runReport::timer searchTimer(report_, runReport::PHASE::SEARCH);
+		retCode = ldapServer_->searchExtS((char*)(searchDN ? searchDN : ldapServer_->baseDN()), treeSearch ? LDAP_SCOPE_SUBTREE : LDAP_SCOPE_BASE, (char*)currentFilter.c_str(), attributes, 0, serverControls, nullptr, nullptr, 0, &searchResult, &reserved);
 #endif // __LDAP_OWN_SCOPE_BASE__
+		searchTimer.stop();
 		agentsFound = ldapServer_->countEntries(searchResult);
+		_count(runReport::COUNTER::ENTRIES, agentsFound);
 
 		// Des résultats ?
 		//
@@ -1283,6 +1654,7 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 
 			// Lecture ligne par ligne
 			//
+			runReport::timer decodeTimer(report_, runReport::PHASE::DECODE);
 			agentsAdded = 0; // Personne n'a été ajouté pour l'instant !
 			for (ULONG index(0); index < agentsFound; index++){
 				// Initialisation des données sur l'utilisateur
@@ -1338,7 +1710,7 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 								u8Value = *pValue;
 #endif // #ifdef UTF8_ENCODE_INPUTS
 
-								file_->setAttributeNames(pci ? pci->names_ : nullptr);
+								rows_.setAttributeNames(pci ? pci->names_ : nullptr);
 
 								// Valeurs recherchées dans tous les cas
 								//
@@ -1440,19 +1812,20 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 #endif // #ifdef UTF8_ENCODE_INPUTS
 										}
 
-										file_->addAt(realColIndex, values);
+										rows_.addAt(realColIndex, values);
 									}
 									else {
 										// une seule valeur ...
 										//
-										file_->addAt(realColIndex, u8Value);
+										rows_.addAt(realColIndex, u8Value);
 									} // VALUE_TYPE::MULTIVALUE
 								} // if visible
 
 								ldapServer_->valueFree(pValue);
 							} // pValue ?
 
-							file_->setAttributeNames(nullptr);
+							rows_.setAttributeNames(nullptr);
+							_count(runReport::COUNTER::ATTRIBUTES);
 
 							// Prochain attribut
 							pAttribute = ldapServer_->nextAttribute(pEntry, pBer);
@@ -1476,7 +1849,7 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 										realColIndex = cols_.getColumnByAttribute((PCHAR)name.c_str(), nullptr);	// ID de la colonne
 
 										// Ajout dans le fichier
-										file_->addAt(realColIndex, value);
+										rows_.addAt(realColIndex, value);
 									}
 								}
 							}
@@ -1518,13 +1891,15 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 
 						// Lorsque le poste est vacant, il n'y a plus de prénom ni d'adresse mail
 						if (ALLIER_STATUS_VACANT == (allierStatus & ALLIER_STATUS_VACANT)) {
-							file_->removeAt(cols_.getColumnByType(COL_PRENOM));
-							file_->replaceAt(cols_.getColumnByType(COL_NOM), STR_VACANT_JOB);
-							file_->removeAt(cols_.getColumnByAttribute(STR_ATTR_EMAIL));
+							rows_.removeAt(cols_.getColumnByType(COL_PRENOM));
+							rows_.replaceAt(cols_.getColumnByType(COL_NOM), STR_VACANT_JOB);
+							rows_.removeAt(cols_.getColumnByAttribute(STR_ATTR_EMAIL));
 						}
 
-						// Sauvegarde / ligne suivante
-						file_->saveLine(false, agent);
+						// Sauvegarde / ligne suivante (le lot est écrit lorsqu'il est complet)
+						if (rows_.saveLine(agent)) {
+							_writeRows();
+						}
 					}
 #ifdef __LDAP_OWN_SCOPE_BASE__
 				} // dn.size()
@@ -1573,6 +1948,9 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 	}
 #endif // __LDAP_CUT_REQUESTS__
 
+	// Dernières lignes
+	_writeRows();
+
 	// retourne le nombre d'agents effectivement  ajoutés
 	//	totalAgents correspond au nombre d'éléments dans l'organigramme et outputFile::size() au nombre de "lignes" dans le fichier de sortie
 	return ((0 == totalAgents)?file_->size():totalAgents);
@@ -1582,6 +1960,8 @@ size_t LDAPBrowser::_simpleLDAPRequest(PCHAR* attributes, commandFile::criterium
 //
 bool LDAPBrowser::_getLDAPContainers()
 {
+	runReport::timer containersTimer(report_, runReport::PHASE::CONTAINERS);
+
 	// Connecté ?
 	if (!ldapServer_->connected()){
 		return false;
@@ -1904,6 +2284,8 @@ bool LDAPBrowser::_getTitles()
 //
 bool LDAPBrowser::_getUserGroups(string& userDN, size_t colID, const char* gID)
 {
+	runReport::timer groupsTimer(report_, runReport::PHASE::GROUPS);
+
 	// Vérification des paramètres
 	if (!ldapServer_->connected() ||
 		!userDN.size() || SIZE_MAX == colID){
@@ -2012,11 +2394,11 @@ bool LDAPBrowser::_getUserGroups(string& userDN, size_t colID, const char* gID)
 				// tous les groupes avec en 1er le groupe primaire
 				values.erase(pWhere);		// Retrait de sa pos.
 				values.push_front(value);	// et copie en tête de liste
-				file_->addAt(colID, values);
+				rows_.addAt(colID, values);
 			}
 			else{
 				// Juste le gorupe primaire
-				file_->addAt(colID, (char*)value.c_str());
+				rows_.addAt(colID, value);
 			}
 		}
 		else{
@@ -2027,11 +2409,11 @@ bool LDAPBrowser::_getUserGroups(string& userDN, size_t colID, const char* gID)
 			// Pas besoin de changer l'ordre
 			//
 			if (cols_[colID]->multiValued()){
-				file_->addAt(colID, values);
+				rows_.addAt(colID, values);
 			}
 			else{
 				// Juste le groupe primaire
-				file_->addAt(colID, (char*)value.c_str());
+				rows_.addAt(colID, value);
 			}
 		}
 	}
@@ -2144,6 +2526,7 @@ void LDAPBrowser::_managersForEmptyContainers(std::string& baseContainer)
 void LDAPBrowser::_generateOrgChart(std::string& baseContainer)
 {
 	assert(file_);
+	runReport::timer orgChartTimer(report_, runReport::PHASE::ORGCHART);
 
 	// Je veux générer l'organigramme
 	bool newFile(true);
@@ -2271,12 +2654,13 @@ void LDAPBrowser::_addOrgLeaf(orgChartFile* orgFile, orgChartFile::treeCursor& a
 
 // Envoi du fichier en PJ d'un mail
 //
-const bool LDAPBrowser::_SMTPTransfer(mailDestination* mailDest)
+const bool LDAPBrowser::_SMTPTransfer(outputFile* file, mailDestination* mailDest, int timeout)
 {
 	jhbCURLTools::SMTPClient mail(mailDest->smtpFrom(), "", mailDest->smtpObject(), mailDest->smtpObject());
+	mail.setTimeout(timeout);
 
 	// Ajout du fichier
-	mail.addAttachment(file_->fileName());
+	mail.addAttachment(file->fileName());
 
 	// Le destinataire
 	mail.addRecipient(mailDest->folder());
@@ -2294,37 +2678,51 @@ const bool LDAPBrowser::_SMTPTransfer(mailDestination* mailDest)
 
 // Transfert du fichier par FTP
 //
-const bool LDAPBrowser::_FTPTransfer(FTPDestination* ftpDest)
+const bool LDAPBrowser::_FTPTransfer(outputFile* file, FTPDestination* ftpDest, int timeout, const char* sidecar)
 {
 	if (nullptr == ftpDest){
 		return false;
 	}
 
+	// Fichier source et nom sur le serveur
+	string source(file->fileName(true)), shortName(file->fileName(false));
+	if (sidecar) {
+		source += sidecar;
+		shortName += sidecar;
+	}
+
 	string destName("");
-	ftpDest->ftpDestinationFile(destName, file_->fileName(false));
+	ftpDest->ftpDestinationFile(destName, shortName.c_str());
 
-	// Construction sans gestion des logs ...
+	// Session (réutilisée si un transfert vers le même serveur a déjà eu lieu)
 	//
-	jhbCURLTools::FTPClient ftpClient;
+	jhbCURLTools::FTPClient* ftpClient(nullptr);
+	bool reused(false);
 
 	try {
 		// Connexion
-		ftpClient.InitSession(ftpDest->ftpServer(), ftpDest->ftpPort(), ftpDest->ftpUser(), ftpDest->ftpPwd());
+		ftpClient = ftpSessions_.Acquire(ftpDest->ftpServer(), ftpDest->ftpPort(), ftpDest->ftpUser(), ftpDest->ftpPwd(), reused);
+
+		// Pas de signaux (transfert dans un thread)
+		ftpClient->SetNoSignal(true);
+		ftpClient->SetTimeout(timeout > 0 ? timeout : 0);
 
 		// Transfert du fichier
-		logs_->add(logs::TRACE_TYPE::NORMAL, "\t - Transfert du fichier '%s' par FTP vers '%s'", file_->fileName(false), ftpDest->name());
+		logs_->add(logs::TRACE_TYPE::NORMAL, "\t - Transfert du fichier '%s' par FTP vers '%s'%s", shortName.c_str(), ftpDest->name(), (reused ? " (session existante)" : ""));
 
-		ftpClient.UploadFile(file_->fileName(true), destName);
+		ftpClient->UploadFile(source, destName);
 
-		// Fermeture de la connexion
-		ftpClient.CleanupSession();
+		// La session reste ouverte pour les transferts suivants
+		ftpSessions_.Release(ftpClient);
 	}
 	catch (jhbCURLTools::CURLException& e) {
+		ftpSessions_.Release(ftpClient, false);
 		logs_->add(logs::TRACE_TYPE::ERR, e.what());
 		return false;
 	}
 	catch (...) {
 		// Erreur inconnue
+		ftpSessions_.Release(ftpClient, false);
 		logs_->add(logs::TRACE_TYPE::ERR, "Transfert FTP - Erreur inconnue");
 		return false;
 	}
@@ -2336,23 +2734,32 @@ const bool LDAPBrowser::_FTPTransfer(FTPDestination* ftpDest)
 
 // Transfert par SCP
 //
-const bool LDAPBrowser::_SCPTransfer(SCPDestination* scpDest)
+const bool LDAPBrowser::_SCPTransfer(outputFile* file, SCPDestination* scpDest, int timeout, const char* sidecar)
 {
-	aliases::alias* alias(nullptr);
-	if (nullptr == scpDest || nullptr == (alias = scpDest->alias())) {
+	aliases::alias* source(nullptr);
+	if (nullptr == scpDest || nullptr == (source = scpDest->alias())) {
 		return false;	// Erreur
 	}
 
-	if (0 == strlen(alias->application())) {
-		logs_->add(logs::TRACE_TYPE::ERR, "Transfert SCP '%s' - Pas d'application dans l'Alias '%s'", scpDest->name(), alias->name());
+	if (0 == strlen(source->application())) {
+		logs_->add(logs::TRACE_TYPE::ERR, "Transfert SCP '%s' - Pas d'application dans l'Alias '%s'", scpDest->name(), source->name());
 		return false;
 	}
 
+	// L'alias peut être partagé par plusieurs transferts simultanés
+	//	=> les tokens sont ajoutés à une copie locale
+	string name(source->name()), app(source->application()), cmd(source->command());
+	aliases::alias localAlias(name, app, cmd);
+	aliases::alias* alias(&localAlias);
+
 	// Remplacement des tokens pour générer la ligne de commande SCP
 	//
 
 	// Nom court du fichier
-	string value(file_->fileName(true));
+	string value(file->fileName(true));
+	if (sidecar) {
+		value += sidecar;
+	}
 	alias->addToken(TOKEN_SRC_FILENAME, value.c_str());
 
 	// Dossier ?
@@ -2371,6 +2778,9 @@ const bool LDAPBrowser::_SCPTransfer(SCPDestination* scpDest)
 
 	// Le fichier destination
 	string destName(sFileSystem::merge(scpDest->folder(), scpDest->name()));
+	if (sidecar) {
+		destName += sidecar;
+	}
 	alias->addToken(TOKEN_DEST_NAME, destName.c_str());
 
 	// Login
@@ -2400,14 +2810,14 @@ const bool LDAPBrowser::_SCPTransfer(SCPDestination* scpDest)
 	logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Commande : %s", logCmd.c_str());
 
 	string message("");
-	if (_exec(alias->application(), command, message)) {
-		logs_->add(logs::TRACE_TYPE::LOG, "Transfert SCP '%s' effectué avec succès", scpDest->name());
-		if (0 != message.size()){
-		    logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Message retour : %s", message.c_str());
-		}
-	}
-	else {
+	if (!_exec(alias->application(), command, message, timeout)) {
 		logs_->add(logs::TRACE_TYPE::ERR, "Transfert SCP '%s' - Erreur : %s", scpDest->name(), message.c_str());
+		return false;
+	}
+
+	logs_->add(logs::TRACE_TYPE::LOG, "Transfert SCP '%s' effectué avec succès", scpDest->name());
+	if (0 != message.size()){
+	    logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Message retour : %s", message.c_str());
 	}
 
 	// Transféré avec succès
@@ -2416,15 +2826,17 @@ const bool LDAPBrowser::_SCPTransfer(SCPDestination* scpDest)
 
 // Gestion des actions
 //
-void LDAPBrowser::_handlePostGenActions(OPFI& opfi)
+void LDAPBrowser::_handlePostGenActions(outputFile* outFile, OPFI& opfi)
 {
 	// rien à faire ...
 	if (0 == opfi.actions_.size()) {
 		return;
 	}
 
+	runReport::timer postGenTimer(report_, runReport::PHASE::POSTGEN);
+
 	// Nom des fichiers
-	string file = file_->fileName();
+	string file = outFile->fileName();
 	string srcFile(file);
 	size_t pos = file.rfind(".");
 	if (file.npos != pos) {
@@ -2439,6 +2851,10 @@ void LDAPBrowser::_handlePostGenActions(OPFI& opfi)
 	bool launched(false);
 	fileActions::fileAction* action(nullptr);
 
+	// Les actions sont lancées dans le dossier temporaire (là ou se trouve le fichier source)
+	//	sans changer le dossier courant du processus (partagé par les threads de traitement)
+	string tempFolder(configurationFile_->getFolders()->find(folders::FOLDER_TYPE::FOLDER_TEMP)->path());
+
 	for (size_t index = 0; index < opfi.actions_.size(); index++) {
 		if (nullptr != (action = opfi.actions_[index])) {
 			if (fileActions::ACTION_TYPE::ACTION_POST_GEN == action->type()) {
@@ -2451,11 +2867,8 @@ void LDAPBrowser::_handlePostGenActions(OPFI& opfi)
 					logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Application : %s", action->application());
 					logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Paramètres : %s", action->parameters());
 
-					// On se positionne dans le dossier temporaire (là ou se trouve le fichier source)
-					sFileSystem::current_path(configurationFile_->getFolders()->find(folders::FOLDER_TYPE::FOLDER_TEMP)->path());
-
 					// Exécution ...
-					if (true == (launched = _exec(action->application(), action->parameters(), message))) {
+					if (true == (launched = _exec(action->application(), action->parameters(), message, 0, tempFolder.c_str()))) {
 
 						// Retour du binaire appelé
 						if (0 != message.size()){
@@ -2467,6 +2880,15 @@ void LDAPBrowser::_handlePostGenActions(OPFI& opfi)
 						// Y a t'il eu génération d'un fichier ?
 						output = action->outputFilename();
 						if (0 != output.size()) {
+							// Un nom relatif l'est par rapport au dossier temporaire
+#ifdef _WIN32
+							if (!(output.size() > 1 && (':' == output[1] || FILENAME_SEP == output[0]))) {
+#else
+							if (FILENAME_SEP != output[0]) {
+#endif // _WIN32
+								output = sFileSystem::merge(tempFolder, output);
+							}
+
 							if (sFileSystem::exists(output)) {
 
 								// Suppression de la "source"
@@ -2474,7 +2896,7 @@ void LDAPBrowser::_handlePostGenActions(OPFI& opfi)
 
 								// On remplace le nom du fichier "source" par celui généré
 								//
-								file_->setFileName(output, false);			// dans le "fichier" le nom complet
+								outFile->setFileName(output, false);		// dans le "fichier" le nom complet
 								opfi.name_ = sFileSystem::split(output);	// le nom court
 
 								logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Renomamge du fichier de sortie en : %s", output.c_str());							}
@@ -2502,7 +2924,7 @@ void LDAPBrowser::_handlePostGenActions(OPFI& opfi)
 
 // Exécution d'une application
 //
-bool LDAPBrowser::_exec(const string& application, const string& parameters, string& retMessage)
+bool LDAPBrowser::_exec(const string& application, const string& parameters, string& retMessage, int timeout, const char* folder)
 {
 	bool valid(false);
 
@@ -2527,12 +2949,12 @@ return false;
 	string fullCmd(app);
 	fullCmd += " ";
 	fullCmd += parameters;
-	valid = (TRUE == CreateProcessA(nullptr, (LPSTR)fullCmd.c_str(), nullptr, nullptr, FALSE, NORMAL_PRIORITY_CLASS, nullptr, nullptr, &startupInfo, &pi));
+	valid = (TRUE == CreateProcessA(nullptr, (LPSTR)fullCmd.c_str(), nullptr, nullptr, FALSE, NORMAL_PRIORITY_CLASS, nullptr, (IS_EMPTY(folder) ? nullptr : folder), &startupInfo, &pi));
 
 	if (true == valid) {
-		// On attend sa mort (du moins 5 s)...
+		// On attend sa mort (du moins 5 s par défaut)...
 		DWORD exitCode(0);
-		if (WAIT_OBJECT_0 != (exitCode = WaitForSingleObject(pi.hProcess, 5000))) {
+		if (WAIT_OBJECT_0 != (exitCode = WaitForSingleObject(pi.hProcess, (timeout > 0 ? (DWORD)timeout * 1000 : 5000)))) {
 			// erreur ...
 			retMessage = "Timeout dépassé";
 			valid = false;
@@ -2562,7 +2984,23 @@ return false;
 		retMessage += errStr;
 	}
 #else
-	string cmdLine(application);
+	string cmdLine("");
+
+	// Dossier de travail propre à la commande (le dossier courant est partagé par tous les threads)
+	if (!IS_EMPTY(folder)) {
+		cmdLine = "cd \"";
+		cmdLine += folder;
+		cmdLine += "\" && ";
+	}
+
+	// Durée maximale d'exécution (coreutils)
+	if (timeout > 0) {
+		cmdLine += "timeout ";
+		cmdLine += charUtils::itoa(timeout);
+		cmdLine += " ";
+	}
+
+	cmdLine += application;
 	if (0 != parameters.size()) {
 		cmdLine += " ";
 		cmdLine += parameters;
@@ -2573,34 +3011,53 @@ return false;
 
 	char buffer[1024];
 	string result("");
-	unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmdLine.c_str(), "r"), pclose);
-	if (!pipe) {
+	FILE* pipe(popen(cmdLine.c_str(), "r"));
+	if (nullptr == pipe) {
 		retMessage = "Erreur popen : impossible d'exécuter la commande.";
 	}
 	else {
 		// Récupération du flux de sortie
-		while (fgets(buffer, 1024, pipe.get()) != nullptr) {
+		while (fgets(buffer, 1024, pipe) != nullptr) {
 			result += buffer;
 		}
 
-		// Tout s'est bien déroulé (du moins pas de plantage)
-		// les informations complémentaires sont dans le message de retour qui sera poussé dans les logs
-		retMessage = result;
+		// Le succès dépend du code retour de la commande (scp n'affiche rien lorsque tout va bien)
+		int status(pclose(pipe));
 
+		// Les informations complémentaires sont dans le message de retour qui sera poussé dans les logs
+		retMessage = result;
 		size_t len(retMessage.size());
 		if (len && '\n' == retMessage[len - 1]) {
 			// Retrait du saut de ligne final
-			if ('\n' == retMessage[len - 1]) {
-				retMessage.resize(len - 1);
-			}
+			retMessage.resize(len - 1);
+		}
 
+		if (-1 != status && WIFEXITED(status) && 0 == WEXITSTATUS(status)) {
 			valid = true;
 		}
-		/*
 		else {
+			string error;
+			if (-1 == status || !WIFEXITED(status)) {
+				error = "Erreur lors de l'exécution de l'application";
+			}
+			else {
+				if (timeout > 0 && 124 == WEXITSTATUS(status)) {
+					// Tuée par timeout
+					error = "Timeout dépassé";
+				}
+				else {
+					error = "Erreur lors de l'exécution de l'application. Code retour : ";
+					error += charUtils::itoa(WEXITSTATUS(status));
+				}
+			}
+
+			if (retMessage.size()) {
+				error += " - ";
+				error += retMessage;
+			}
 
+			retMessage = error;
 		}
-		*/
 	}
 #endif // _WIN32
 
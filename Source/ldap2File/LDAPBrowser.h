@@ -34,6 +34,11 @@
 #include "confFile.h"
 #include "agentTree.h"
 #include "outputFile.h"
+#include "runReport.h"
+#include "deliveries.h"
+#include "mailQueue.h"
+
+#include "./CURLTools/FTPClient.h"
 
 #include "LDAPSources.h"
 
@@ -64,6 +69,10 @@ public:
 
 	RET_TYPE browse();
 
+	// Fin d'une analyse : transferts en cours et mails en attente
+	//	retourne false si des mails ont été refusés
+	bool flush();
+
 	// Methodes privees
 protected:
 
@@ -76,6 +85,15 @@ protected:
 	// Création d'un fichier à partir d'un fichier de commandes
 	RET_TYPE _createFile();
 
+	// Création d'un générateur de fichier de sortie
+	outputFile* _newOutputFile(LPOPFI opfi, RET_TYPE& ret);
+
+	// Transfert d'un fichier généré vers toutes les destinations
+	bool _deliver(outputFile* file, OPFI& opfi, deliveries& jobs);
+
+	// Attente de la fin des transferts en arrière-plan
+	void _waitDeliveries();
+
 	// Requetes LDAP
 	bool _getLDAPContainers();
 #ifdef __LDAP_USE_ALLIER_TITLES__
@@ -84,6 +102,25 @@ protected:
 	size_t _simpleLDAPRequest(PCHAR* attributes, commandFile::criterium& sCriterium, const char* searchDN, bool treeSearch, PLDAPControl* serverControls = nullptr, PLDAPControl sortControl = nullptr);
 	bool _getUserGroups(std::string& userDN, size_t colID, const char* gID);
 
+	// Transmission des lignes en attente au fichier de sortie
+	void _writeRows(){
+		if (rows_.size()){
+			runReport::timer writeTimer(report_, runReport::PHASE::WRITE);
+			_count(runReport::COUNTER::ROWS, rows_.size());
+			file_->writeRows(rows_);
+		}
+		rows_.clear();
+	}
+
+	// Rapport d'exécution
+	void _count(runReport::COUNTER counter, size_t value = 1){
+		if (report_){
+			report_->add(counter, value);
+		}
+	}
+	std::string _shortName(commandFile* cmdFile);
+	void _saveReports(commandFile* cmdFile, RET_TYPE ret);
+
 	// Organigramme hiérarchique (ou organisationnel)
 	//
 	void _generateOrgChart(std::string& baseContainer);
@@ -102,19 +139,21 @@ protected:
 	{}
 
 	// Gestion des actions
-	void _handlePostGenActions(OPFI& opfi);
+	void _handlePostGenActions(outputFile* outFile, OPFI& opfi);
 
 	// Envoi du fichier en PJ d'un mail
-	const bool _SMTPTransfer(mailDestination* mailDest);
+	//	les transferts peuvent être exécutés dans des threads distincts (timeout en s, 0 = pas de limite)
+	const bool _SMTPTransfer(outputFile* file, mailDestination* mailDest, int timeout = 0);
 
 	// Transfert par FTP
-	const bool _FTPTransfer(FTPDestination* ftpDest);
+	//	sidecar : extension de la copie complémentaire à transférer à la place du fichier
+	const bool _FTPTransfer(outputFile* file, FTPDestination* ftpDest, int timeout = 0, const char* sidecar = nullptr);
 
 	// Transfert par SCP
-	const bool _SCPTransfer(SCPDestination* scpDest);
+	const bool _SCPTransfer(outputFile* file, SCPDestination* scpDest, int timeout = 0, const char* sidecar = nullptr);
 
 	// Execution d'une application
-	bool _exec(const std::string& application, const std::string& parameters, std::string& retMessage);
+	bool _exec(const std::string& application, const std::string& parameters, std::string& retMessage, int timeout = 0, const char* folder = nullptr);
 
 
 	// Données membres privees
@@ -151,7 +190,21 @@ protected:
 	ORGCHART				orgChart_;			// Organigramme
 
 	outputFile*				file_;				// Fichier à générer
+	outputRows				rows_;				// Lignes en attente d'écriture
 	orgChartFile*			orgFile_;			// Fichier pour l'organigramme
+
+	runReport*				report_;			// Rapport d'exécution (nullptr si non demandé)
+	queryProfiler*			profiler_;			// Profilage des requêtes LDAP (nullptr si non demandé)
+	std::string				prometheus_;		// Dossier des fichiers pour Prometheus
+
+	bool					parallel_;			// Transferts simultanés vers les destinations
+	bool					async_;				// Transferts pendant la génération du fichier suivant
+	deliveries*				pending_;			// Transferts en cours (mode asynchrone)
+
+	mailQueue*				mails_;				// Mails en attente (nullptr si envoi immédiat)
+	size_t					fileID_;			// Identifiant du fichier transmis
+
+	jhbCURLTools::FTPSessionCache	ftpSessions_;	// Sessions FTP conservées entre deux transferts
 };
 
 #endif /* __LDAP_2_FILE_LDAP_BROWSER_h__ */
@@ -34,8 +34,252 @@
 using namespace std;
 
 #include <commonTypes.h>
+#include <charUtils.h>
 
 #include "LDAPServer.h"
+#include "queryProfiler.h"
+
+// Transmission d'une requête exécutée au profileur
+//	le volume est estimé à partir des QUERY_PROFILER_SAMPLE_ENTRIES premières entrées
+//	(somme des tailles des valeurs) pour ne pas relire tout le résultat
+//
+void LDAPServer::_profile(std::chrono::steady_clock::time_point& start, const char* base, ULONG scope, const char* filter, char** attrs, LDAPMessage* result)
+{
+	double duration(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+	size_t entries(0), sampled(0), bytes(0);
+	if (result && connection_) {
+		int count(ldap_count_entries(connection_, result));
+		entries = (count > 0) ? (size_t)count : 0;
+
+		BerElement* ber(nullptr);
+		char* attribute(nullptr);
+		struct berval** values(nullptr);
+		for (LDAPMessage* entry = ldap_first_entry(connection_, result); entry && sampled < QUERY_PROFILER_SAMPLE_ENTRIES; entry = ldap_next_entry(connection_, entry)) {
+			sampled++;
+
+			attribute = ldap_first_attribute(connection_, entry, &ber);
+			while (attribute) {
+				if (nullptr != (values = ldap_get_values_len(connection_, entry, attribute))) {
+					for (size_t index = 0; values[index]; index++) {
+						bytes += values[index]->bv_len;
+					}
+					ldap_value_free_len(values);
+				}
+
+				ldap_memfree(attribute);
+				attribute = ldap_next_attribute(connection_, entry, ber);
+			}
+
+			if (ber) {
+				ber_free(ber, 0);
+				ber = nullptr;
+			}
+		}
+
+		// Extrapolation
+		if (sampled && entries > sampled) {
+			bytes = (size_t)((double)bytes * entries / sampled);
+		}
+	}
+
+	profiler_->add(base, (int)scope, filter, attrs, entries, bytes, duration);
+}
+
+// Requête exécutée
+//	le résultat est transmis au profileur puis éventuellement conservé dans le cache
+//
+void LDAPServer::_searched(string& key, std::chrono::steady_clock::time_point& start, const char* base, ULONG scope, const char* filter, char** attrs, LDAPMessage* result, bool merged)
+{
+	if (profiler_) {
+		_profile(start, base, scope, filter, attrs, result);
+	}
+
+	if (0 == key.size() || nullptr == result || nullptr == connection_) {
+		return;
+	}
+
+	// Le volume conservé est limité
+	size_t entries(ldap_count_entries(connection_, result));
+	if (cacheEntries_ + entries > LDAP_CACHE_MAX_ENTRIES) {
+		return;
+	}
+
+	if (merged) {
+		// Le résultat précédent (moins d'attributs) reste dans cached_ jusqu'au vidage du cache
+		MERGEDRESULT& cached(merged_[key]);
+		cached.attributes_.clear();
+		for (size_t index = 0; attrs && attrs[index]; index++) {
+			cached.attributes_.insert(charUtils::strlwr((const char*)attrs[index]));
+		}
+		cached.result_ = result;
+	}
+	else {
+		cache_[key] = result;
+	}
+
+	cached_.insert(result);
+	cacheEntries_ += entries;
+}
+
+// Clé d'une requête
+//	les noms des attributs sont triés et mis en minuscules, les contrôles (tri) font partie de la clé
+//	lorsque les attributs peuvent être fusionnés, ils ne font pas partie de la clé
+//
+string LDAPServer::_cacheKey(const char* base, ULONG scope, const char* filter, char** attrs, ULONG attrsonly, PLDAPControlA* controls, bool merge)
+{
+	string key(IS_EMPTY(base) ? "" : base);
+	key += "|";
+	key += charUtils::itoa((int)scope);
+	key += "|";
+	key += (IS_EMPTY(filter) ? "" : filter);
+	key += "|";
+	key += (attrsonly ? "1" : "0");
+	key += "|";
+
+	if (merge) {
+		// Attributs fusionnés
+		key += "+";
+	}
+	else if (nullptr == attrs) {
+		// Tous les attributs
+		key += "*";
+	}
+	else {
+		set<string> names;
+		for (size_t index = 0; attrs[index]; index++) {
+			names.insert(charUtils::strlwr((const char*)attrs[index]));
+		}
+
+		for (set<string>::iterator it = names.begin(); it != names.end(); it++) {
+			key += (*it);
+			key += ",";
+		}
+	}
+
+	if (controls) {
+		char hexa[3];
+		for (size_t index = 0; controls[index]; index++) {
+			key += "|";
+			key += (controls[index]->ldctl_oid ? controls[index]->ldctl_oid : "");
+			key += (controls[index]->ldctl_iscritical ? "!" : "");
+			key += ":";
+			for (size_t pos = 0; controls[index]->ldctl_value.bv_val && pos < controls[index]->ldctl_value.bv_len; pos++) {
+				snprintf(hexa, sizeof(hexa), "%02x", (unsigned char)controls[index]->ldctl_value.bv_val[pos]);
+				key += hexa;
+			}
+		}
+	}
+
+	return key;
+}
+
+// Recherche d'un résultat dans le cache
+//
+bool LDAPServer::_fromCache(string& key, PLDAPMessage* res)
+{
+	map<string, LDAPMessage*>::iterator it(cache_.find(key));
+	if (cache_.end() == it || nullptr == res) {
+		return false;
+	}
+
+	*res = it->second;
+	cacheHits_++;
+	return true;
+}
+
+// Recherche d'un résultat dont les attributs sont fusionnés
+//	le résultat doit contenir tous les attributs demandés et les attributs en plus ne doivent pas être réservés
+//
+bool LDAPServer::_fromMerged(string& key, char** attrs, const set<string>& reserved, PLDAPMessage* res)
+{
+	map<string, MERGEDRESULT>::iterator it(merged_.find(key));
+	if (merged_.end() == it || nullptr == res) {
+		return false;
+	}
+
+	set<string> requested;
+	string name("");
+	for (size_t index = 0; attrs[index]; index++) {
+		name = charUtils::strlwr((const char*)attrs[index]);
+		if (it->second.attributes_.end() == it->second.attributes_.find(name)) {
+			return false;
+		}
+
+		requested.insert(name);
+	}
+
+	for (set<string>::iterator attr = it->second.attributes_.begin(); attr != it->second.attributes_.end(); attr++) {
+		if (requested.end() == requested.find(*attr) && reserved.end() != reserved.find(*attr)) {
+			return false;
+		}
+	}
+
+	*res = it->second.result_;
+	cacheHits_++;
+	return true;
+}
+
+// Liste des attributs d'une requête complétée par les attributs non réservés des requêtes identiques
+//	l'union est conservée d'un lot à l'autre (mode démon) : dès le 2nd lot, une seule requête est émise
+//	retourne nullptr s'il n'y a rien à ajouter (le tableau retourné doit être libéré avec delete[])
+//
+char** LDAPServer::_mergeAttributes(string& key, char** attrs, const set<string>& reserved, deque<string>& names)
+{
+	set<string>& plain(plainAttrs_[key]);
+	set<string> requested;
+	string name("");
+	for (size_t index = 0; attrs[index]; index++) {
+		name = charUtils::strlwr((const char*)attrs[index]);
+		requested.insert(name);
+		if (reserved.end() == reserved.find(name)) {
+			plain.insert(name);
+		}
+	}
+
+	for (set<string>::iterator it = plain.begin(); it != plain.end(); it++) {
+		if (requested.end() == requested.find(*it)) {
+			names.push_back(*it);
+		}
+	}
+
+	if (0 == names.size()) {
+		return nullptr;
+	}
+
+	size_t count(0);
+	while (attrs[count]) {
+		count++;
+	}
+
+	char** merged(new char*[count + names.size() + 1]);
+	for (size_t index = 0; index < count; index++) {
+		merged[index] = attrs[index];
+	}
+
+	for (size_t index = 0; index < names.size(); index++) {
+		merged[count + index] = (char*)names[index].c_str();
+	}
+
+	merged[count + names.size()] = nullptr;
+	return merged;
+}
+
+// Vidage du cache
+//
+void LDAPServer::clearCache()
+{
+	for (set<LDAPMessage*>::iterator it = cached_.begin(); it != cached_.end(); it++) {
+		if (*it) {
+			ldap_msgfree(*it);
+		}
+	}
+
+	cached_.clear();
+	cache_.clear();
+	merged_.clear();
+	cacheEntries_ = cacheHits_ = 0;
+}
 
 // La valeur doit-elle être considérée comme vide ?
 //
@@ -48,6 +48,16 @@ typedef unsigned int    UINT;
 
 #include "LDAPAttributes.h"
 
+#include <chrono>
+#include <deque>
+#include <map>
+#include <set>
+
+class queryProfiler;
+
+// Cache des résultats : nombre maximal d'entrées conservées
+#define LDAP_CACHE_MAX_ENTRIES		100000
+
 // Quelques définitions ...
 #define LDAP_DEF_PORT				LDAP_PORT
 
@@ -72,6 +82,7 @@ public:
 	// Constructeur par recopie
 	LDAPServer(const LDAPServer& src){
 		connection_ = src.connection_;
+		lost_ = src.lost_;
 		environment_ = src.environment_;
 		host_ = src.host_;
 		port_ = src.port_;
@@ -80,6 +91,12 @@ public:
 		user_ = src.user_;
 		pwd_ = src.pwd_;
 		mode_ = src.mode_;
+		requests_ = src.requests_;
+		profiler_ = src.profiler_;
+
+		// Le cache n'est pas partagé
+		caching_ = false;
+		cacheEntries_ = cacheHits_ = 0;
 	}
 
 	// Destructeur
@@ -90,6 +107,11 @@ public:
 	// Initialisation
 	void init(LDAP_ACCESS_MODE ldapMode){
 		connection_ = nullptr;
+		lost_ = false;
+		requests_ = 0;
+		profiler_ = nullptr;
+		caching_ = false;
+		cacheEntries_ = cacheHits_ = 0;
 
 		// En mode DEBUG l'application utilise des valeurs par défaut
 		//
@@ -105,7 +127,9 @@ public:
 	}
 
 	// Initialisation de la connexion
+	//	une connexion précédente (perdue) est d'abord libérée
 	LDAP* open() {
+		disConnect();
 		if (host_.size()) {
 			connection_ = ldap_init((char*)host_.c_str(), port_);
 		}
@@ -125,18 +149,22 @@ public:
 #endif // _WIN32
 	}
 
+	// Une connexion perdue (serveur arrêté, réseau) n'est plus considérée comme établie
+	//	=> elle sera rétablie à la prochaine utilisation
 	bool connected()
-	{ return (nullptr != connection_); }
+	{ return (nullptr != connection_ && !lost_); }
 
 	ULONG simpleBindS()
 	{ return (connection_ ? ldap_simple_bind_s(connection_, (char*)user_.c_str(), (char*)pwd_.c_str()): LDAP_PARAM_ERROR); }
 
 	// ... et deconnexion
 	void disConnect(){
+		clearCache();
 		if (connection_){
 			ldap_unbind(connection_);
 			connection_ = nullptr;
 		}
+		lost_ = false;
 	}
 
 	// Message d'erreur
@@ -161,7 +189,7 @@ public:
 	void memFree(char* Block)
 	{ return ldap_memfree(Block); }
 	ULONG msgFree(LDAPMessage *res)
-	{ return ldap_msgfree(res); }
+	{ return (cached_.end() != cached_.find(res) ? LDAP_SUCCESS : ldap_msgfree(res)); }	// Les résultats en cache sont libérés avec le cache
 	void valueFree(char** vals)
 	{ ldap_value_free(vals); }
 	void controlsFree(LDAPControlA **Controls)
@@ -183,17 +211,86 @@ public:
 	{ return (connection_ ? ldap_get_option(connection_, option, outvalue) : LDAP_PARAM_ERROR); }
 
 	// Recherches
+	//	avec un profileur, chaque requête est chronométrée et mesurée
+	//	avec le cache, une requête identique à une requête précédente n'est pas émise
 	ULONG searchS(char* base, ULONG scope, char* filter, char* attrs[], ULONG attrsonly, PLDAPMessage *res)
-	{ return (connection_ ? ldap_search_s(connection_, base, scope, filter, attrs, attrsonly, res) : LDAP_PARAM_ERROR); }
+	{
+		string key(caching_ ? _cacheKey(base, scope, filter, attrs, attrsonly, nullptr, false) : "");
+		if (key.size() && _fromCache(key, res)) {
+			return LDAP_SUCCESS;
+		}
+
+		requests_++;
+		if (nullptr == profiler_ && 0 == key.size()) {
+			return _checkConnection(connection_ ? ldap_search_s(connection_, base, scope, filter, attrs, attrsonly, res) : LDAP_PARAM_ERROR);
+		}
+
+		std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+		ULONG retCode(_checkConnection(connection_ ? ldap_search_s(connection_, base, scope, filter, attrs, attrsonly, res) : LDAP_PARAM_ERROR));
+		_searched(key, start, base, scope, filter, attrs, ((LDAP_SUCCESS == retCode && res) ? *res : nullptr));
+		return retCode;
+	}
+	//
+	//	reserved : attributs (en minuscules) interprétés par l'appelant quelles que soient les colonnes.
+	//	Les autres attributs retournés sans avoir été demandés sont ignorés par l'appelant, la liste des attributs
+	//	peut alors être fusionnée avec celles des requêtes identiques des autres fichiers du lot (autres colonnes)
 #ifdef _WIN32
 	ULONG searchExtS(char* base, ULONG scope, char* filter, char* attrs[], ULONG attrsonly, PLDAPControlA *ServerControls,
-		PLDAPControlA *ClientControls, struct l_timeval *timeout, ULONG SizeLimit, PLDAPMessage *res)
-	{ return (connection_ ? ldap_search_ext_s(connection_, base, scope, filter, attrs, attrsonly, ServerControls, ClientControls, timeout, SizeLimit, res) : LDAP_PARAM_ERROR); }
+		PLDAPControlA *ClientControls, struct l_timeval *timeout, ULONG SizeLimit, PLDAPMessage *res, const set<string>* reserved = nullptr)
 #else
 	ULONG searchExtS(char* base, ULONG scope, char* filter, char* attrs[], ULONG attrsonly, PLDAPControlA *ServerControls,
-		PLDAPControlA *ClientControls, struct timeval *timeout, ULONG SizeLimit, PLDAPMessage *res)
-	{ return (connection_ ? ldap_search_ext_s(connection_, base, scope, filter, attrs, attrsonly, ServerControls, ClientControls, timeout, SizeLimit, res) : LDAP_PARAM_ERROR); }
+		PLDAPControlA *ClientControls, struct timeval *timeout, ULONG SizeLimit, PLDAPMessage *res, const set<string>* reserved = nullptr)
 #endif // _WIN32
+	{
+		bool merge(caching_ && 0 == SizeLimit && nullptr != reserved && nullptr != attrs);
+		string key(caching_ && 0 == SizeLimit ? _cacheKey(base, scope, filter, attrs, attrsonly, ServerControls, merge) : "");
+		if (key.size() && (merge ? _fromMerged(key, attrs, *reserved, res) : _fromCache(key, res))) {
+			return LDAP_SUCCESS;
+		}
+
+		requests_++;
+		if (nullptr == profiler_ && 0 == key.size()) {
+			return _checkConnection(connection_ ? ldap_search_ext_s(connection_, base, scope, filter, attrs, attrsonly, ServerControls, ClientControls, timeout, SizeLimit, res) : LDAP_PARAM_ERROR);
+		}
+
+		// Attributs demandés par les requêtes identiques des autres fichiers
+		deque<string> names;
+		char** merged(merge ? _mergeAttributes(key, attrs, *reserved, names) : nullptr);
+		char** request(merged ? merged : attrs);
+
+		std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+		ULONG retCode(_checkConnection(connection_ ? ldap_search_ext_s(connection_, base, scope, filter, request, attrsonly, ServerControls, ClientControls, timeout, SizeLimit, res) : LDAP_PARAM_ERROR));
+		_searched(key, start, base, scope, filter, request, ((LDAP_SUCCESS == retCode && res) ? *res : nullptr), merge);
+
+		if (merged) {
+			delete[] merged;
+		}
+
+		return retCode;
+	}
+
+	// Nombre de requêtes émises
+	size_t requests()
+	{ return requests_; }
+
+	// Cache des résultats
+	//	les fichiers de commandes d'un même lot partagent les résultats des requêtes identiques
+	void setCache(bool enabled) {
+		if (!enabled) {
+			clearCache();
+			plainAttrs_.clear();
+		}
+		caching_ = enabled;
+	}
+	void clearCache();
+
+	// Requêtes servies par le cache (depuis le dernier vidage)
+	size_t cacheHits()
+	{ return cacheHits_; }
+
+	// Profilage des requêtes (nullptr => pas de mesure)
+	void setProfiler(queryProfiler* profiler)
+	{ profiler_ = profiler; }
 
 	// Gestion des enregistrements
 	ULONG parseResult(LDAPMessage *ResultMessage, ULONG *ReturnCode , char** MatchedDNs, char** ErrorMessage,
@@ -309,7 +406,32 @@ public:
 	string getContainer(string& dn, const char* startsWith = STR_ATTR_UID);
 
 protected:
+
+	// La connexion a-t'elle été perdue ?
+	ULONG _checkConnection(ULONG retCode) {
+		if ((ULONG)LDAP_SERVER_DOWN == retCode || (ULONG)LDAP_CONNECT_ERROR == retCode) {
+			lost_ = true;
+		}
+		return retCode;
+	}
+
+	// Transmission d'une requête exécutée au profileur
+	void _profile(std::chrono::steady_clock::time_point& start, const char* base, ULONG scope, const char* filter, char** attrs, LDAPMessage* result);
+
+	// Requête exécutée => profileur et cache
+	void _searched(string& key, std::chrono::steady_clock::time_point& start, const char* base, ULONG scope, const char* filter, char** attrs, LDAPMessage* result, bool merged = false);
+
+	// Gestion du cache
+	//	merge : les attributs ne font pas partie de la clé
+	string _cacheKey(const char* base, ULONG scope, const char* filter, char** attrs, ULONG attrsonly, PLDAPControlA* controls, bool merge);
+	bool _fromCache(string& key, PLDAPMessage* res);
+
+	// Requêtes dont les attributs sont fusionnés
+	bool _fromMerged(string& key, char** attrs, const set<string>& reserved, PLDAPMessage* res);
+	char** _mergeAttributes(string& key, char** attrs, const set<string>& reserved, deque<string>& names);
+
 	LDAP*				connection_;
+	bool				lost_;			// Connexion perdue
 	LDAP_ACCESS_MODE	mode_;
 
 	string				environment_;
@@ -323,6 +445,25 @@ protected:
 	string				pwd_;
 
 	list<string>		emptyVals_;		// Valeur(s) à ignorer
+
+	size_t				requests_;		// Nombre de requêtes
+	queryProfiler*		profiler_;		// Profilage des requêtes
+
+	// Résultat d'une requête dont les attributs sont fusionnés
+	typedef struct tagMERGEDRESULT
+	{
+		set<string>		attributes_;	// Attributs demandés (en minuscules)
+		LDAPMessage*	result_;
+	}MERGEDRESULT;
+
+	// Cache des résultats
+	bool						caching_;
+	map<string, LDAPMessage*>	cache_;			// Requête normalisée => résultat
+	map<string, MERGEDRESULT>	merged_;		// Requête normalisée (sans les attributs) => résultat
+	map<string, set<string>>	plainAttrs_;	// Requête normalisée (sans les attributs) => attributs non réservés demandés
+	set<LDAPMessage*>			cached_;		// Résultats détenus par le cache
+	size_t						cacheEntries_;	// Nombre d'entrées conservées
+	size_t						cacheHits_;
 };
 
 #endif // _LDAP_2_FILE_LDAPSERVER_h__
@@ -55,12 +55,27 @@ LDIFFile::LDIFFile(const LPOPFI fileInfos, columnList* columns, confFile* parame
 	encoder_.sourceFormat(charUtils::SOURCE_FORMAT::ISO_8859_15);
 #endif // _WIN32
 	eol_ = CHAR_LF;		// pour UNIX
+	fold_ = eol_;
+	fold_ += " ";
+
+	delta_ = hasSnapshot_ = pendingSnapshot_ = false;
+	added_ = modified_ = deleted_ = 0;
 	newFile_ = true;
 
 	shortUsersOU_ = usersOU_ = "";
 	exclusions_.setAllowEmpty(true);
 }
 
+// Destruction
+//
+LDIFFile::~LDIFFile()
+{
+	// Fichier jamais transmis => on conserve l'image précédente
+	if (pendingSnapshot_) {
+		delivered(false);
+	}
+}
+
 // Lecture des paramètres "personnels" dans le fichier de conf
 //
 bool LDIFFile::getOwnParameters()
@@ -155,7 +170,9 @@ bool LDIFFile::getOwnParameters()
 
 		// Ajout à la liste
 		if (value.length()) {
-			mandatories_.push_back(value);
+			if (mandatoriesIndex_.insert(value).second) {
+				mandatories_.push_back(value);
+			}
 		}
 
 		// Valeur suivantee
@@ -203,11 +220,21 @@ bool LDIFFile::getOwnParameters()
 		snode = snode.next_sibling(XML_OWN_LDIF_FUSION_NODE);
 	}
 
+	// Uniquement les modifications ?
+	snode = node.child(XML_OWN_LDIF_DELTA_NODE);
+	if (!IS_EMPTY(snode.name())) {
+		value = snode.first_child().value();
+		delta_ = (XML_YES == value);
+	}
+
 	if (logs_) {
 		logs_->add(logs::TRACE_TYPE::LOG, "LDIF - OU : \'%s\' - %d attribut(s) obligatoire(s)", usersOU_.c_str(), mandatories_.size());
 		logs_->add(logs::TRACE_TYPE::NORMAL, "\t- %d attribut(s) ajouté(s)", add2All_.size());
 		logs_->add(logs::TRACE_TYPE::NORMAL, "\t- %d exclusion(s)", exclusions_.size());
 		logs_->add(logs::TRACE_TYPE::NORMAL, "\t- %d fusion(s)", attributesToSave_.size());
+		if (delta_) {
+			logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Uniquement les modifications");
+		}
 	}
 
 	// Terminé
@@ -227,6 +254,35 @@ bool LDIFFile::initialize()
 		return false;
 	}
 
+	// Mode "delta" => chargement de l'image précédente et création de la nouvelle
+	if (delta_) {
+		folders::folder* pFolder(folders_->find(folders::FOLDER_TYPE::FOLDER_OUTPUTS));
+		if (nullptr == pFolder) {
+			if (logs_) {
+				logs_->add(logs::TRACE_TYPE::ERR, "LDIF - Pas de dossier pour l'image de l'extraction => génération complète");
+			}
+			delta_ = false;
+		}
+		else {
+			snapshotName_ = sFileSystem::merge(pFolder->path(), sFileSystem::split(fileName_));
+			snapshotName_ += LDIF_SNAPSHOT_EXT;
+
+			_loadSnapshot();
+
+			string tempName(snapshotName_);
+			tempName += LDIF_SNAPSHOT_TMP_EXT;
+			newSnapshot_.open(tempName.c_str(), ios_base::out | ios_base::trunc);
+			if (!newSnapshot_.is_open()) {
+				if (logs_) {
+					logs_->add(logs::TRACE_TYPE::ERR, "LDIF - Impossible de créer l'image '%s'", tempName.c_str());
+				}
+				return false;
+			}
+
+			newSnapshot_ << std::hex;
+		}
+	}
+
 	// Entête du fichier
 	//
 	file_ << "# " << eol_;
@@ -246,12 +302,30 @@ bool LDIFFile::initialize()
 	//
 	file_ << eol_;
 
-	// le DN peut-être long ...
-	file_ << _string2LDIF(STR_ATTR_DN_SHORT, usersOU_) << eol_;
+	// La suite passe par le tampon
+	buffer_.clear();
+	buffer_.reserve(LDIF_BUFFER_SIZE + LDIF_BUFFER_SIZE / 4);
 
-	file_ << STR_ATTR_OBJECT_CLASS << LDIF_ATTR_SEP << LDAP_CLASS_TOP << eol_;
-	file_ << STR_ATTR_OBJECT_CLASS << LDIF_ATTR_SEP << LDAP_CLASS_OU << eol_;
-	file_ << STR_ATTR_OU << LDIF_ATTR_SEP << shortUsersOU_ << eol_;
+	if (hasSnapshot_) {
+		// L'OU existe déja
+		return true;
+	}
+
+	// le DN peut-être long ...
+	_line2LDIF(STR_ATTR_DN_SHORT, usersOU_);
+
+	buffer_ += STR_ATTR_OBJECT_CLASS;
+	buffer_ += LDIF_ATTR_SEP;
+	buffer_ += LDAP_CLASS_TOP;
+	buffer_ += eol_;
+	buffer_ += STR_ATTR_OBJECT_CLASS;
+	buffer_ += LDIF_ATTR_SEP;
+	buffer_ += LDAP_CLASS_OU;
+	buffer_ += eol_;
+	buffer_ += STR_ATTR_OU;
+	buffer_ += LDIF_ATTR_SEP;
+	buffer_ += shortUsersOU_;
+	buffer_ += eol_;
 
 	return true;
 }
@@ -274,14 +348,14 @@ bool LDIFFile::saveLine(bool header, LPAGENTINFOS agent)
 		return false;
 	}
 
-	string line(STR_ATTR_UID);
-	line += LDAP_DN_EQUAL;
-	line += (*pAttr->values_.begin());
-	line += LDAP_DN_SEP;
-	line += usersOU_;
-	file_ << eol_ << _string2LDIF(STR_ATTR_DN_SHORT, line) << eol_;
+	dn_ = STR_ATTR_UID;
+	dn_ += LDAP_DN_EQUAL;
+	dn_ += (*pAttr->values_.begin());
+	dn_ += LDAP_DN_SEP;
+	dn_ += usersOU_;
 
 	// D'abord les attributs obligatoires
+	toWrite_.clear();
 	for (deque<string>::iterator i = mandatories_.begin(); i != mandatories_.end(); i++) {
 		if ((*i).size()) {
 			if (nullptr == (pAttr = attributesToSave_.findAttribute((*i)))) {
@@ -292,7 +366,7 @@ bool LDIFFile::saveLine(bool header, LPAGENTINFOS agent)
 			}
 			else {
 				// Enregistrement de l'attribut
-				_attribute2LDIF(pAttr);
+				toWrite_.push_back(pAttr);
 			}
 		}
 	}
@@ -302,10 +376,30 @@ bool LDIFFile::saveLine(bool header, LPAGENTINFOS agent)
 		pAttr = attributesToSave_[index];
 		// L'attribut n'a pas déja été sauvé ...
 		if (pAttr && !_isMandatory(pAttr->name_)) {
-			_attribute2LDIF(pAttr);
+			toWrite_.push_back(pAttr);
 		}
 	}
 
+	if (delta_) {
+		uint64_t hash(_hashRecord());
+		if (hasSnapshot_) {
+			// Uniquement les modifications
+			_delta2LDIF(hash);
+		}
+		else {
+			// Pas d'image précédente => l'objet est complet
+			_entry2LDIF();
+		}
+
+		_snapshot(hash);
+	}
+	else {
+		_entry2LDIF();
+	}
+
+	// Le tampon est-il plein ?
+	_flush();
+
 	// On repart à  "0"
 	_newLine();
 	return true;
@@ -320,7 +414,7 @@ bool LDIFFile::addAt(size_t colIndex, string& value)
 	}
 
 	// Le nom de la colonne ie. le nom "destination" LDAP
-	string name = currentAttribute_->colName_;
+	string& name(currentAttribute_->colName_);
 
 	// Pouvons-nous ajouter cet attribut avec cette valeur ?
 	if (nullptr != exclusions_.findAttribute(name, value)) {
@@ -348,7 +442,7 @@ bool LDIFFile::addAt(size_t colIndex, deque<string>& values)
 		return false;
 	}
 
-	string name = currentAttribute_->colName_;
+	string& name(currentAttribute_->colName_);
 
 	// Recherche de l'attribut
 	LDAPATTRIBUTE* pAttr(attributesToSave_.findAttribute(name));
@@ -419,6 +513,27 @@ bool LDIFFile::close()
 {
 	bool writen(true);
 
+	// Mode "delta" => les objets qui n'existent plus
+	if (delta_ && hasSnapshot_) {
+		for (unordered_map<string, LDIFSNAPSHOT>::iterator it = snapshot_.begin(); it != snapshot_.end(); it++) {
+			if (false == it->second.seen_) {
+				buffer_ += eol_;
+				_line2LDIF(STR_ATTR_DN_SHORT, it->first);
+				_changeType2LDIF(LDIF_CHANGETYPE_DELETE);
+				deleted_++;
+
+				_flush();
+			}
+		}
+
+		if (logs_) {
+			logs_->add(logs::TRACE_TYPE::LOG, "LDIF - Modifications : %d ajout(s), %d modification(s), %d suppression(s)", added_, modified_, deleted_);
+		}
+	}
+
+	// Ce qui reste dans le tampon
+	_flush(true);
+
 	if (file_.fail()){
 		if (logs_){
 			logs_->add(logs::TRACE_TYPE::ERR, "Erreur lors de l'écriture dans le fichier");
@@ -427,13 +542,59 @@ bool LDIFFile::close()
 			writen = false;
 	}
 
-	// Fermeture du fichier
-	_close();
+	// Fermeture du fichier (et fin du flux compressé)
+	if (!_close()) {
+		writen = false;
+	}
+
+	// La nouvelle image ne remplacera la précédente qu'une fois le fichier transmis
+	//	sinon le prochain delta serait calculé par rapport à un état jamais reçu
+	if (newSnapshot_.is_open()) {
+		newSnapshot_.close();
+
+		if (writen && !newSnapshot_.fail()) {
+			pendingSnapshot_ = true;
+		}
+		else {
+			// On conserve l'image précédente
+			string tempName(snapshotName_);
+			tempName += LDIF_SNAPSHOT_TMP_EXT;
+			sFileSystem::remove(tempName);
+		}
+	}
 
 	// Ok
 	return writen;
 }
 
+// Fin des transferts
+//
+void LDIFFile::delivered(bool success)
+{
+	if (!pendingSnapshot_) {
+		return;
+	}
+
+	pendingSnapshot_ = false;
+
+	string tempName(snapshotName_);
+	tempName += LDIF_SNAPSHOT_TMP_EXT;
+	if (success) {
+		// La nouvelle image remplace la précédente
+		sFileSystem::remove(snapshotName_);
+		if (0 != std::rename(tempName.c_str(), snapshotName_.c_str()) && logs_) {
+			logs_->add(logs::TRACE_TYPE::ERR, "LDIF - Impossible de renommer l'image '%s'", tempName.c_str());
+		}
+	}
+	else {
+		// On conserve l'image précédente
+		sFileSystem::remove(tempName);
+		if (logs_) {
+			logs_->add(logs::TRACE_TYPE::LOG, "LDIF - Fichier non transmis, l'image précédente est conservée");
+		}
+	}
+}
+
 //
 // Méthodes privées
 //
@@ -442,17 +603,7 @@ bool LDIFFile::close()
 //
 bool LDIFFile::_isMandatory(string& name)
 {
-	if (name.length()) {
-		for (deque<string>::iterator i = mandatories_.begin(); i != mandatories_.end(); i++) {
-			if ((*i) == name) {
-				// Dans la liste !
-				return true;
-			}
-		}
-	}
-
-	// Non ...
-	return false;
+	return (name.length() && mandatoriesIndex_.end() != mandatoriesIndex_.find(name));
 }
 
 // Sauvegarde d'un attribut avec toutes ses valeurs
@@ -472,84 +623,285 @@ void LDIFFile::_attribute2LDIF(LDAPATTRIBUTE* attribute)
 	string line;
 #endif // _DEBUG
 
+	// Nom de sortie
+	const string& name(attribute->outputName_.length() ? attribute->outputName_ : attribute->name_);
+
 	// Toutes ses valeurs
-	string value;
 	for (list<string>::iterator i = attribute->values_.begin(); i != attribute->values_.end(); i++) {
 		if ((*i).size()) {
 			// Génération d'une ligne au format LDIF en clair ou de plusieurs ligne et en b64 si nécessaire
-			file_ << _string2LDIF(attribute->name().c_str(), (*i).c_str()) << eol_;
+			_line2LDIF(name, (*i));
 		}
 	}
 }
 
-// Formatage d'une chaine pour LDIF (UTF8 + Base64 si nécessaire) + découpage multi-ligne
-//		La chaine générée est au format [key][affectation][valeur encodée]
+// Sauvegarde de l'objet courant (complet)
 //
-string LDIFFile::_string2LDIF(string& key, string& source)
+void LDIFFile::_entry2LDIF(const char* changeType)
 {
-	// Les chaines sont non-vides, le test a été effectué en amont
-	string value(source);
+	buffer_ += eol_;
+	_line2LDIF(STR_ATTR_DN_SHORT, dn_);
+
+	if (!IS_EMPTY(changeType)) {
+		_changeType2LDIF(changeType);
+	}
+
+	for (deque<LDAPATTRIBUTE*>::iterator it = toWrite_.begin(); it != toWrite_.end(); it++) {
+		_attribute2LDIF(*it);
+	}
+}
+
+// Mode "delta" - Chargement de l'image précédente
+//
+bool LDIFFile::_loadSnapshot()
+{
+	snapshot_.clear();
+	hasSnapshot_ = false;
+
+	ifstream file(snapshotName_.c_str());
+	if (!file.is_open()) {
+		// Première extraction
+		if (logs_) {
+			logs_->add(logs::TRACE_TYPE::NORMAL, "LDIF - Pas d'image précédente => génération complète");
+		}
+		return false;
+	}
+
+	string line("");
+	size_t sep(0), next(0);
+	while (getline(file, line)) {
+		// [dn]\t[empreinte]\t[attributs]
+		if (line.npos == (sep = line.find(LDIF_SNAPSHOT_SEP)) || 0 == sep) {
+			continue;
+		}
+
+		LDIFSNAPSHOT& entry = snapshot_[line.substr(0, sep)];
+		entry.hash_ = strtoull(line.c_str() + sep + 1, nullptr, 16);
+		entry.seen_ = false;
+		if (line.npos == (next = line.find(LDIF_SNAPSHOT_SEP, sep + 1))) {
+			entry.attributes_ = "";
+		}
+		else {
+			entry.attributes_ = line.substr(next + 1);
+		}
+	}
+
+	if (logs_) {
+		logs_->add(logs::TRACE_TYPE::NORMAL, "LDIF - Image précédente : %d objet(s)", snapshot_.size());
+	}
+
+	// Ok
+	return (hasSnapshot_ = true);
+}
+
+// Mode "delta" - Regroupement des attributs de l'objet courant (par nom de sortie) et calcul de son empreinte
+//		Les empreintes ne dépendent pas de l'ordre des valeurs ni de celui des attributs
+//
+uint64_t LDIFFile::_hashRecord()
+{
+	record_.clear();
+	recordIndex_.clear();
+
+	LDAPATTRIBUTE* pAttr(nullptr);
+	LDIFRECORDATTR* pRecord(nullptr);
+	unordered_map<string, size_t>::iterator found;
+	for (deque<LDAPATTRIBUTE*>::iterator it = toWrite_.begin(); it != toWrite_.end(); it++) {
+		pAttr = (*it);
+		const string& name(pAttr->outputName_.length() ? pAttr->outputName_ : pAttr->name_);
+
+		pRecord = nullptr;
+		for (list<string>::iterator value = pAttr->values_.begin(); value != pAttr->values_.end(); value++) {
+			if ((*value).size()) {
+				if (nullptr == pRecord) {
+					if (recordIndex_.end() == (found = recordIndex_.find(name))) {
+						// Nouvel attribut
+						recordIndex_[name] = record_.size();
+						record_.push_back(LDIFRECORDATTR());
+						pRecord = &record_.back();
+						pRecord->name_ = &name;
+						pRecord->hash_ = 0;
+					}
+					else {
+						pRecord = &record_[found->second];
+					}
+				}
+
+				pRecord->values_.push_back(&(*value));
+				pRecord->hash_ += _mix(_hash((*value).c_str(), (*value).size()));
+			}
+		}
+	}
+
+	uint64_t hash(0);
+	for (deque<LDIFRECORDATTR>::iterator it = record_.begin(); it != record_.end(); it++) {
+		hash += _mix(_hash(it->name_->c_str(), it->name_->size()) ^ it->hash_);
+	}
+
+	return hash;
+}
+
+// Mode "delta" - Ajout de l'objet courant à la nouvelle image
+//
+void LDIFFile::_snapshot(uint64_t hash)
+{
+	newSnapshot_ << dn_ << LDIF_SNAPSHOT_SEP << hash;
+	for (deque<LDIFRECORDATTR>::iterator it = record_.begin(); it != record_.end(); it++) {
+		newSnapshot_ << LDIF_SNAPSHOT_SEP << *(it->name_) << LDIF_SNAPSHOT_HASH_SEP << it->hash_;
+	}
+	newSnapshot_ << '\n';
+}
+
+// Mode "delta" - Modifications de l'objet courant par rapport à l'image précédente
+//
+void LDIFFile::_delta2LDIF(uint64_t hash)
+{
+	unordered_map<string, LDIFSNAPSHOT>::iterator previous = snapshot_.find(dn_);
+	if (snapshot_.end() == previous) {
+		// Nouvel objet
+		_entry2LDIF(LDIF_CHANGETYPE_ADD);
+		added_++;
+		return;
+	}
+
+	previous->second.seen_ = true;
+	if (previous->second.hash_ == hash) {
+		// Pas de changement
+		return;
+	}
+
+	// Les attributs précédents : [nom]=[empreinte]\t...
+	deque<pair<string, uint64_t>> attributes;
+	string& source(previous->second.attributes_);
+	size_t from(0), sep(0), to(0);
+	while (from < source.size()) {
+		if (source.npos == (to = source.find(LDIF_SNAPSHOT_SEP, from))) {
+			to = source.size();
+		}
+
+		if (source.npos != (sep = source.find(LDIF_SNAPSHOT_HASH_SEP, from)) && sep < to) {
+			attributes.push_back(pair<string, uint64_t>(source.substr(from, sep - from), strtoull(source.c_str() + sep + 1, nullptr, 16)));
+		}
+
+		from = to + 1;
+	}
+
+	buffer_ += eol_;
+	_line2LDIF(STR_ATTR_DN_SHORT, dn_);
+	_changeType2LDIF(LDIF_CHANGETYPE_MODIFY);
+
+	// Attributs ajoutés ou modifiés
+	deque<pair<string, uint64_t>>::iterator old;
+	for (deque<LDIFRECORDATTR>::iterator it = record_.begin(); it != record_.end(); it++) {
+		for (old = attributes.begin(); old != attributes.end() && old->first != *(it->name_); old++);
+
+		if (attributes.end() == old) {
+			_modification2LDIF(LDIF_MOD_ADD, *(it->name_), &(*it));
+		}
+		else {
+			if (old->second != it->hash_) {
+				_modification2LDIF(LDIF_MOD_REPLACE, *(it->name_), &(*it));
+			}
+
+			attributes.erase(old);
+		}
+	}
+
+	// Attributs supprimés
+	for (old = attributes.begin(); old != attributes.end(); old++) {
+		_modification2LDIF(LDIF_MOD_DELETE, old->first);
+	}
+
+	modified_++;
+}
+
+// Mode "delta" - Une modification d'attribut
+//
+void LDIFFile::_modification2LDIF(const char* type, const string& name, LDIFRECORDATTR* attribute)
+{
+	buffer_ += type;
+	buffer_ += LDIF_ATTR_SEP;
+	buffer_ += name;
+	buffer_ += eol_;
+
+	if (attribute) {
+		for (deque<const string*>::iterator it = attribute->values_.begin(); it != attribute->values_.end(); it++) {
+			_line2LDIF(name, *(*it));
+		}
+	}
+
+	buffer_ += LDIF_MOD_END;
+	buffer_ += eol_;
+}
+
+// Ecriture d'une ligne au format LDIF (UTF8 + Base64 si nécessaire) + découpage multi-ligne
+//		La ligne générée est au format [key][affectation][valeur encodée]
+//		Tout est copié en une seule passe dans le tampon d'écriture
+//
+void LDIFFile::_line2LDIF(const string& key, const char* source, size_t len)
+{
+	const char* value(source);
 	bool b64(false);	        // encodage base64 ?
 #ifdef _WIN32
-	value = encoder_.toUTF8(value);
+	encoder_.toUTF8(utf8_, source, len);
 
     // L'encodage a t'il "agrandi" la chaine ?
     // (ie y a t'il des caractères accentués ? )
     //      oui => il faut l'encoder en Base64
-	b64 = (value.size() > source.size());
+	b64 = (utf8_.size() > len);
+	value = utf8_.c_str();
+	len = utf8_.size();
 #else
     // On encode en Base64 ce qui est "vraiment" de l'UTF8
-    b64 = !charUtils::isPureASCII(source);
+    b64 = !charUtils::isPureASCII(source, len);
 #endif // _WIN32
 
-    if (b64){
-        // Oui => encodage en base64
-		value = encoder_.toBase64(value);
-    }
-
-	// Chaine "totale"
-	string out(key);
+	// La clé et le séparateur
+	size_t col(0);
+	const char* sep(b64 ? LDIF_ATTR_ENCODED_SEP : LDIF_ATTR_SEP);
+	_append2LDIF(key.c_str(), key.size(), col);
+	_append2LDIF(sep, strlen(sep), col);
 
-	// Longueur de la chaine (on commence en supposant que la chaine sera courte)
-	size_t sLen = key.length() + strlen(LDIF_ATTR_SEP) + value.length();
-
-	// Si la chaine est-elle plus longue qu'une ligne ou encodée en base64 ?
-	if (true == b64 || sLen > LDIF_LINE_LENGTH) {
-		// Oui
-		out += LDIF_ATTR_ENCODED_SEP;	// Séparateur spécifique
-		out += value;					// ajout de la valeur
-
-		// Puis découpage (éventuel ...)
-		out = encoder_.splitLine(out, LDIF_LINE_LENGTH);
+	if (b64 && col < LDIF_LINE_LENGTH) {
+		// Le découpage des lignes se fait pendant l'encodage
+		charUtils::appendBase64(buffer_, (const unsigned char*)value, len, LDIF_LINE_LENGTH - col, LDIF_LINE_LENGTH - 1, fold_.c_str());
 	}
 	else {
-		out += LDIF_ATTR_SEP;
-		out += value;
+		if (b64) {
+			// La clé occupe déja toute la ligne ...
+			b64_.clear();
+			charUtils::appendBase64(b64_, (const unsigned char*)value, len);
+			value = b64_.c_str();
+			len = b64_.size();
+		}
+
+		_append2LDIF(value, len, col);
 	}
 
-	// Fin
-	return out;
+	buffer_ += eol_;
 }
 
+// Copie dans le tampon avec découpage des lignes trop longues
 //
-// LDIFFile::tagLDAPATTRIBUTE
-//
-
-// Recherche d'une valeur
-//
-bool LDIFFile::tagLDAPATTRIBUTE::exists(string& attrValue)
+void LDIFFile::_append2LDIF(const char* source, size_t len, size_t& col)
 {
-	if (attrValue.size())
-	{
-		for (list<string>::iterator it = values_.begin(); it != values_.end(); it++) {
-			if ((*it) == attrValue) {
-				return true;
-			}
+	size_t count(0);
+	while (len) {
+		if (col >= LDIF_LINE_LENGTH) {
+			// Nouvelle ligne (qui commence par un espace)
+			buffer_ += fold_;
+			col = 1;
+		}
+
+		count = LDIF_LINE_LENGTH - col;
+		if (count > len) {
+			count = len;
 		}
-	}
 
-	// Non trouvé
-	return false;
+		buffer_.append(source, count);
+		source += count;
+		len -= count;
+		col += count;
+	}
 }
 
 //
@@ -569,6 +921,7 @@ LDIFFile::LDIFUserDatas::~LDIFUserDatas()
 
 	// Liste vide
 	attributes_.clear();
+	index_.clear();
 }
 
 // Transfert du contenu dans un autre objet
@@ -600,12 +953,10 @@ void LDIFFile::LDIFUserDatas::clean()
 LDIFFile::LDAPATTRIBUTE* LDIFFile::LDIFUserDatas::findAttribute(string& attrName)
 {
 	if (attrName.length()) {
-		LDAPATTRIBUTE* pAttribute(nullptr);
-		for (deque<LDAPATTRIBUTE*>::iterator it = attributes_.begin(); it != attributes_.end(); it++) {
-			if (nullptr != (pAttribute = (*it)) && (*it)->name_ == attrName) {
-				// Trouvé !
-				return (*it);
-			}
+		unordered_map<string, size_t>::iterator it = index_.find(attrName);
+		if (index_.end() != it) {
+			// Trouvé !
+			return attributes_[it->second];
 		}
 	}
 
@@ -641,20 +992,16 @@ LDIFFile::LDAPATTRIBUTE* LDIFFile::LDIFUserDatas::add(LDIFFile::LDAPATTRIBUTE* a
 	LDAPATTRIBUTE* pCurrent = findAttribute(attr->name_);
 	if (nullptr == pCurrent) {
 		// L'attribut n'existe pas => on insère une copie
-		if (nullptr != (pCurrent = new LDAPATTRIBUTE(*attr))) {
-			// Crée => on ajoute la copie
-			attributes_.push_back(pCurrent);
-		}
+		// Crée => on ajoute la copie
+		pCurrent = _append(new LDAPATTRIBUTE(*attr));
 	}
 	else {
-		// L'attribut existe déja, je lui ajoute les valeurs
+		// L'attribut existe déja, je lui ajoute les valeurs (sans doublons)
 		for (list<string>::iterator it = attr->values_.begin(); it != attr->values_.end(); it++) {
 			if ((*it).size()) {
-				pCurrent->values_.push_back(*it);
+				pCurrent->add(*it);
 			}
 		}
-
-		pCurrent->values_.unique();	// Pas de doublons
 	}
 
 	// Ok
@@ -681,8 +1028,7 @@ LDIFFile::LDAPATTRIBUTE* LDIFFile::LDIFUserDatas::newAttribute(string& attrName,
 	}
 	else {
 		// Création d'un nouvel attribut
-		pAttr = new tagLDAPATTRIBUTE(attrName, attrValue);
-		attributes_.push_back(pAttr);
+		pAttr = _append(new tagLDAPATTRIBUTE(attrName, attrValue));
 	}
 
 	return pAttr;
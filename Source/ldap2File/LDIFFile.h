@@ -40,6 +40,8 @@
 #define __LDAP_2_FILE_LDIF_OUTPUT_FILE_h__  1
 
 #include "textFile.h"
+#include <unordered_map>
+#include <unordered_set>
 
 //----------------------------------------------------------------------
 //--
@@ -47,6 +49,20 @@
 //--
 //----------------------------------------------------------------------
 
+// Taille du tampon d'criture (vid dans le fichier ds qu'elle est atteinte)
+#define LDIF_BUFFER_SIZE			65536
+
+// Mode "delta" - Image de l'extraction prcdente
+//		une ligne par objet : [dn]\t[empreinte]\t[attribut]=[empreinte]\t...
+#define LDIF_SNAPSHOT_EXT			".snapshot"
+#define LDIF_SNAPSHOT_TMP_EXT		".tmp"
+#define LDIF_SNAPSHOT_SEP			'\t'
+#define LDIF_SNAPSHOT_HASH_SEP		'='
+
+// Empreintes (FNV-1a 64 bits)
+#define LDIF_HASH_SEED				14695981039346656037ULL
+#define LDIF_HASH_PRIME				1099511628211ULL
+
 
 //----------------------------------------------------------------------
 //--
@@ -64,7 +80,7 @@ public:
 	LDIFFile(const LPOPFI fileInfos, columnList* columns, confFile* parameters);
 
 	// Destruction
-	virtual ~LDIFFile() {}
+	virtual ~LDIFFile();
 
 	// Initilialisation du fichier
 	virtual bool initialize();
@@ -75,6 +91,11 @@ public:
 	// Enregistrement de la ligne courante
 	virtual bool saveLine(bool header = false, LPAGENTINFOS agent = NULL);
 
+	// Lot de lignes
+	//	addAt et replaceAt ne modifient pas les valeurs reues => elles sont lues dans le lot
+	virtual size_t writeRows(outputRows& rows)
+	{ return _writeRows(rows, false); }
+
 	// Ajout d'une valeur (avec changement de colonne)
 	virtual bool add(string& value)
 	{ return false; }
@@ -94,6 +115,10 @@ public:
 	// Sauvegarde / fermeture
 	virtual bool close();
 
+	// Fin des transferts
+	//	la nouvelle image ne remplace la prcdente que si le fichier a t transmis
+	virtual void delivered(bool success);
+
 	// Mthodes prives
 	//
 private:
@@ -105,7 +130,7 @@ private:
 		tagLDAPATTRIBUTE(string& attrName, string& attrValue){
 			name_ = attrName;
 			outputName_ = "";
-			values_.push_back(attrValue);
+			add(attrValue);
 		}
 
 		tagLDAPATTRIBUTE(tagLDAPATTRIBUTE& other) {
@@ -113,7 +138,7 @@ private:
 
 			for (list<string>::iterator it = other.values_.begin(); it != other.values_.end(); it++) {
 				if ((*it).size()) {
-					values_.push_back(*it);
+					add(*it);
 				}
 			}
 		}
@@ -126,11 +151,12 @@ private:
 		{ return outputName_.length() ? outputName_ : name_; }
 
 		// Recherche d'une valeur
-		bool exists(string& attrValue);
+		bool exists(string& attrValue)
+		{ return (attrValue.size() && index_.end() != index_.find(attrValue)); }
 
 		// Ajout dune valeur
 		void add(string& value) {
-			if (!exists(value)) {
+			if (0 == value.size() || index_.insert(value).second) {
 				// Pas dja en mmoire ...
 				values_.push_back(value);
 			}
@@ -139,6 +165,7 @@ private:
 		// Nettoyage (ie. suppression de toutes les valeurs)
 		void clean() {
 			values_.clear();
+			index_.clear();
 		}
 
 		// Nombre d'lments
@@ -149,6 +176,7 @@ private:
 		string			name_;			// Nom de l'attribut
 		string			outputName_;	// Nom de sortie (permet de fusionner les attributs)
 		list<string>	values_;		// Les valeurs ( priori non vides)
+		unordered_set<string>	index_;	// Recherche rapide des doublons
 	}LDAPATTRIBUTE;
 
 	// Toutes les informations d'un agent (ie. une "ligne" dans la logique fichier plat / CSV)
@@ -229,8 +257,18 @@ private:
 		LDAPATTRIBUTE* operator [](size_t index);
 
 	protected:
+		// Ajout d'un attribut en fin de liste (et dans l'index)
+		LDAPATTRIBUTE* _append(LDAPATTRIBUTE* attr) {
+			if (nullptr != attr) {
+				index_[attr->name_] = attributes_.size();
+				attributes_.push_back(attr);
+			}
+			return attr;
+		}
+
 		bool					allowEmpty_;		// Autorisation de cration d'un attribut sans valeur
 		deque<LDAPATTRIBUTE*>	attributes_;		// Liste des attributs
+		unordered_map<string, size_t>	index_;		// Nom de l'attribut => position dans la liste
 	};
 
 	// Nouvelle ligne vierge
@@ -251,23 +289,81 @@ private:
 	// Sauvegarde d'un attribut avec toutes ses valeurs
 	void _attribute2LDIF(LDAPATTRIBUTE*);
 
-	// Formatage d'une chaine pour LDIF (UTF8 + Base64 si ncessaire) + dcoupage multi-ligne
-	//		La chaine gnre est au format [key][affectation][valeur encode]
-	string _string2LDIF(const char* key, const char* source){
-        if (IS_EMPTY(key)) {
-			return "";
+	// Sauvegarde de l'objet courant (complet)
+	void _entry2LDIF(const char* changeType = nullptr);
+
+	// Type de modification
+	void _changeType2LDIF(const char* changeType) {
+		buffer_ += LDIF_CHANGETYPE;
+		buffer_ += LDIF_ATTR_SEP;
+		buffer_ += changeType;
+		buffer_ += eol_;
+	}
+
+	// Mode "delta"
+	//
+
+	// Un objet de l'extraction prcdente
+	typedef struct tagLDIFSNAPSHOT
+	{
+		uint64_t		hash_;			// Empreinte de l'objet
+		string			attributes_;	// Empreintes de ses attributs (telles que lues dans le fichier)
+		bool			seen_;			// Prsent dans l'extraction courante ?
+	}LDIFSNAPSHOT;
+
+	// Un attribut de l'objet courant (avec les valeurs des attributs fusionns)
+	typedef struct tagLDIFRECORDATTR
+	{
+		const string*			name_;		// Nom de sortie
+		deque<const string*>	values_;	// Ses valeurs
+		uint64_t				hash_;		// Empreinte des valeurs
+	}LDIFRECORDATTR;
+
+	// Chargement de l'image prcdente
+	bool _loadSnapshot();
+
+	// Regroupement des attributs de l'objet courant et calcul de son empreinte
+	uint64_t _hashRecord();
+
+	// Ajout de l'objet courant  la nouvelle image
+	void _snapshot(uint64_t hash);
+
+	// Modifications de l'objet courant par rapport  l'image prcdente
+	void _delta2LDIF(uint64_t hash);
+
+	// Une modification d'attribut
+	void _modification2LDIF(const char* type, const string& name, LDIFRECORDATTR* attribute = nullptr);
+
+	// Empreintes
+	static uint64_t _hash(const char* data, size_t len, uint64_t hash = LDIF_HASH_SEED) {
+		for (size_t index = 0; index < len; index++) {
+			hash ^= (unsigned char)data[index];
+			hash *= LDIF_HASH_PRIME;
 		}
-		string sKey(key);
-		string sSource(IS_EMPTY(source)?"":source);
-		return _string2LDIF(sKey, sSource);
+		return hash;
+	}
+	static uint64_t _mix(uint64_t value) {
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+		return value ^ (value >> 31);
 	}
-	string _string2LDIF(string& key, string& source);
-	string _string2LDIF(const char* key, string& source) {
-		if (IS_EMPTY(key)) {
-			return "";
+
+	// Ecriture d'une ligne au format LDIF (UTF8 + Base64 si ncessaire) + dcoupage multi-ligne
+	//		La ligne gnre est au format [key][affectation][valeur encode]
+	void _line2LDIF(const string& key, const char* source, size_t len);
+	void _line2LDIF(const string& key, const string& source)
+	{ _line2LDIF(key, source.c_str(), source.size()); }
+
+	// Copie dans le tampon avec dcoupage des lignes trop longues
+	//	col : nombre de caractres dja prsents sur la ligne courante
+	void _append2LDIF(const char* source, size_t len, size_t& col);
+
+	// Ecriture du tampon dans le fichier
+	void _flush(bool force = false) {
+		if (buffer_.size() && (force || buffer_.size() >= LDIF_BUFFER_SIZE)) {
+			file_.write(buffer_.c_str(), buffer_.size());
+			buffer_.clear();
 		}
-		string val(key);
-		return _string2LDIF(val, source);
 	}
 
 
@@ -276,6 +372,14 @@ private:
 private:
 	charUtils					encoder_;			// Gestion de l'encodage des caractres
 
+	string						buffer_;			// Tampon d'criture
+	string						fold_;				// Dcoupage d'une ligne ([eol][espace])
+	string						dn_;				// DN de l'objet courant
+	string						b64_;				// Valeur encode en base 64 (cl trop longue)
+#ifdef _WIN32
+	string						utf8_;				// Valeur convertie en UTF8
+#endif // _WIN32
+
 	LDIFUserDatas				attributesToSave_;	// Attributs  sauvegarder
 
 	// Dans le fichier XML ...
@@ -285,8 +389,22 @@ private:
 
 	LDIFUserDatas				add2All_;			// Attributs ajouts  tous les objets
 	deque<string>				mandatories_;		// Attributs obligatoires
+	unordered_set<string>		mandatoriesIndex_;	// ... pour la recherche
 	LDIFUserDatas				exclusions_;		// Valeurs d'attribut  ne pas copier
 
+	deque<LDAPATTRIBUTE*>		toWrite_;			// Attributs de l'objet courant (dans l'ordre d'criture)
+
+	// Mode "delta"
+	bool						delta_;				// Uniquement les modifications ?
+	bool						hasSnapshot_;		// Une image prcdente a t charge
+	string						snapshotName_;		// Fichier image
+	ofstream					newSnapshot_;		// Nouvelle image (en cours d'criture)
+	bool						pendingSnapshot_;	// Nouvelle image en attente de la fin des transferts
+	unordered_map<string, LDIFSNAPSHOT>	snapshot_;	// Image prcdente indexe par DN
+	deque<LDIFRECORDATTR>		record_;			// Attributs regroups de l'objet courant
+	unordered_map<string, size_t>	recordIndex_;	// Nom de sortie => position dans record_
+	size_t						added_, modified_, deleted_;
+
 	bool						newFile_;
 };
 
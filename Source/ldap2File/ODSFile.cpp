@@ -31,6 +31,9 @@
 
 #include "sFileSystem.h"
 
+#include <fstream>
+#include <thread>
+
 //----------------------------------------------------------------------
 //--
 //-- Constantes privées
@@ -44,6 +47,12 @@
 #endif // __USE_CMD_LINE_ZIP__
 #endif // _WIN32
 
+// Emplacement des onglets dans le fichier de contenu
+#define ODS_SHEETS_ANCHOR		"ldap2File-sheets"
+
+// Profondeur d'un onglet dans le fichier de contenu (document-content/body/spreadsheet/table)
+#define ODS_SHEET_DEPTH			3
+
 //----------------------------------------------------------------------
 //--
 //-- Implémentation de la classe zipFile
@@ -280,7 +289,13 @@ bool ODSFile::zipFile::addFile(const string& srcFile, const string& destName)
 #else
 	//ZipArchiveEntry::Ptr newEntry(file_->CreateEntry(srcFile));
 	try {
-		ZipFile::AddFile(srcPath_, srcFile, destName);
+		// Le fichier de contenu peut être volumineux => compression sur plusieurs threads
+		if (parallel_) {
+			ZipFile::AddFile(srcPath_, srcFile, destName, DeflateMtMethod::Create());
+		}
+		else {
+			ZipFile::AddFile(srcPath_, srcFile, destName);
+		}
 	}
 	catch (...) {
 		// Une erreur ...
@@ -321,6 +336,26 @@ bool ODSFile::zipFile::removeFile(const string& entryName)
 	return (-1 == findFile(entryName.c_str()));
 }
 
+//----------------------------------------------------------------------
+//--
+//-- Implémentation de la classe sheetFragment
+//--
+//----------------------------------------------------------------------
+
+// Sérialisation de l'onglet dans un thread
+//
+void ODSFile::sheetFragment::serialize(bool indentXML)
+{
+	worker_ = std::async(std::launch::async, [this, indentXML]() {
+		std::ostringstream out;
+		doc_.first_child().print(out, PUGIXML_TEXT("\t"), (indentXML ? pugi::format_default : pugi::format_raw), pugi::encoding_utf8, ODS_SHEET_DEPTH);
+		content_ = out.str();
+
+		// Le DOM n'est plus utile
+		doc_.reset();
+	});
+}
+
 //----------------------------------------------------------------------
 //--
 //-- Implémentation de la classe ODSFile
@@ -337,9 +372,17 @@ ODSFile::ODSFile(const LPOPFI fileInfos, columnList* columns, confFile* paramete
 	defaultContentFileName(contentFile_, false);
 	lineIndex_ = 0;
 	alternateRowCol_ = false;
+	photoServer_ = nullptr;
 	contentIndex_ = -1;
 	tempFolder_ = "";
 
+	// Sérialisation des onglets
+	pendingSheet_ = 0;
+	maxWorkers_ = std::thread::hardware_concurrency();
+	if (0 == maxWorkers_) {
+		maxWorkers_ = 1;
+	}
+
 #ifdef __USE_CMD_LINE_ZIP__
 	// zipAlias_ = unzipAlias_ = nullptr;
 #endif // __USE_CMD_LINE_ZIP__
@@ -349,7 +392,52 @@ ODSFile::ODSFile(const LPOPFI fileInfos, columnList* columns, confFile* paramete
 // Destruction
 //
 ODSFile::~ODSFile()
-{}
+{
+	_releaseSheets();
+}
+
+// Lecture des paramètres "personnels" dans le fichier de conf
+//
+bool ODSFile::getOwnParameters()
+{
+	pugi::xml_document* xmlDocument(configurationFile_->cmdFile()->document());
+	pugi::xml_node* xmlFileRoot(configurationFile_->cmdFile()->paramsRoot());
+	if (!xmlDocument || !xmlFileRoot) {
+		return true;
+	}
+
+	// Je me positionne dans la section "Format/ODS"
+	//
+	pugi::xml_node node = xmlFileRoot->child(XML_FORMAT_NODE);
+	if (IS_EMPTY(node.name())) {
+		return true;
+	}
+
+	node = node.child(XML_OWN_ODS_NODE);
+	if (IS_EMPTY(node.name())) {
+		return true;
+	}
+
+	// Compression du contenu sur plusieurs threads (oui par défaut)
+	pugi::xml_node snode = node.child(XML_OWN_ODS_PARALLEL_DEFLATE);
+	if (!IS_EMPTY(snode.name())) {
+#ifdef __USE_CMD_LINE_ZIP__
+		// L'archive est construite par la commande zip
+		if (logs_) {
+			logs_->add(logs::TRACE_TYPE::LOG, "Paramètre ODS \"%s\" ignoré : l'archive est créée en ligne de commandes", XML_OWN_ODS_PARALLEL_DEFLATE);
+		}
+#else
+		bool parallel(0 == strcmp(snode.first_child().value(), XML_YES));
+		destZip_.setParallelDeflate(parallel);
+		if (logs_) {
+			logs_->add(logs::TRACE_TYPE::NORMAL, "Paramètres ODS :");
+			logs_->add(logs::TRACE_TYPE::NORMAL, "\t- Compression sur plusieurs threads : %s", (parallel ? "oui" : "non"));
+		}
+#endif // __USE_CMD_LINE_ZIP__
+	}
+
+	return true;
+}
 
 
 // Noms des fichiers
@@ -418,11 +506,12 @@ bool ODSFile::saveLine(bool header, LPAGENTINFOS agent)
 	// Ajout de toutes les valeurs visibles
 	//
 	columnList::LPCOLINFOS col(nullptr);
-	LPXMLCELL pCell(nullptr);
-	string fullLink(""), sValue("");
+	size_t index(XML_NO_VALUE);
+	string sValue("");
 	size_t colMax = columns_->size();
-	IMGSERVER photoServer;
-	configurationFile_->imagesServer(photoServer);
+	if (nullptr == photoServer_) {
+		photoServer_ = &configurationFile_->imagesServer();
+	}
 
 	for (size_t colIndex(0); colIndex < colMax; colIndex++){
 		col = columns_->at(colIndex);
@@ -432,7 +521,7 @@ bool ODSFile::saveLine(bool header, LPAGENTINFOS agent)
 			cell = row.append_child(ODS_SHEET_CELL_NODE);
 
 			// la première valeur..
-			pCell = &(line_[colIndex]);
+			index = _firstValue(colIndex);
 
 			// style de la cellule
 			//cell.append_attribute(ODS_COL_STYLE_ATTR) = ((!header && col->hyperLink())? CELL_TYPE_DEFAULT :cellStyleName.c_str());
@@ -440,85 +529,58 @@ bool ODSFile::saveLine(bool header, LPAGENTINFOS agent)
 
 			// Le valeur de type numerique ne sont enregistrées comme telles
 			// qu'à la condition qu'elles ne soient pas multivaluées !!!
-			if (!header && col->numeric() && !pCell->_next && pCell->_value.size()){
+			if (!header && col->numeric() && XML_NO_VALUE != index && XML_NO_VALUE == _nextValue(index)){
 				cell.append_attribute(ODS_CELL_TYPE_ATTR) = CELL_TYPE_FLOAT_VAL;
-				cell.append_attribute(ODS_CELL_VAL_ATTR) = pCell->_value.c_str();
+				cell.append_attribute(ODS_CELL_VAL_ATTR) = _valueAt(index);
 			}
 			else{
 				cell.append_attribute(ODS_CELL_TYPE_ATTR) = CELL_TYPE_STRING_VAL;
 			}
 
-			// Gestion de toutes les valeurs
-			while (pCell){
-				if (pCell->_value.size()){
-					val = cell.append_child(ODS_CELL_TEXT_NODE);
-
-					// J'ai une valeur
-					if (!header && col->hyperLink()){
-						// Un lien hyper texte
-						val = val.append_child(ODS_CELL_TEXT_LINK_NODE);
-
-						// lien vers ...
-						if (col->imageLink()){
-							// Une image
-							fullLink = photoServer.URL(photoServer.shortFileName(pCell->_value.c_str()));
-						}
-						else{
-							fullLink = (col->emailLink() ? "mailto:" : "http://");
-							fullLink += pCell->_value;
-						}
-						val.append_attribute(ODS_CELL_LINK_ATTR) = fullLink.c_str();
-					}
-
-					// valeur simple / ou valeur affichée sur le lien
-					val.text().set(pCell->_value.c_str());
+			if (XML_NO_VALUE == index){
+				// Il n'y a pas de valeurs
+				// on regarde si les valeurs suivantes sont aussi vides
+				size_t nextValid(1 + colIndex);
+				while (nextValid < colMax && _emptyColumn(nextValid)) {
+					nextValid++;
 				}
-				else{
-					// Il n'y a pas de valeurs
-					// on regarde si les valeurs suivantes sont aussi vides
-					size_t nextValid(1 + colIndex);
-					while (nextValid < colMax && 0 == line_[nextValid]._value.size()) {
-						nextValid++;
-					}
-
-					// J'en ai plusieurs
-					if (nextValid > (1 + colIndex)) {
-						sValue = charUtils::itoa(nextValid - colIndex);
-						cell.append_attribute(ODS_CELL_REPEATED_ATTR) = sValue.c_str();
-					}
 
-					// Ai je atteint la fin du tableau ?
-					colIndex = (nextValid >= columns_->size() ? nextValid : nextValid - 1);
+				// J'en ai plusieurs
+				if (nextValid > (1 + colIndex)) {
+					sValue = charUtils::itoa(nextValid - colIndex);
+					cell.append_attribute(ODS_CELL_REPEATED_ATTR) = sValue.c_str();
 				}
 
-				// Une autre valeur ?
-				pCell = pCell->_next;
-					/*
-					// Il n'y a pas de valeurs
-					// on regarde si les valeurs suivantes sont aussi vides
-					size_t nextValid(1+colIndex);
-					while (nextValid < colMax && 0 ==line_[nextValid]._value.size()){
-						nextValid++;
-					}
-
-					// J'en ai plusieurs
-					if (nextValid > (1 + colIndex)){
-                        sValue = charUtils::itoa(nextValid - colIndex);
-						cell.append_attribute(ODS_CELL_REPEATED_ATTR) = sValue.c_str();
-					}
+				// Ai je atteint la fin du tableau ?
+				colIndex = (nextValid >= columns_->size() ? nextValid : nextValid - 1);
+			}
 
-					// Ai je atteint la fin du tableau ?
-					if (nextValid >= (colMax - 1)) {
-						colIndex = colMax;
-						pCell = nullptr;
+			// Gestion de toutes les valeurs
+			while (XML_NO_VALUE != index){
+				val = cell.append_child(ODS_CELL_TEXT_NODE);
+
+				// J'ai une valeur
+				if (!header && col->hyperLink()){
+					// Un lien hyper texte
+					val = val.append_child(ODS_CELL_TEXT_LINK_NODE);
+
+					// lien vers ...
+					if (col->imageLink()){
+						// Une image
+						photoServer_->fullURL(fullLink_, _valueAt(index));
 					}
-					else {
-						colIndex = nextValid - 1;
+					else{
+						fullLink_.assign(col->emailLink() ? "mailto:" : "http://");
+						fullLink_.append(_valueAt(index), _valueLength(index));
 					}
+					val.append_attribute(ODS_CELL_LINK_ATTR) = fullLink_.c_str();
 				}
 
+				// valeur simple / ou valeur affichée sur le lien
+				val.text().set(_valueAt(index));
+
 				// Une autre valeur ?
-				pCell = pCell? pCell->_next : nullptr; */
+				index = _nextValue(index);
 			}
 		}
 	}
@@ -840,12 +902,21 @@ bool ODSFile::addSheet(string& sheetName, bool withHeader, bool firstSheet)
 //
 bool ODSFile::_createSheet(const char* name, bool withHeader, bool sizeColumns)
 {
+	// L'onglet précédent est terminé
+	_serializeSheet();
+
 	// On repart en haut de l'onglet
 	lineIndex_ = 0;
 
-	// Création du noeud
+	// Création du noeud dans un document dédié
 	//
-	sheetRoot_ = sheetsRoot_.append_child(ODS_SHEET_NODE);
+	sheetFragment* sheet(nullptr);
+	if (nullptr == (sheet = new sheetFragment())) {
+		throw LDAPException("Impossible d'allouer de la mémoire pour un onglet", RET_TYPE::RET_ALLOCATION_ERROR);
+	}
+	sheets_.push_back(sheet);
+
+	sheetRoot_ = sheet->doc_.append_child(ODS_SHEET_NODE);
 	sheetRoot_.append_attribute(ODS_SHEET_STYLE_ATTR) = ODS_SHEET_STYLE_TA1_VAL;
 	sheetRoot_.append_attribute(ODS_SHEET_PRINT_ATTR) = ODS_VAL_NO;
 
@@ -888,6 +959,102 @@ bool ODSFile::_createSheet(const char* name, bool withHeader, bool sizeColumns)
 	return true;
 }
 
+// Sérialisation de l'onglet courant
+//
+void ODSFile::_serializeSheet()
+{
+	if (0 == sheets_.size() || !strlen(sheetRoot_.name())) {
+		// Pas d'onglet en cours
+		return;
+	}
+
+	// Pas trop de sérialisations simultanées
+	size_t last(sheets_.size() - 1);
+	while (pendingSheet_ < last && (last - pendingSheet_) >= maxWorkers_) {
+		sheets_[pendingSheet_++]->wait();
+	}
+
+	// L'onglet ne doit plus être modifié
+	sheetRoot_ = pugi::xml_node();
+	sheets_[last]->serialize(indentXML_);
+}
+
+// Libération des onglets
+//
+void ODSFile::_releaseSheets()
+{
+	for (deque<sheetFragment*>::iterator it = sheets_.begin(); it != sheets_.end(); it++) {
+		if (*it) {
+			delete (*it);
+		}
+	}
+
+	sheets_.clear();
+	pendingSheet_ = 0;
+}
+
+// Enregistrement du fichier de contenu
+//	Le document est enregistré sans les onglets puis
+//	les fragments sont insérés, dans l'ordre, à leur emplacement
+//
+bool ODSFile::_saveContentFile()
+{
+	// Le dernier onglet est terminé
+	_serializeSheet();
+
+	// Emplacement des onglets
+	pugi::xml_node anchor = sheetsRoot_.append_child(pugi::node_comment);
+	anchor.set_value(ODS_SHEETS_ANCHOR);
+
+	std::ostringstream doc;
+	XMLContentFile_.save(doc, PUGIXML_TEXT("\t"), (indentXML_ ? pugi::format_default : pugi::format_raw), pugi::encoding_utf8);
+	sheetsRoot_.remove_child(anchor);
+
+	string content(doc.str()), mark("<!--" ODS_SHEETS_ANCHOR "-->");
+	size_t start(content.find(mark)), end(0);
+	if (content.npos == start) {
+		if (logs_) {
+			logs_->add(logs::TRACE_TYPE::ERR, "Impossible d'insérer les onglets dans le fichier de contenu");
+		}
+		return false;
+	}
+
+	// La ligne complète est remplacée
+	end = start + mark.size();
+	if (indentXML_) {
+		while (start > 0 && '\t' == content[start - 1]) {
+			start--;
+		}
+
+		if (end < content.size() && '\n' == content[end]) {
+			end++;
+		}
+	}
+
+	// Génération du fichier
+	ofstream oFile(contentFile_, ios::out | ios::binary | ios::trunc);
+	if (!oFile.is_open()) {
+		if (logs_) {
+			logs_->add(logs::TRACE_TYPE::ERR, "Impossible de créer le fichier de contenu '%s'", contentFile_.c_str());
+		}
+		return false;
+	}
+
+	oFile.write(content.c_str(), start);
+	for (deque<sheetFragment*>::iterator it = sheets_.begin(); it != sheets_.end(); it++) {
+		const string& sheet = (*it)->content();
+		oFile.write(sheet.c_str(), sheet.size());
+	}
+	oFile.write(content.c_str() + end, content.size() - end);
+
+	bool done(oFile.good());
+	oFile.close();
+
+	// Les onglets ne sont plus utiles
+	_releaseSheets();
+	return done;
+}
+
 // Nom de l'onglet
 //
 void ODSFile::_setSheetName(const char* sheetName)
@@ -31,6 +31,8 @@
 
 #include "XMLFile.h"
 
+#include <future>
+
 // Gestion de la compression ZIP
 //
 #ifdef _WIN32
@@ -45,6 +47,7 @@
 	#include "../ZipLib/ZipFile.h"
 	#include "../ZipLib/streams/memstream.h"
 	#include "../ZipLib//methods/Bzip2Method.h"
+	#include "../ZipLib/methods/DeflateMtMethod.h"
 #else
 	// Sous linux on utilise la ligne de commandes
 	#define	__USE_CMD_LINE_ZIP__
@@ -96,12 +99,18 @@ public:
 		// La couleur des lignes doit-elle etre alternee ?
 		alternateRowCol_ = (templateFile_.npos != templateFile_.find(XML_TEMPLATE_FILE_ALTERNATE));
 
+		// Serveur d'images (lu une seule fois)
+		photoServer_ = &configurationFile_->imagesServer();
+
 		// OK
 		return true;
 	}
 	virtual bool create()				// Ouverture du fichier
 	{ return XMLFile::_init();}
 
+	// Lecture des paramètres "personnels" dans le fichier de conf
+	virtual bool getOwnParameters();
+
 	// Noms des fichiers
 	virtual void defaultContentFileName(string& dest, bool ShortName = true);
 	virtual void templateFileName(string& dest, const char* name, bool ShortName = true);
@@ -161,8 +170,49 @@ private:
 	virtual bool _openContentFile();
 	virtual bool _closeContentFile()
 	{ return true;}
+	virtual bool _saveContentFile();
 	virtual bool _endContentFile();
 
+	// Gestion des onglets
+	void _serializeSheet();
+	void _releaseSheets();
+
+	// Un onglet
+	//	Chaque onglet est construit dans son propre document XML.
+	//	Dès qu'il est terminé, sa sérialisation est confiée à un thread
+	//	et les fragments sont concaténés dans l'ordre lors de l'enregistrement
+	//
+	class sheetFragment
+	{
+	public:
+		// Construction et destruction
+		sheetFragment()
+		{ content_ = ""; }
+		virtual ~sheetFragment()
+		{ wait(); }
+
+		// Sérialisation (asynchrone)
+		void serialize(bool indentXML);
+
+		// Attente de la fin de la sérialisation
+		void wait(){
+			if (worker_.valid()) {
+				worker_.wait();
+			}
+		}
+
+		// Contenu XML de l'onglet
+		const string& content(){
+			wait();
+			return content_;
+		}
+
+	public:
+		pugi::xml_document	doc_;			// Contenu de l'onglet
+		string				content_;		// ... une fois sérialisé
+		std::future<void>	worker_;		// Thread de sérialisation
+	};
+
 	// Un fichier Zip
 	//
 	class zipFile
@@ -172,6 +222,9 @@ private:
 		zipFile(){
 			srcPath_ = "";
 			file_ = false;
+#ifndef __USE_CMD_LINE_ZIP__
+			parallel_ = true;
+#endif // __USE_CMD_LINE_ZIP__
 		}
 
 		virtual ~zipFile()
@@ -191,6 +244,10 @@ private:
 			zipAlias_ = pzip;
 			unzipAlias_ = punzip;
 		}
+#else
+		// Compression des fichiers ajoutés sur plusieurs threads
+		void setParallelDeflate(bool parallel)
+		{ parallel_ = parallel; }
 #endif // __USE_CMD_LINE_ZIP__
 
 
@@ -236,6 +293,8 @@ private:
 		aliases::alias*		unzipAlias_;
 
 		std::string			tempFolder_;	// Le dossier temporaire dans lequel sont dezipés/zipés les fichiers
+#else
+		bool				parallel_;		// Compression sur plusieurs threads (DeflateMtMethod)
 #endif // #ifdef __USE_CMD_LINE_ZIP__
 	};
 
@@ -245,11 +304,19 @@ private:
 	size_t			lineIndex_;				// Index de la ligne dans l'onglet
 	bool			alternateRowCol_;		// Changement de couleur des lignes
 
+	const IMGSERVER*	photoServer_;		// Serveur gérant les photos
+	string			fullLink_;				// Tampon pour les liens
+
 	int				contentIndex_;			// Index du fichier de contenu dans le modele
 	string			tempFolder_;			// Le dossier temporaire de l'application
 
 	// Le fichier "ODS" zip destination
 	zipFile			destZip_;
+
+	// Les onglets
+	deque<sheetFragment*>	sheets_;
+	size_t			pendingSheet_;			// Premier onglet en cours de sérialisation
+	size_t			maxWorkers_;			// Nombre max. de sérialisations simultanées
 };
 
 #endif // #ifndef __LDAP_2file__ODS_OUTPUTfile__h__
@@ -195,6 +195,16 @@
 // Durée en jours
 #define XML_CONF_LOGS_DURATIONNODE		"Duree"
 
+// Rapport d'exécution (JSON) pour chaque fichier de commandes
+#define XML_CONF_LOGS_REPORT_NODE		"Rapport"
+
+// Profilage des requêtes LDAP et seuil de répétition
+#define XML_CONF_LOGS_PROFILE_NODE		"Requetes"
+#define XML_CONF_LOGS_THRESHOLD_ATTR	"Seuil"
+
+// Dossier du collecteur "textfile" de Prometheus
+#define XML_CONF_LOGS_PROMETHEUS_NODE	"Prometheus"
+
 #define LOG_DURATION_INFINITE			-1
 #define LOG_DURATION_MIN				1
 
@@ -258,9 +268,16 @@
 #define XML_SERVERS_NODE					XML_DESTINATIONS_NODE	// Dans le fichier de conf.
 #define XML_DESTINATION_NODE				XML_DESTINATION
 
+// Mode de transfert (dans le fichier de conf.)
+#define XML_SERVERS_PARALLEL_ATTR			"Parallele"		// Transferts simultanés vers toutes les destinations ("oui" par défaut)
+#define XML_SERVERS_ASYNC_ATTR				"Asynchrone"	// Transferts pendant la génération du fichier suivant
+#define XML_SERVERS_MAIL_BATCH_ATTR			"GrouperMails"	// Mails envoyés en fin d'analyse (une connexion par serveur)
+#define XML_SERVERS_FTP_IDLE_ATTR			"Sessions-FTP"	// Durée de conservation (en s) d'une session FTP inutilisée (0 => pas de réutilisation)
+
 #define XML_DESTINATION_ENV_ATTR			XML_ENVIRONMENT
 #define XML_DESTINATION_NAME_ATTR			XML_NAME
 #define XML_DESTINATION_TYPE_ATTR			XML_TYPE
+#define XML_DESTINATION_TIMEOUT_ATTR		"Delai"			// Durée max. du transfert en secondes
 
 // Types de destination reconnus
 #define TYPE_DEST_FS						"FileSystem"	// Par défaut si non précisé
@@ -316,6 +333,7 @@
 #define XML_FORMAT_NODE					XML_FORMAT
 
 #define XML_FORMAT_TYPE_ATTR			XML_TYPE
+#define XML_FORMAT_TYPE_SEP				','			// Plusieurs formats pour un même parcours (ex. "CSV,VCF")
 #define TYPE_FILE_TXT					"TXT"
 #define TYPE_FILE_CSV					"CSV"
 #define TYPE_FILE_XLS					"XLS"
@@ -339,6 +357,12 @@
 // Longueur du nom d'un onglet
 #define XML_TAB_NAME_SIZE_NODE			"TailleOnglet"
 
+// Compression des fichiers texte (CSV, LDIF, vCard, JS)
+#define XML_FORMAT_COMPRESSION_NODE		"Compression"
+#define XML_COMPRESSION_LEVEL_ATTR		"Niveau"
+#define COMPRESSION_GZIP				"gzip"
+#define COMPRESSION_ZSTD				"zstd"
+
 // Alias
 //
 #define XML_FORMAT_ALIAS_NODE			XML_ALIAS
@@ -369,6 +393,9 @@
 #define XML_FORMAT_SHOW_EMPTY_ATTR		"Attributs"
 #define SHOW_EMPTY_ATTR_VAL				"vide"			// Affichage des attributs vide
 
+// Génération compacte (dictionnaire des valeurs + fichiers compressés) ?
+#define XML_FORMAT_COMPACT_NODE			"Compact"
+
 //
 // Recherche
 //
@@ -475,6 +502,14 @@
 #define XML_OWN_LDIF_FUSION_NODE	"Fusion"
 #define XML_FUSION_NAME_ATTR		XML_NAME			// Nom de l'attribut source
 
+#define XML_OWN_LDIF_DELTA_NODE		"Delta"				// Uniquement les modifications depuis l'extraction précédente
+
+// Génération des fichiers ODS
+//
+#define XML_OWN_ODS_NODE				"ODS"
+
+#define XML_OWN_ODS_PARALLEL_DEFLATE	"Compression-Parallele"		// Compression du contenu sur plusieurs threads (Windows uniquement)
+
 // Génération des fichiers VCARD / VCF
 //
 #define XML_OWN_VCARD_NODE			"VCARD"
@@ -31,6 +31,8 @@
 #include "XMLFile.h"
 #include "ODSConsts.h"
 
+#include <algorithm>
+
 //----------------------------------------------------------------------
 //--
 //-- Constantes privées
@@ -38,32 +40,6 @@
 //----------------------------------------------------------------------
 
 
-//----------------------------------------------------------------------
-//--
-//-- Implémentation de la classe XMLCELL
-//--
-//----------------------------------------------------------------------
-
-// Initialisation d'une cellule
-//
-void XMLFile::XMLCELL::_init(const char* value, bool firstTime)
-{
-	_value = (IS_EMPTY(value) ? "" : value);
-
-	if (!firstTime){
-		// Suppression de toutes les valeurs
-		XMLFile::LPXMLCELL current, next = _next;
-		while (next){
-			current = next;			// Je conserve un pointeur sur la valeur courante
-			next = next->_next;		// Encore une valeur ?
-			delete current;			// Libération de cette valeur
-		}
-	}
-
-	_next = nullptr;
-}
-
-
 //----------------------------------------------------------------------
 //--
 //-- Implémentation de la classe XMLFile
@@ -82,7 +58,6 @@ XMLFile::XMLFile(const LPOPFI fileInfos, columnList* columns, confFile* paramete
 	encoder_.sourceFormat(charUtils::SOURCE_FORMAT::ISO_8859_15);
 #endif // _WIN32
 	// La ligne est vide
-	line_ = nullptr;
 	values_ = 0;
 	colIndex_ = 0;
 }
@@ -90,24 +65,17 @@ XMLFile::XMLFile(const LPOPFI fileInfos, columnList* columns, confFile* paramete
 // Destruction
 //
 XMLFile::~XMLFile()
-{
-	if (values_ && line_){
-		// Suppression des cellules multivaluées
-		_emptyLine();
-
-		// Suppression de la ligne
-		delete[] line_;
-	}
-}
+{}
 
 // Initialisation(s)
 //
 bool XMLFile::_init(){
 	// Preparation de la matrice en mémoire
 	values_ = columns_->size();
-	if (nullptr == (line_ = new XMLFile::XMLCELL[values_])){
-		throw LDAPException("Impossible d'allouer de la mémoire pour la modélisation d'une ligne", RET_TYPE::RET_ALLOCATION_ERROR);
-	}
+	firstValues_.assign(values_, XML_NO_VALUE);
+	lastValues_.assign(values_, XML_NO_VALUE);
+	rowValues_.reserve(2 * values_);
+	rowBuffer_.reserve(4096);
 
 	// Modèle
 	//
@@ -158,12 +126,16 @@ bool XMLFile::addAt(size_t colIndex, string& value)
 		return false;
 	}
 
-	// Copie de la valeur dans la matrice mémoire
-	line_[colIndex]._value = value;
+	// La valeur remplace le contenu de la colonne
+	firstValues_[colIndex] = XML_NO_VALUE;
+
+	// Copie de la valeur dans le buffer de la ligne
 #ifdef _WIN32
-	encoder_.convert_toUTF8(line_[colIndex]._value, false);
+	encoder_.toUTF8(encoded_, value.c_str(), value.size());
+	_addValue(colIndex, encoded_);
+#else
+	_addValue(colIndex, value);
 #endif // _WIN32
-	line_[colIndex]._next = nullptr;		// Une seule valeur (pour l'instant)
 
 	// Fait
 	return true;
@@ -179,11 +151,8 @@ bool XMLFile::removeAt(size_t colIndex)
 		return false;
 	}
 
-	// Supression de la valeur dans la matrice mémoire
-	line_[colIndex]._value = "";
-	if (line_[colIndex]._next){
-		line_[colIndex]._next->_init();
-	}
+	// La colonne est vide (la place dans le buffer sera récupérée avec la ligne suivante)
+	firstValues_[colIndex] = XML_NO_VALUE;
 
 	// Fait
 	return true;
@@ -201,44 +170,57 @@ bool XMLFile::addAt(size_t colIndex, deque<string>& values)
 		return false;
 	}
 
-	// Pointeur sur la cellule contenant la première valeur
-	LPXMLCELL current(&line_[colIndex]), next(nullptr);
-
 	// Ajout des autres valeurs
-	string validValue("");
 	while ((++value) != values.end()){
-		// Encodage
-		validValue = (*value);
+		if (0 == value->size()) {
+			continue;
+		}
 
+		// Encodage
 #ifdef _WIN32
-		encoder_.convert_toUTF8(validValue, false);
+		encoder_.toUTF8(encoded_, value->c_str(), value->size());
+		_addValue(colIndex, encoded_);
+#else
+		_addValue(colIndex, *value);
 #endif // _WIN32
-
-		// Création de la nouvelle cellule
-		if (nullptr != (next = new XMLCELL(validValue))){
-			// chainage
-			current->_next = next;
-
-			// on avance
-			current = next;
-		}
-		else{
-			throw LDAPException("Impossible d'allouer de la mémoire pour les cellules multivaluées", RET_TYPE::RET_ALLOCATION_ERROR);
-		}
 	}
 
 	return true;
 }
 
+// Ajout d'une valeur à la fin d'une colonne
+//
+void XMLFile::_addValue(size_t colIndex, const string& value)
+{
+	XMLVALUE val;
+	val.offset_ = rowBuffer_.size();
+	val.length_ = value.size();
+	val.next_ = XML_NO_VALUE;
+
+	// La valeur et son '\0'
+	rowBuffer_.append(value);
+	rowBuffer_.push_back(EOS);
+
+	// Chaînage
+	size_t index(rowValues_.size());
+	rowValues_.push_back(val);
+	if (XML_NO_VALUE == firstValues_[colIndex]) {
+		firstValues_[colIndex] = index;
+	}
+	else {
+		rowValues_[lastValues_[colIndex]].next_ = index;
+	}
+	lastValues_[colIndex] = index;
+}
+
 // Nettoyage de la ligne
 //
 void XMLFile::_emptyLine()
 {
-	if (line_){
-		for (size_t index = 0; index < values_; index++){
-			line_[index]._init();
-		}
-	}
+	// Les buffers conservent leur capacité
+	rowBuffer_.clear();
+	rowValues_.clear();
+	std::fill(firstValues_.begin(), firstValues_.end(), XML_NO_VALUE);
 }
 
 // Sauvegarde
@@ -248,15 +230,7 @@ bool XMLFile::close()
 	// Sauvegarde du fichier content
 	//
 	_closeContentFile();
-
-	// Sans indentation
-	if (!indentXML_){
-		XMLContentFile_.save_file(contentFile_.c_str(), PUGIXML_TEXT("\t"), pugi::format_raw | pugi::format_save_file_text, pugi::encoding_utf8);
-	}
-	else{
-		// Avec indentation
-		XMLContentFile_.save_file(contentFile_.c_str(), PUGIXML_TEXT("\t"), pugi::format_default | pugi::format_save_file_text, pugi::encoding_utf8);
-	}
+	_saveContentFile();
 
 	// Le fichier de contenu est généré ...
 	// traitements finaux (compression...)
@@ -265,6 +239,19 @@ bool XMLFile::close()
 	return true;
 }
 
+// Enregistrement du fichier de contenu
+//
+bool XMLFile::_saveContentFile()
+{
+	// Sans indentation
+	if (!indentXML_){
+		return XMLContentFile_.save_file(contentFile_.c_str(), PUGIXML_TEXT("\t"), pugi::format_raw | pugi::format_save_file_text, pugi::encoding_utf8);
+	}
+
+	// Avec indentation
+	return XMLContentFile_.save_file(contentFile_.c_str(), PUGIXML_TEXT("\t"), pugi::format_default | pugi::format_save_file_text, pugi::encoding_utf8);
+}
+
 // Création d'une arborescence "flat"
 //
 void XMLFile::shift(int offset, treeCursor& ascendants)
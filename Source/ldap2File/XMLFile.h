@@ -33,6 +33,8 @@
 
 #include "outputFile.h"
 
+#include <vector>
+
 //#include <charUtils.h>
 
 // Gestion du format XML
@@ -47,6 +49,8 @@
 //--
 //----------------------------------------------------------------------
 
+// Pas de valeur (index dans la ligne)
+#define XML_NO_VALUE		((size_t)-1)
 
 //----------------------------------------------------------------------
 //--
@@ -124,26 +128,34 @@ protected:
 	virtual bool _initContentFile() = 0;
 	virtual bool _openContentFile() = 0;
 	virtual bool _closeContentFile() = 0;
+	virtual bool _saveContentFile();
 	virtual bool _endContentFile() = 0;
 
-	// Une cellule - Valeur(s)
+	// Une valeur de la ligne courante
+	//	Les valeurs sont stockées (avec leur '\0') les unes à la suite des autres
+	//	dans un même buffer, réutilisé d'une ligne à l'autre
 	//
-	typedef struct tagXMLCell
+	typedef struct tagXMLValue
 	{
-		// Construction
-		//
-		tagXMLCell(const char* value = NULL)
-		{ _init(value, true); }
-		tagXMLCell(string& value)
-		{ _init(value.c_str(), true); }
+		size_t		offset_;	// Position dans le buffer
+		size_t		length_;	// Longueur
+		size_t		next_;		// Index de la valeur suivante de la colonne (si multivalué)
+	}XMLVALUE, *LPXMLVALUE;
 
-		void _init(const char* value = NULL, bool firstTime = false);
+	// Ajout d'une valeur à la fin d'une colonne
+	void _addValue(size_t colIndex, const string& value);
 
-		// Données de la cellule
-		//
-		string		_value;	// Valeur alpha
-		tagXMLCell*	_next;	// valeur suivante (si multivalué)
-	}XMLCELL, *LPXMLCELL;
+	// Parcours des valeurs de la ligne courante
+	size_t _firstValue(size_t colIndex) const
+	{ return (colIndex < values_ ? firstValues_[colIndex] : XML_NO_VALUE); }
+	size_t _nextValue(size_t index) const
+	{ return rowValues_[index].next_; }
+	const char* _valueAt(size_t index) const
+	{ return rowBuffer_.c_str() + rowValues_[index].offset_; }
+	size_t _valueLength(size_t index) const
+	{ return rowValues_[index].length_; }
+	bool _emptyColumn(size_t colIndex) const
+	{ return (XML_NO_VALUE == _firstValue(colIndex)); }
 
 
 
@@ -156,8 +168,14 @@ protected:
 
 	size_t				colIndex_;		// Index de la valeur courante
 
-	LPXMLCELL			line_;			// Tableau des valeurs
 	size_t				values_;		// Nombre de colonnes (ie. de valeurs)
+	string				rowBuffer_;		// Valeurs de la ligne courante
+	vector<XMLVALUE>	rowValues_;		// ... et leurs positions
+	vector<size_t>		firstValues_;	// Première valeur de chaque colonne
+	vector<size_t>		lastValues_;	// Dernière valeur de chaque colonne
+#ifdef _WIN32
+	string				encoded_;		// Valeur convertie en UTF8
+#endif // _WIN32
 
 	string				contentFile_;	// Contenu
 	string				templateFile_;	// Modèle / base pour la génération du fichier
@@ -313,10 +313,34 @@ bool commandFile::_fileInfos(aliases& aliases, OPFI& fileInfos)
 	// Type du fichier
 	//
 	fileInfos.formatName_ = node.attribute(XML_FORMAT_TYPE_ATTR).value();
-	fileInfos.format_ = LDAPFile::string2FileType(fileInfos.formatName_);
+	fileInfos.formats_.clear();
+
+	// Un ou plusieurs formats (séparés par des virgules)
+	string format("");
+	FILE_TYPE fileType(FILE_TYPE::FILE_UNKNOWN_TYPE);
+	size_t from(0), to(0);
+	while (from <= fileInfos.formatName_.size()) {
+		if (fileInfos.formatName_.npos == (to = fileInfos.formatName_.find(XML_FORMAT_TYPE_SEP, from))) {
+			to = fileInfos.formatName_.size();
+		}
+
+		// Sans les espaces
+		format = fileInfos.formatName_.substr(from, to - from);
+		format.erase(0, format.find_first_not_of(' '));
+		format.erase(format.find_last_not_of(' ') + 1);
 
-	if (FILE_TYPE::FILE_UNKNOWN_TYPE == fileInfos.format_){
-		return false; // ...
+		if (FILE_TYPE::FILE_UNKNOWN_TYPE == (fileType = LDAPFile::string2FileType(format))) {
+			return false; // ...
+		}
+
+		fileInfos.formats_.push_back(fileType);
+		from = to + 1;
+	}
+
+	fileInfos.format_ = fileInfos.formats_.front();
+	if (1 == fileInfos.formats_.size()) {
+		// Un seul format
+		fileInfos.formats_.clear();
 	}
 
 	// Nom du fichier
@@ -356,6 +380,24 @@ bool commandFile::_fileInfos(aliases& aliases, OPFI& fileInfos)
 		fileInfos.sheetNameLen_ = atoi(snode.first_child().value());
 	}
 
+	// Compression
+	snode = node.child(XML_FORMAT_COMPRESSION_NODE);
+	if (!IS_EMPTY(snode.name())) {
+		val = snode.first_child().value();
+		if (!charUtils::stricmp(val.c_str(), COMPRESSION_GZIP)) {
+			fileInfos.compression_ = COMPRESSION_TYPE::GZIP;
+		}
+		else {
+			if (!charUtils::stricmp(val.c_str(), COMPRESSION_ZSTD)) {
+				fileInfos.compression_ = COMPRESSION_TYPE::ZSTD;
+			}
+		}
+
+		if (!IS_EMPTY(snode.attribute(XML_COMPRESSION_LEVEL_ATTR).value())) {
+			fileInfos.compressionLevel_ = snode.attribute(XML_COMPRESSION_LEVEL_ATTR).as_int();
+		}
+	}
+
 	// Action(s) à éxecuter
 	//
 	snode = node.child(XML_FORMAT_ACTION_NODE);
@@ -540,6 +582,7 @@ bool commandFile::_destinationsInfos(aliases& aliases, OPFI& fileInfos)
 
 		// Ajout de la nouvelle destination
 		if (pDestination){
+			pDestination->setTimeout(atoi(snode.attribute(XML_DESTINATION_TIMEOUT_ATTR).value()));
 			if (!fileInfos.add(pDestination)){
 				delete pDestination;
 			}
@@ -595,6 +638,30 @@ bool commandFile::showEmptyAttributes()
 	return (SHOW_EMPTY_ATTR_VAL == value);
 }
 
+// Génération "compacte" ?
+//
+bool commandFile::compactOutput()
+{
+	// A t'on vérifié qu'il était bien formé ?
+	if (IS_EMPTY(paramsRoot_.name())){
+		return false;
+	}
+
+	pugi::xml_node node = paramsRoot_.child(XML_FORMAT_NODE);
+	if (IS_EMPTY(node.name())){
+		return false;
+	}
+
+	// La valeur est-elle renseignée
+	node = node.child(XML_FORMAT_COMPACT_NODE);
+	if (IS_EMPTY(node.name())){
+		return false;
+	}
+
+	string value = node.first_child().value();
+	return (XML_YES == value);
+}
+
 // Recherche sur un critère et Rupture
 //
 bool commandFile::searchCriteria(columnList* cols, commandFile::criterium& search)
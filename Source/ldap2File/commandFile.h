@@ -60,7 +60,11 @@ public:
 
 			// Par défaut, aujourd'hui
 			time_t now = time(0);
-			date_ = *localtime(&now);
+#ifdef _WIN32
+			localtime_s(&date_, &now);
+#else
+			localtime_r(&now, &date_);
+#endif // _WIN32
 		}
 
 		date(string&value) {
@@ -128,12 +132,17 @@ public:
 
 				// Normalisation ...
 				time_t when = mktime(&date_);
-				const struct tm *norm = localtime(&when);
+				struct tm norm;
+#ifdef _WIN32
+				localtime_s(&norm, &when);
+#else
+				localtime_r(&when, &norm);
+#endif // _WIN32
 
 				// Après nprmalisation la date ne devrait pas avoir changé !!!:
-				return (norm->tm_mday == d &&
-					norm->tm_mon == m - 1 &&
-					norm->tm_year == y - 1900);
+				return (norm.tm_mday == d &&
+					norm.tm_mon == m - 1 &&
+					norm.tm_year == y - 1900);
 			}
 
 			// Une erreur
@@ -234,6 +243,9 @@ public:
 
 	bool showEmptyAttributes();
 
+	// Génération "compacte" (organigramme JS) ?
+	bool compactOutput();
+
 	// Recherche sur un critère et Rupture
 	bool searchCriteria(columnList* cols, commandFile::criterium& search);
 
@@ -83,6 +83,9 @@ bool confFile::openCommandFile(const char* cmdFile, RET_TYPE& code)
 		commandFile_ = nullptr;
 	}
 
+	// Le serveur d'images sera relu
+	imagesServerRead_ = false;
+
 	// Ouverture du fichier
 	if (!(commandFile_ = new commandFile(cmdFile, folders_, logs_, false))
 		|| !commandFile_->isValid()){
@@ -121,6 +124,25 @@ bool confFile::logInfos(LOGINFOS& dst)
 			dst.duration_ = value;
 		}
 
+		// Rapport d'exécution ?
+		subNode = node.child(XML_CONF_LOGS_REPORT_NODE);
+		if (!IS_EMPTY(subNode.name())) {
+			dst.report_ = (XML_YES == string(subNode.first_child().value()));
+		}
+
+		// Profilage des requêtes ?
+		subNode = node.child(XML_CONF_LOGS_PROFILE_NODE);
+		if (!IS_EMPTY(subNode.name())) {
+			dst.profile_ = (XML_YES == string(subNode.first_child().value()));
+			dst.threshold_ = (size_t)atoi(subNode.attribute(XML_CONF_LOGS_THRESHOLD_ATTR).value());
+		}
+
+		// Statistiques pour Prometheus
+		subNode = node.child(XML_CONF_LOGS_PROMETHEUS_NODE);
+		if (!IS_EMPTY(subNode.name())) {
+			dst.prometheus_ = subNode.first_child().value();
+		}
+
 		// Recherche de la "bonne valeur" pour le nom du sdossier
 		subNode = findChildNode(node, XML_CONF_LOGS_FOLDER_NODE, XML_CONF_FOLDER_OS_ATTR, expectedOS_.c_str(), true);
 
@@ -229,10 +251,27 @@ bool confFile::nextLDAPServer(LDAPServer** pDest)
 //
 bool confFile::imagesServer(IMGSERVER& dst)
 {
+	if (!imagesServerRead_){
+		_readImagesServer();
+	}
+
+	dst = imagesServer_;
+	return imagesServerValid_;
+}
+
+// Lecture des paramètres du serveur d'images
+//	Les valeurs sont conservées jusqu'au prochain fichier de commandes
+//
+bool confFile::_readImagesServer()
+{
+	IMGSERVER& dst(imagesServer_);
 	dst.init();
+	imagesServerRead_ = true;
+	imagesServerValid_ = false;
 
 	pugi::xml_node element = paramsRoot_.child(XML_CONF_LDAP_SOURCES_NODE);
 	if (IS_EMPTY(element.name())) {
+		dst.setBaseFolder();
 		return false;
 	}
 
@@ -242,6 +281,7 @@ bool confFile::imagesServer(IMGSERVER& dst)
 
 	// Rien trouvé ?
 	if (IS_EMPTY(myNode.name())) {
+		dst.setBaseFolder();
 		return false;
 	}
 
@@ -272,7 +312,11 @@ bool confFile::imagesServer(IMGSERVER& dst)
 		dst.nophoto_ = subNode.first_child().value();
 	}
 
+	// Le dossier de base est calculé une fois pour toutes
+	dst.setBaseFolder();
+
 	// Ok
+	imagesServerValid_ = true;
 	return true;
 }
 
@@ -530,9 +574,10 @@ bool confFile::nextDestinationServer(aliases& aliases, fileDestination** pdestin
 		} // SCP
 	} // ftp
 
-	// Maj de l'environnement
+	// Maj de l'environnement et du délai
 	if (nullptr != pDestination) {
 		pDestination->setEnvironment(env);
+		pDestination->setTimeout(atoi(destinationServer_.node()->attribute(XML_DESTINATION_TIMEOUT_ATTR).value()));
 	}
 
 	// On retourne le pointeur vers l'objet crée
@@ -545,6 +590,46 @@ bool confFile::nextDestinationServer(aliases& aliases, fileDestination** pdestin
 	return true;
 }
 
+// Mode de transfert vers les destinations
+//
+bool confFile::deliveryMode(bool& parallel, bool& async, bool& batchMails)
+{
+	parallel = true;
+	async = batchMails = false;
+
+	pugi::xml_node node = paramsRoot_.child(XML_SERVERS_NODE);
+	if (IS_EMPTY(node.name())) {
+		return false;
+	}
+
+	// Simultanés sauf si Parallele="non"
+	parallel = (XML_NO != string(node.attribute(XML_SERVERS_PARALLEL_ATTR).value()));
+	async = (XML_YES == string(node.attribute(XML_SERVERS_ASYNC_ATTR).value()));
+	batchMails = (XML_YES == string(node.attribute(XML_SERVERS_MAIL_BATCH_ATTR).value()));
+	return true;
+}
+
+// Durée de conservation des sessions FTP
+//	avec l'option -f, elle doit dépasser la fréquence d'analyse pour que
+//	les sessions soient réutilisées d'une analyse à l'autre
+//
+bool confFile::ftpSessionsTimeout(unsigned int& timeout)
+{
+	pugi::xml_node node = paramsRoot_.child(XML_SERVERS_NODE);
+	if (IS_EMPTY(node.name())) {
+		return false;
+	}
+
+	string value(node.attribute(XML_SERVERS_FTP_IDLE_ATTR).value());
+	if (0 == value.size()) {
+		return false;
+	}
+
+	int seconds(atoi(value.c_str()));
+	timeout = (seconds > 0 ? (unsigned int)seconds : 0);
+	return true;
+}
+
 // Schéma LDAP reconnu
 //
 bool confFile::nextLDAPAttribute(columnList::COLINFOS& col, std::vector<std::string>& rNames)
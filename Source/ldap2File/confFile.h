@@ -67,7 +67,14 @@ public:
 	{ return environment_; }
 
 	// Serveur pour les images
+	//	La configuration n'est lue qu'une seule fois par fichier de commandes
 	bool imagesServer(IMGSERVER& dst);
+	const IMGSERVER& imagesServer(){
+		if (!imagesServerRead_){
+			_readImagesServer();
+		}
+		return imagesServer_;
+	}
 
 	// Définition du schema
 	bool nextLDAPAttribute(columnList::COLINFOS& col, std::vector<std::string>& rNames);
@@ -78,6 +85,14 @@ public:
 	// Serveur(s) destination
 	bool nextDestinationServer(aliases& aliases, fileDestination** pdestination,bool* add);
 
+	// Mode de transfert vers les destinations
+	//	transferts simultanés par défaut, asynchrones et mails groupés sur demande
+	bool deliveryMode(bool& parallel, bool& async, bool& batchMails);
+
+	// Durée (en s) de conservation des sessions FTP inutilisées
+	//	retourne false si elle n'est pas précisée
+	bool ftpSessionsTimeout(unsigned int& timeout);
+
 	// Liste des aliases
 	bool appAliases(aliases& aliases);
 
@@ -96,8 +111,12 @@ protected:
 	void _init(){
 		fileRead_ = false;		// Pas encore lu
 		commandFile_ = nullptr;
+		imagesServerRead_ = imagesServerValid_ = false;
 		}
 
+	// Lecture (et mise en cache) du serveur d'images
+	bool _readImagesServer();
+
 	// Ouverture
 	virtual bool _open();
 	virtual bool _load();
@@ -117,6 +136,11 @@ protected:
 	commandFile*	commandFile_;		// Fichier de commandes
 	std::string		environment_;		// Nom de l'environnement (peut être vide)
 
+	// Serveur d'images (cache)
+	IMGSERVER		imagesServer_;
+	bool			imagesServerRead_;	// La configuration a t'elle été lue ?
+	bool			imagesServerValid_;	// ... et le serveur a t'il été trouvé ?
+
 	// Gestion de la structure de l'arborescence
 	XMLParser::XMLNode	structureElement_;
 
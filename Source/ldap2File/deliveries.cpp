@@ -0,0 +1,259 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: deliveries.cpp
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Implémentation de la classe deliveries
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#include "deliveries.h"
+
+#include <chrono>
+
+//----------------------------------------------------------------------
+//--
+//-- Implémentation de la classe
+//--
+//----------------------------------------------------------------------
+
+// Construction
+//
+deliveries::deliveries(logs* pLogs, bool parallel)
+{
+	logs_ = pLogs;
+	parallel_ = parallel;
+	file_ = nullptr;
+	opfi_ = nullptr;
+	failed_ = false;
+
+	report_ = nullptr;
+	status_ = 0;
+	profiler_ = nullptr;
+}
+
+// Destruction
+//
+deliveries::~deliveries()
+{
+	wait();
+}
+
+// Un transfert de plus
+//
+void deliveries::add(fileDestination* dest, const char* fileName, size_t bytes, std::function<bool()> transfer)
+{
+	LPDELIVERY item(nullptr);
+	if (nullptr == dest || nullptr == (item = new DELIVERY)) {
+		return;
+	}
+
+	item->name_ = (strlen(dest->name()) ? dest->name() : dest->folder());
+	item->type_ = dest->type();
+	item->fileName_ = (fileName ? fileName : "");
+	item->bytes_ = bytes;
+	item->done_ = false;
+	item->duration_ = 0.0;
+	items_.push_back(item);
+
+	if (parallel_) {
+		try {
+			item->thread_ = std::thread(_run, item, transfer);
+			return;
+		}
+		catch (...) {
+			// Pas de thread => transfert immédiat
+			if (logs_) {
+				logs_->add(logs::TRACE_TYPE::ERR, "Impossible de lancer le transfert vers '%s' en parallèle", item->name_.c_str());
+			}
+		}
+	}
+
+	_run(item, transfer);
+}
+
+// Fichiers à libérer une fois tous les transferts terminés
+//
+void deliveries::own(outputFile* file, OPFI* opfi, bool failed)
+{
+	file_ = file;
+	opfi_ = opfi;
+	failed_ = failed;
+}
+
+// Rapport d'exécution à compléter
+//
+void deliveries::ownReport(runReport* report, const string& fileName, int status, queryProfiler* profiler)
+{
+	report_ = report;
+	reportName_ = fileName;
+	status_ = status;
+	profiler_ = profiler;
+}
+
+// Un transfert en cours utilise-t'il ce fichier (ou un fichier de même nom) ?
+//	les fichiers générés simultanément ne diffèrent que par leur extension
+//
+bool deliveries::uses(const char* fileName)
+{
+	if (IS_EMPTY(fileName)) {
+		return false;
+	}
+
+	string stem(fileName);
+	size_t pos(stem.rfind("."));
+	if (stem.npos != pos) {
+		stem.resize(pos);
+	}
+
+	for (deque<LPDELIVERY>::iterator it = items_.begin(); it != items_.end(); it++) {
+		if ((*it) && 0 == (*it)->fileName_.compare(0, stem.size(), stem)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Attente de la fin de tous les transferts
+//
+size_t deliveries::wait(runReport* report)
+{
+	if (nullptr == report) {
+		report = report_;
+	}
+
+	size_t errors(0);
+	for (deque<LPDELIVERY>::iterator it = items_.begin(); it != items_.end(); it++) {
+		LPDELIVERY item(*it);
+		if (nullptr == item) {
+			continue;
+		}
+
+		if (item->thread_.joinable()) {
+			item->thread_.join();
+		}
+
+		if (!item->done_) {
+			errors++;
+		}
+
+		if (logs_) {
+			logs_->add(logs::TRACE_TYPE::NORMAL, "Transfert vers '%s' : %s en %.3f s", item->name_.c_str(), (item->done_ ? "ok" : "erreur"), item->duration_ / 1000.0);
+		}
+
+		// Rapport d'exécution
+		if (report) {
+			switch (item->type_) {
+			case DEST_TYPE::DEST_EMAIL:
+				report->add(runReport::PHASE::SMTP, item->duration_);
+				break;
+
+			case DEST_TYPE::DEST_FTP:
+				report->add(runReport::PHASE::FTP, item->duration_);
+				break;
+
+			case DEST_TYPE::DEST_SCP:
+				report->add(runReport::PHASE::SCP, item->duration_);
+				break;
+
+			default:
+				break;
+			}
+
+			if (item->done_) {
+				report->add(runReport::COUNTER::SENT_BYTES, item->bytes_);
+			}
+		}
+	}
+
+	// Le rapport détenu est complet
+	if (report_) {
+		if (report_->save(reportName_, status_, profiler_)) {
+			if (logs_) {
+				logs_->add(logs::TRACE_TYPE::NORMAL, "Rapport d'exécution enregistré dans '%s'", reportName_.c_str());
+			}
+		}
+		else {
+			if (logs_) {
+				logs_->add(logs::TRACE_TYPE::ERR, "Impossible d'enregistrer le rapport d'exécution '%s'", reportName_.c_str());
+			}
+		}
+	}
+
+	// Le fichier détenu est informé du résultat avant sa libération
+	if (file_) {
+		file_->delivered(0 == errors && !failed_);
+	}
+
+	_clear();
+	return errors;
+}
+
+// Exécution d'un transfert
+//
+void deliveries::_run(LPDELIVERY item, std::function<bool()> transfer)
+{
+	std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
+	try {
+		item->done_ = transfer();
+	}
+	catch (...) {
+		item->done_ = false;
+	}
+
+	item->duration_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Libérations
+//
+void deliveries::_clear()
+{
+	for (deque<LPDELIVERY>::iterator it = items_.begin(); it != items_.end(); it++) {
+		if (*it) {
+			delete (*it);
+		}
+	}
+
+	items_.clear();
+
+	// Le fichier temporaire est supprimé avec son générateur
+	if (file_) {
+		delete file_;
+		file_ = nullptr;
+	}
+
+	if (opfi_) {
+		delete opfi_;
+		opfi_ = nullptr;
+	}
+
+	if (report_) {
+		delete report_;
+		report_ = nullptr;
+	}
+
+	if (profiler_) {
+		delete profiler_;
+		profiler_ = nullptr;
+	}
+}
+
+// EOF
@@ -0,0 +1,125 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: deliveries.h
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Définition de la classe deliveries
+//--
+//--			Transferts d'un fichier généré vers ses destinations.
+//--			En mode parallèle, chaque transfert s'exécute dans son propre
+//--			thread : une destination lente ne retarde plus les autres
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#ifndef __LDAP_2_FILE_DELIVERIES_h__
+#define __LDAP_2_FILE_DELIVERIES_h__   1
+
+#include "sharedConsts.h"
+#include "outputFile.h"
+#include "runReport.h"
+
+#include <thread>
+#include <functional>
+
+//----------------------------------------------------------------------
+//--
+//-- Définition de la classe
+//--
+//----------------------------------------------------------------------
+
+class deliveries
+{
+	// Méthodes publiques
+	//
+public:
+
+	// Construction
+	deliveries(logs* pLogs, bool parallel = true);
+
+	// Destruction
+	virtual ~deliveries();
+
+	// Un transfert de plus
+	//	il est lancé immédiatement (dans un nouveau thread en mode parallèle)
+	void add(fileDestination* dest, const char* fileName, size_t bytes, std::function<bool()> transfer);
+
+	// Nombre de transferts
+	size_t size()
+	{ return items_.size(); }
+
+	// Fichiers à libérer une fois tous les transferts terminés
+	//	failed : au moins un transfert n'a pu être lancé
+	void own(outputFile* file, OPFI* opfi, bool failed = false);
+
+	// Rapport d'exécution du fichier, complété puis enregistré à la fin des transferts
+	//	la liste devient propriétaire du rapport et des statistiques des requêtes
+	void ownReport(runReport* report, const string& fileName, int status, queryProfiler* profiler = nullptr);
+	bool reported()
+	{ return nullptr != report_; }
+
+	// Un transfert en cours utilise-t'il ce fichier (ou un fichier de même nom) ?
+	bool uses(const char* fileName);
+
+	// Attente de la fin de tous les transferts
+	//	les durées et volumes sont ajoutés à report (ou au rapport détenu)
+	//	retourne le nombre de transferts en erreur
+	size_t wait(runReport* report = nullptr);
+
+	// Méthodes privées
+	//
+protected:
+
+	// Un transfert
+	typedef struct tagDELIVERY
+	{
+		string			name_;			// Destination
+		DEST_TYPE		type_;
+		string			fileName_;		// Fichier transféré
+		size_t			bytes_;
+		std::thread		thread_;
+		bool			done_;			// Résultat
+		double			duration_;		// en ms
+	}DELIVERY,* LPDELIVERY;
+
+	// Exécution d'un transfert (dans le thread appelant)
+	static void _run(LPDELIVERY item, std::function<bool()> transfer);
+
+	void _clear();
+
+	// Données membres privées
+	//
+protected:
+	logs*				logs_;
+	bool				parallel_;
+
+	deque<LPDELIVERY>	items_;
+
+	outputFile*			file_;			// Fichier et paramètres détenus
+	OPFI*				opfi_;
+	bool				failed_;
+
+	runReport*			report_;		// Rapport détenu
+	string				reportName_;
+	int					status_;
+	queryProfiler*		profiler_;
+};
+
+#endif // #ifndef __LDAP_2_FILE_DELIVERIES_h__
+
+// EOF
@@ -0,0 +1,295 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: folderWatcher.cpp
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Implémentation de la classe folderWatcher
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#include "folderWatcher.h"
+
+#include "sFileSystem.h"
+
+#ifndef _WIN32
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <dirent.h>
+#endif // _WIN32
+
+//----------------------------------------------------------------------
+//--
+//-- Implémentation de la classe
+//--
+//----------------------------------------------------------------------
+
+// Construction
+//
+folderWatcher::folderWatcher(logs* pLogs)
+{
+	logs_ = pLogs;
+#ifdef _WIN32
+	handle_ = INVALID_HANDLE_VALUE;
+#else
+	fd_ = wd_ = -1;
+#endif // _WIN32
+}
+
+// Début de la surveillance
+//
+bool folderWatcher::open(const string& folder)
+{
+	close();
+
+	folder_ = sFileSystem::complete(folder);
+
+#ifdef _WIN32
+	if (INVALID_HANDLE_VALUE == (handle_ = FindFirstChangeNotification(folder_.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE))) {
+		logs_->add(logs::TRACE_TYPE::ERR, "Impossible de surveiller le dossier '%s'", folder_.c_str());
+		return false;
+	}
+
+	// Contenu initial
+	_scan(nullptr, nullptr);
+#else
+	if (-1 == (fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC))) {
+		logs_->add(logs::TRACE_TYPE::ERR, "Impossible d'initialiser inotify - Erreur : %d", errno);
+		return false;
+	}
+
+	if (-1 == (wd_ = inotify_add_watch(fd_, folder_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF))) {
+		logs_->add(logs::TRACE_TYPE::ERR, "Impossible de surveiller le dossier '%s' - Erreur : %d", folder_.c_str(), errno);
+		close();
+		return false;
+	}
+#endif // _WIN32
+
+	logs_->add(logs::TRACE_TYPE::LOG, "Surveillance du dossier '%s'", folder_.c_str());
+	return true;
+}
+
+// Fin de la surveillance
+//
+void folderWatcher::close()
+{
+#ifdef _WIN32
+	if (INVALID_HANDLE_VALUE != handle_) {
+		FindCloseChangeNotification(handle_);
+		handle_ = INVALID_HANDLE_VALUE;
+	}
+
+	files_.clear();
+#else
+	if (-1 != fd_) {
+		if (-1 != wd_) {
+			inotify_rm_watch(fd_, wd_);
+			wd_ = -1;
+		}
+
+		::close(fd_);
+		fd_ = -1;
+	}
+#endif // _WIN32
+}
+
+// Attente des modifications
+//
+folderWatcher::WAIT_RESULT folderWatcher::wait(int timeout, set<string>& changed, set<string>& removed)
+{
+#ifdef _WIN32
+	if (INVALID_HANDLE_VALUE == handle_) {
+		return WAIT_RESULT::WATCH_ERROR;
+	}
+
+	switch (WaitForSingleObject(handle_, (timeout < 0) ? INFINITE : (DWORD)timeout)) {
+	case WAIT_OBJECT_0:
+		// Quelque chose a changé => on relit le dossier
+		_scan(&changed, &removed);
+		if (TRUE == FindNextChangeNotification(handle_)) {
+			return WAIT_RESULT::WATCH_OK;
+		}
+		break;
+
+	case WAIT_TIMEOUT:
+		return WAIT_RESULT::WATCH_OK;
+
+	default:
+		break;
+	}
+
+	logs_->add(logs::TRACE_TYPE::ERR, "Erreur lors de la surveillance du dossier '%s' - Erreur : %d", folder_.c_str(), GetLastError());
+	return WAIT_RESULT::WATCH_ERROR;
+#else
+	if (-1 == fd_) {
+		return WAIT_RESULT::WATCH_ERROR;
+	}
+
+	struct pollfd pfd;
+	pfd.fd = fd_;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	int ret(poll(&pfd, 1, timeout));
+	if (ret < 0) {
+		if (EINTR == errno) {
+			// Signal => l'appelant décide s'il faut poursuivre
+			return WAIT_RESULT::WATCH_INTERRUPTED;
+		}
+
+		logs_->add(logs::TRACE_TYPE::ERR, "Erreur lors de la surveillance du dossier '%s' - Erreur : %d", folder_.c_str(), errno);
+		return WAIT_RESULT::WATCH_ERROR;
+	}
+
+	if (0 == ret) {
+		// Délai écoulé
+		return WAIT_RESULT::WATCH_OK;
+	}
+
+	// Lecture des évènements
+	char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event* event(nullptr);
+	ssize_t len(0);
+	string fullName("");
+	bool overflow(false);
+	for (;;) {
+		if ((len = read(fd_, buffer, sizeof(buffer))) <= 0) {
+			if (len < 0 && EINTR == errno) {
+				continue;
+			}
+
+			if (len < 0 && EAGAIN != errno && EWOULDBLOCK != errno) {
+				logs_->add(logs::TRACE_TYPE::ERR, "Erreur de lecture des modifications du dossier '%s' - Erreur : %d", folder_.c_str(), errno);
+				return WAIT_RESULT::WATCH_ERROR;
+			}
+
+			// Plus rien à lire
+			break;
+		}
+
+		for (char* ptr = buffer; ptr < buffer + len; ptr += sizeof(struct inotify_event) + event->len) {
+			event = (const struct inotify_event*)ptr;
+
+			// Le dossier a été supprimé ou déplacé
+			if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+				logs_->add(logs::TRACE_TYPE::ERR, "Le dossier '%s' n'est plus accessible", folder_.c_str());
+				return WAIT_RESULT::WATCH_ERROR;
+			}
+
+			// File d'attente du noyau pleine => des évènements ont été perdus
+			if (event->mask & IN_Q_OVERFLOW) {
+				overflow = true;
+				continue;
+			}
+
+			if (0 == event->len || (event->mask & IN_ISDIR) || _ignore(event->name)) {
+				continue;
+			}
+
+			fullName = sFileSystem::merge(folder_, event->name);
+			if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+				changed.insert(fullName);
+				removed.erase(fullName);
+			}
+			else {
+				if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+					removed.insert(fullName);
+					changed.erase(fullName);
+				}
+			}
+		}
+	}
+
+	if (overflow) {
+		logs_->add(logs::TRACE_TYPE::LOG, "Des modifications du dossier '%s' ont été perdues => relecture du dossier", folder_.c_str());
+		_scan(changed);
+	}
+
+	return WAIT_RESULT::WATCH_OK;
+#endif // _WIN32
+}
+
+#ifdef _WIN32
+// Lecture du dossier et comparaison avec le contenu précédent
+//
+void folderWatcher::_scan(set<string>* changed, set<string>* removed)
+{
+	map<string, ULONGLONG> files;
+	WIN32_FIND_DATA wfd;
+	HANDLE hFind(INVALID_HANDLE_VALUE);
+	string sDir(folder_ + "\\*.*"), fullName("");
+	ULARGE_INTEGER lastWrite;
+
+	if (INVALID_HANDLE_VALUE != (hFind = FindFirstFile(sDir.c_str(), &wfd))) {
+		do {
+			if (0 == (wfd.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_HIDDEN)) && !_ignore(wfd.cFileName)) {
+				fullName = sFileSystem::merge(folder_, wfd.cFileName);
+				lastWrite.LowPart = wfd.ftLastWriteTime.dwLowDateTime;
+				lastWrite.HighPart = wfd.ftLastWriteTime.dwHighDateTime;
+				files[fullName] = lastWrite.QuadPart;
+			}
+		} while (FindNextFile(hFind, &wfd) != 0);
+
+		FindClose(hFind);
+	}
+
+	// Nouveaux fichiers ou fichiers modifiés
+	if (changed) {
+		for (map<string, ULONGLONG>::iterator it = files.begin(); it != files.end(); it++) {
+			map<string, ULONGLONG>::iterator previous(files_.find(it->first));
+			if (files_.end() == previous || previous->second != it->second) {
+				changed->insert(it->first);
+			}
+		}
+	}
+
+	// Fichiers supprimés
+	if (removed) {
+		for (map<string, ULONGLONG>::iterator it = files_.begin(); it != files_.end(); it++) {
+			if (files.end() == files.find(it->first)) {
+				removed->insert(it->first);
+			}
+		}
+	}
+
+	files_ = files;
+}
+#else
+// Lecture du dossier
+//
+void folderWatcher::_scan(set<string>& changed)
+{
+	DIR* d(opendir(folder_.c_str()));
+	if (nullptr == d) {
+		return;
+	}
+
+	struct dirent* dir(nullptr);
+	while (nullptr != (dir = readdir(d))) {
+		if (DT_REG == dir->d_type && !_ignore(dir->d_name)) {
+			changed.insert(sFileSystem::merge(folder_, dir->d_name));
+		}
+	}
+
+	closedir(d);
+}
+#endif // _WIN32
+
+// EOF
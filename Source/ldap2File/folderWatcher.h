@@ -0,0 +1,103 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: folderWatcher.h
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Définition de la classe folderWatcher
+//--
+//--			Surveillance du dossier des fichiers de commandes (mode démon).
+//--			Sous Linux, les modifications sont notifiées par inotify ; sous
+//--			Windows le dossier est relu à chaque notification du système
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#ifndef __LDAP_2_FILE_FOLDER_WATCHER_h__
+#define __LDAP_2_FILE_FOLDER_WATCHER_h__   1
+
+#include "sharedConsts.h"
+
+//----------------------------------------------------------------------
+//--
+//-- Définition de la classe
+//--
+//----------------------------------------------------------------------
+
+class folderWatcher
+{
+	// Méthodes publiques
+	//
+public:
+
+	// Résultat de l'attente
+	enum class WAIT_RESULT { WATCH_OK = 0, WATCH_INTERRUPTED = 1, WATCH_ERROR = 2 };
+
+	// Construction
+	folderWatcher(logs* pLogs);
+
+	// Destruction
+	virtual ~folderWatcher()
+	{ close(); }
+
+	// Début de la surveillance
+	bool open(const string& folder);
+
+	// Fin de la surveillance
+	void close();
+
+	// Attente des modifications
+	//	timeout en ms (< 0 => pas de limite)
+	//	retourne WATCH_INTERRUPTED si l'attente a été interrompue par un signal
+	//	et WATCH_ERROR en cas d'erreur ou si le dossier n'est plus accessible
+	WAIT_RESULT wait(int timeout, set<string>& changed, set<string>& removed);
+
+	// Méthodes privées
+	//
+protected:
+
+	// Les fichiers cachés (fichiers temporaires des éditeurs) sont ignorés
+	bool _ignore(const char* name)
+	{ return (IS_EMPTY(name) || '.' == name[0]); }
+
+#ifdef _WIN32
+	// Lecture du dossier et comparaison avec le contenu précédent
+	void _scan(set<string>* changed, set<string>* removed);
+#else
+	// Lecture du dossier (des évènements ont été perdus)
+	//	tous les fichiers sont considérés comme modifiés
+	void _scan(set<string>& changed);
+#endif // _WIN32
+
+	// Données membres privées
+	//
+protected:
+	logs*				logs_;
+	string				folder_;
+
+#ifdef _WIN32
+	HANDLE				handle_;
+	map<string, ULONGLONG>	files_;		// Nom => date de dernière modification
+#else
+	int					fd_;			// inotify
+	int					wd_;			// Dossier surveillé
+#endif // _WIN32
+};
+
+#endif // #ifndef __LDAP_2_FILE_FOLDER_WATCHER_h__
+
+// EOF
@@ -77,6 +77,18 @@ namespace jhbLDAPTools {
 	//--
 	//---------------------------------------------------------------------------
 
+	// Construction par copie
+	//	chaque dossier est dupliqué
+	//
+	folders::folders(const folders& other)
+	{
+		for (list<folders::folder*>::const_iterator i = other.folders_.begin(); i != other.folders_.end(); i++) {
+			if (*i) {
+				folders_.push_back(new folders::folder(*(*i)));
+			}
+		}
+	}
+
 	// Destruction
 	//
 	folders::~folders()
@@ -105,6 +105,7 @@ namespace jhbLDAPTools {
 		// Construction et destruction
 		//
 		folders(){}
+		folders(const folders& other);
 		virtual ~folders();
 
 		// Nombre d'elements
@@ -24,6 +24,8 @@
 //--		-c - Effacement des fichiers après traitement
 //--		-f:{min} - Annalyse régulière (si pas de suppression) toutes les {min}
 //--		-d:{directory} - Annalyse de tous les fichiers contenus dans {directory}
+//--		-j:{n} - Traitement simultané des fichiers par {n} threads
+//--		-w - Mode démon : surveillance du dossier {directory}
 //--
 //--		+ Analyse répétitive d'un dossier : -d:C:\ldapTools\web -f:15 -s
 //--
@@ -47,21 +49,73 @@
 #include "LDAPBrowser.h"
 
 #include "XMLParser.h"
+#include "folderWatcher.h"
+
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <csignal>
 
 #ifndef _WIN32
 #include <dirent.h>		// Gestion des repertoires
 #include <ctime>
 #endif // _WIN32
 
+//
+// Types
+//
+
+// Environnement d'un thread de traitement
+//	il est conservé d'une analyse à l'autre (option -f) : la connexion LDAP,
+//	les listes en cache et les sessions FTP du LDAPBrowser sont réutilisées
+//
+typedef struct tagWORKER
+{
+	tagWORKER(folders* pFolders, logs* pLogs)
+	: folders_(*pFolders), configurationFile_(&folders_, pLogs){
+		requester_ = nullptr;
+	}
+
+	virtual ~tagWORKER(){
+		if (requester_) {
+			delete requester_;
+		}
+	}
+
+	folders			folders_;				// confFile::open met à jour les dossiers => copie
+	confFile		configurationFile_;
+	LDAPBrowser*	requester_;
+}WORKER;
+
+// Environnements de tous les threads (un par index de thread)
+//
+typedef struct tagWORKERS
+{
+	virtual ~tagWORKERS(){
+		for (deque<WORKER*>::iterator it = items_.begin(); it != items_.end(); it++) {
+			if (*it) {
+				delete (*it);
+			}
+		}
+
+		items_.clear();
+	}
+
+	deque<WORKER*>	items_;
+}WORKERS;
+
 //
 // Prototypes
 //
+bool _browseFiles(list<string>& files, size_t jobs, WORKERS& workers, folders* pFolders, logs* pLogs, const string& confFileName, bool& removeFile, size_t& filesGenerated, bool& mailErrors);
 bool _checkCurrentVersion(string& error);
+string _fileStatus(RET_TYPE retType, bool& generated, bool& blocking, bool& removeFile);
 bool _getFolderContent(const string& source, list<string>& content, logs* pLogs);
 int _getTickCount();
 void _now();
 bool _updateConfigurationFile(string path);
 void _usage();
+int _watchFolder(const string& folder, list<string>& files, int freq, bool removeFile, LDAPBrowser& requester, confFile& configurationFile, logs* pLogs, size_t& filesGenerated);
 
 //
 // Fonctions
@@ -303,8 +357,8 @@ int main(int argc, const char* argv[]) {
 	size_t filesGenerated(0);
 
 	try {
-		int freq(0);
-		bool removeFile(false);
+		int freq(0), jobs(1);
+		bool removeFile(false), watch(false);
 		string remoteFolder("");
 
 		//
@@ -340,8 +394,20 @@ int main(int argc, const char* argv[]) {
 								// Déja lu ...
 							}
 							else {
-								// Un fichier ...
-								files.push_back(sFileSystem::complete(argv[index]));
+								if (argv[index] == strstr(argv[index], CMD_LINE_JOBS)) {
+									// Nombre de fichiers traités simultanément
+									jobs = atoi(argv[index] + strlen(CMD_LINE_JOBS));
+								}
+								else {
+									if (0 == strcmp(argv[index], CMD_LINE_WATCH)) {
+										// Mode démon
+										watch = true;
+									}
+									else {
+										// Un fichier ...
+										files.push_back(sFileSystem::complete(argv[index]));
+									}
+								}
 							}
 						}
 					}
@@ -365,18 +431,41 @@ int main(int argc, const char* argv[]) {
 			}
 		}
 
-		bool done(0 == files.size());
+		// Le mode démon nécessite un dossier
+		if (watch && 0 == remoteFolder.size()) {
+			cout << "Pas de dossier à surveiller - Le mode démon est ignoré" << endl;
+			myLogs.add(logs::TRACE_TYPE::ERR, "Pas de dossier à surveiller - Le mode démon est ignoré");
+			watch = false;
+		}
+
+		bool done(0 == files.size() && !watch);
 
 		// Analyse des fichiers de commandes
 		//
 		int currentLaunchTime(0);
 		LDAPBrowser requester(&myLogs, &configurationFile);
+		WORKERS workers;		// Threads de traitement (option -j)
 		RET_TYPE retType(RET_TYPE::RET_INVALID_FILE);
 		std::string shortName("");
+		bool generated(false), blocking(false), parallel(false), mailErrors(false);
 		while (!done && 0 == retCode) {
 			currentLaunchTime = _getTickCount();
 
-			for (list<string>::iterator it = files.begin(); 0 == retCode && it != files.end(); it++) {
+			// Traitement simultané par plusieurs threads
+			parallel = (jobs > 1 && files.size() > 1);
+			if (parallel) {
+				_now();
+				if (false == _browseFiles(files, (size_t)jobs, workers, &myFolders, &myLogs, file, removeFile, filesGenerated, mailErrors)) {
+					retCode = 1;
+				}
+
+				if (removeFile) {
+					// Il ne peut pas y avoir d'analyse régulière ...
+					freq = 0;
+				}
+			}
+
+			for (list<string>::iterator it = files.begin(); !parallel && 0 == retCode && it != files.end(); it++) {
 
                 _now();
 
@@ -388,82 +477,19 @@ int main(int argc, const char* argv[]) {
 				retType = RET_TYPE::RET_INVALID_FILE;
 
 				// Génération du fichier en question
-				if (configurationFile.openCommandFile((*it).c_str(), retType) &&
-					RET_TYPE::RET_OK == (retType = requester.browse())) {
-					cout << " - [ok]";
+				if (configurationFile.openCommandFile((*it).c_str(), retType)) {
+					retType = requester.browse();
+				}
+
+				generated = blocking = false;
+				cout << _fileStatus(retType, generated, blocking, removeFile) << endl;
+				if (generated) {
 					filesGenerated++;
 				}
-				else {
-					cout << " - [ko] - ";
-					switch (retType) {
-					case RET_TYPE::RET_ACCESS_ERROR:
-                        cout << "Erreur d'accès";
-					    break;
-
-                    case RET_TYPE::RET_ALLOCATION_ERROR:
-                        cout << "Erreur d'allocation mémoire";
-					    break;
-
-					case RET_TYPE::RET_INVALID_FILE:
-					    cout << "Le fichier n'existe pas ou est vide";
-					    break;
-
-                    case RET_TYPE::RET_INCOMPLETE_FILE:
-                        cout << "Le fichier (conf ou commande) n'est pas complet";
-					    break;
-
-                    case RET_TYPE::RET_INVALID_XML_VERSION:
-					    cout << "Version XML incorrecte dans les fichiers";
-					    break;
-
-					case RET_TYPE::RET_INVALID_PARAMETERS:
-						cout << "Paramètres invalides";
-						break;
-
-					case RET_TYPE::RET_ERROR_NO_DESTINATION:
-						cout << "Pas de destination valide";
-						break;
-
-					case RET_TYPE::RET_INVALID_OUTPUT_FORMAT:
-						cout << "Format de fichier de sortie inconnu";
-						break;
-
-					case RET_TYPE::RET_FILE_TO_DELETE:
-						cout << "La date limite est dépassée - Le fichier doit être supprimé";
-						removeFile = true;
-						break;
-
-					case RET_TYPE::RET_NON_BLOCKING_ERROR:
-						cout << "Erreur(s) non bloquante(s)";
-						filesGenerated++;	// L'erreur n'a pas empêchée la génération du fichier
-						break;
-
-					case RET_TYPE::RET_LDAP_ERROR:
-						cout << "Erreur LDAP";
-						retCode = 1;            // L'erreur est bloquante (pas de connexion au serveur ...)
-						break;
-
-					case RET_TYPE::RET_UNABLE_TO_SAVE:
-						cout << "Erreur de sauvegarde de fichier";
-						break;
-
-					case RET_TYPE::RET_NO_SUCH_CONTAINER_ERROR:
-						cout << "Critère de recherche invalide";
-						break;
-
-					case RET_TYPE::RET_ERROR_NO_CONTAINER:
-						cout << "Aucun container trouvé dans l'Annuaire";
-						break;
-
-					case RET_TYPE::RET_BLOCKING_ERROR:
-					default:
-						cout << "Erreur(s) bloquante(s)";
-						retCode = 1;
-						break;
-					} // switch
-				} // else
-
-				cout << endl;
+
+				if (blocking) {
+					retCode = 1;            // L'erreur est bloquante (pas de connexion au serveur ...)
+				}
 
 				// Suppression du fichier de commandes
 				if (removeFile) {
@@ -476,6 +502,17 @@ int main(int argc, const char* argv[]) {
 				}
 			} // for
 
+			// Fin des transferts et envoi des mails en attente
+			if (!requester.flush()) {
+				mailErrors = true;
+			}
+
+			// Mode démon : les traitements suivants sont déclenchés par les modifications du dossier
+			if (watch && 0 == retCode) {
+				retCode = _watchFolder(remoteFolder, files, freq, removeFile, requester, configurationFile, &myLogs, filesGenerated);
+				freq = 0;
+			}
+
 			if (freq) {
 				// On attend un peu
 				_now();
@@ -500,6 +537,12 @@ int main(int argc, const char* argv[]) {
 				done = true;
 			}
 		}
+
+		// Des mails n'ont pas été envoyés
+		if (mailErrors && 0 == retCode) {
+			myLogs.add(logs::TRACE_TYPE::ERR, "Des mails n'ont pas pu être envoyés");
+			retCode = 1;
+		}
 	}
 	catch (LDAPException& e) {
 		// Une ereur bloquante
@@ -531,6 +574,479 @@ int main(int argc, const char* argv[]) {
 	return retCode;
 }
 
+// Compte-rendu du traitement d'un fichier de commandes
+//
+string _fileStatus(RET_TYPE retType, bool& generated, bool& blocking, bool& removeFile)
+{
+	if (RET_TYPE::RET_OK == retType) {
+		generated = true;
+		return " - [ok]";
+	}
+
+	string status(" - [ko] - ");
+	switch (retType) {
+	case RET_TYPE::RET_ACCESS_ERROR:
+		status += "Erreur d'accès";
+		break;
+
+	case RET_TYPE::RET_ALLOCATION_ERROR:
+		status += "Erreur d'allocation mémoire";
+		break;
+
+	case RET_TYPE::RET_INVALID_FILE:
+		status += "Le fichier n'existe pas ou est vide";
+		break;
+
+	case RET_TYPE::RET_INCOMPLETE_FILE:
+		status += "Le fichier (conf ou commande) n'est pas complet";
+		break;
+
+	case RET_TYPE::RET_INVALID_XML_VERSION:
+		status += "Version XML incorrecte dans les fichiers";
+		break;
+
+	case RET_TYPE::RET_INVALID_PARAMETERS:
+		status += "Paramètres invalides";
+		break;
+
+	case RET_TYPE::RET_ERROR_NO_DESTINATION:
+		status += "Pas de destination valide";
+		break;
+
+	case RET_TYPE::RET_INVALID_OUTPUT_FORMAT:
+		status += "Format de fichier de sortie inconnu";
+		break;
+
+	case RET_TYPE::RET_FILE_TO_DELETE:
+		status += "La date limite est dépassée - Le fichier doit être supprimé";
+		removeFile = true;
+		break;
+
+	case RET_TYPE::RET_NON_BLOCKING_ERROR:
+		status += "Erreur(s) non bloquante(s)";
+		generated = true;	// L'erreur n'a pas empêchée la génération du fichier
+		break;
+
+	case RET_TYPE::RET_LDAP_ERROR:
+		status += "Erreur LDAP";
+		blocking = true;	// L'erreur est bloquante (pas de connexion au serveur ...)
+		break;
+
+	case RET_TYPE::RET_UNABLE_TO_SAVE:
+		status += "Erreur de sauvegarde de fichier";
+		break;
+
+	case RET_TYPE::RET_NO_SUCH_CONTAINER_ERROR:
+		status += "Critère de recherche invalide";
+		break;
+
+	case RET_TYPE::RET_ERROR_NO_CONTAINER:
+		status += "Aucun container trouvé dans l'Annuaire";
+		break;
+
+	case RET_TYPE::RET_BLOCKING_ERROR:
+	default:
+		status += "Erreur(s) bloquante(s)";
+		blocking = true;
+		break;
+	} // switch
+
+	return status;
+}
+
+// Traitement simultané des fichiers de commandes
+//
+typedef struct tagJOBS
+{
+	WORKERS*				workers_;		// Environnements des threads
+	folders*				folders_;		// Dossiers de l'application (copiés par chaque thread)
+	logs*					logs_;			// Logs partagés
+	string					confFile_;		// Fichier de configuration (ouvert par chaque thread)
+	bool					removeFile_;	// Suppression des fichiers après traitement
+
+	std::mutex				mutex_;			// Protège les données suivantes et la console
+	list<string>::iterator	next_;			// Prochain fichier à traiter
+	list<string>::iterator	end_;
+	size_t					generated_;		// Fichiers générés
+	bool					removed_;		// Au moins un fichier a été supprimé
+	bool					stop_;			// Erreur bloquante => plus de nouveau fichier
+	bool					mailErrors_;	// Des mails ont été refusés
+}JOBS;
+
+// Un thread de traitement
+//	chaque thread dispose de sa propre configuration, de son propre LDAPBrowser
+//	et donc de sa propre connexion LDAP. Cet environnement est créé lors de la
+//	première analyse puis réutilisé par le thread de même index
+//
+void _browseJob(JOBS* jobs, size_t index)
+{
+	string tag("job ");
+	tag += charUtils::itoa((int)index + 1);
+	logs::setTag(tag.c_str());
+
+	WORKER* worker(jobs->workers_->items_[index]);
+	if (nullptr == worker) {
+		try {
+			worker = new WORKER(jobs->folders_, jobs->logs_);
+			if (worker->configurationFile_.open(jobs->confFile_.c_str())) {
+				// Fichiers temporaires propres au thread (fichiers générés, contenu et archive ODS, pièces jointes en attente)
+				//	deux fichiers de commandes peuvent produire des fichiers de même nom
+				folders::folder* tempFolder(worker->folders_.find(folders::FOLDER_TYPE::FOLDER_TEMP));
+				string jobFolder(sFileSystem::merge(tempFolder ? tempFolder->path() : sFileSystem::current_path().c_str(), JOB_TEMP_FOLDER + charUtils::itoa((int)index + 1)));
+				if (!worker->folders_.add(folders::FOLDER_TYPE::FOLDER_TEMP, jobFolder)
+					|| nullptr == (tempFolder = worker->folders_.find(folders::FOLDER_TYPE::FOLDER_TEMP)) || !tempFolder->exists()) {
+					string error("Impossible de créer le dossier temporaire '" + jobFolder + "'");
+					throw LDAPException(error, RET_TYPE::RET_ACCESS_ERROR);
+				}
+
+				worker->requester_ = new LDAPBrowser(jobs->logs_, &worker->configurationFile_);
+			}
+		}
+		catch (LDAPException& e) {
+			jobs->logs_->add(logs::TRACE_TYPE::ERR, "Erreur : %s", e.what());
+		}
+		catch (...) {
+			jobs->logs_->add(logs::TRACE_TYPE::ERR, "Erreur inconnue");
+		}
+
+		if (worker && nullptr == worker->requester_) {
+			delete worker;
+			worker = nullptr;
+		}
+
+		jobs->workers_->items_[index] = worker;
+	}
+
+	LDAPBrowser* requester(worker ? worker->requester_ : nullptr);
+	if (nullptr == requester) {
+		jobs->logs_->add(logs::TRACE_TYPE::ERR, "Impossible d'initialiser le thread de traitement");
+
+		std::lock_guard<std::mutex> lock(jobs->mutex_);
+		jobs->stop_ = true;
+		logs::setTag(nullptr);
+		return;
+	}
+
+	confFile& configurationFile(worker->configurationFile_);
+	string fileName(""), shortName(""), status("");
+	RET_TYPE retType(RET_TYPE::RET_INVALID_FILE);
+	bool generated(false), blocking(false), removeFile(false);
+	for (;;) {
+		// Prochain fichier
+		{
+			std::lock_guard<std::mutex> lock(jobs->mutex_);
+			if (jobs->stop_ || jobs->next_ == jobs->end_) {
+				break;
+			}
+
+			fileName = (*jobs->next_);
+			jobs->next_++;
+		}
+
+		// Les lignes de logs sont préfixées par le nom du fichier
+		shortName = sFileSystem::split(fileName);
+		logs::setTag(shortName.c_str());
+
+		// Par défaut le fichier n'est pas bon ...
+		retType = RET_TYPE::RET_INVALID_FILE;
+
+		try {
+			if (configurationFile.openCommandFile(fileName.c_str(), retType)) {
+				retType = requester->browse();
+			}
+		}
+		catch (LDAPException& e) {
+			jobs->logs_->add(logs::TRACE_TYPE::ERR, e.what());
+			retType = RET_TYPE::RET_BLOCKING_ERROR;
+		}
+		catch (...) {
+			jobs->logs_->add(logs::TRACE_TYPE::ERR, "Erreur inconnue");
+			retType = RET_TYPE::RET_BLOCKING_ERROR;
+		}
+
+		generated = blocking = false;
+		removeFile = jobs->removeFile_;
+		status = _fileStatus(retType, generated, blocking, removeFile);
+
+		// Suppression du fichier de commandes
+		if (removeFile) {
+#ifndef _DEBUG
+			sFileSystem::remove(fileName);
+#endif // #ifndef _DEBUG
+		}
+
+		// Compte-rendu
+		std::lock_guard<std::mutex> lock(jobs->mutex_);
+		cout << shortName << status << endl;
+
+		if (generated) {
+			jobs->generated_++;
+		}
+
+		if (removeFile) {
+			jobs->removed_ = true;
+		}
+
+		if (blocking) {
+			jobs->stop_ = true;
+		}
+	}
+
+	// Fin des transferts et envoi des mails en attente
+	logs::setTag(tag.c_str());
+	//	le LDAPBrowser est conservé pour l'analyse suivante
+	if (!requester->flush()) {
+		std::lock_guard<std::mutex> lock(jobs->mutex_);
+		jobs->mailErrors_ = true;
+	}
+
+	logs::setTag(nullptr);
+}
+
+// Traitement des fichiers de commandes par plusieurs threads
+//	retourne false en cas d'erreur bloquante
+//
+bool _browseFiles(list<string>& files, size_t jobs, WORKERS& workers, folders* pFolders, logs* pLogs, const string& confFileName, bool& removeFile, size_t& filesGenerated, bool& mailErrors)
+{
+	JOBS context;
+	context.workers_ = &workers;
+	context.folders_ = pFolders;
+	context.logs_ = pLogs;
+	context.confFile_ = confFileName;
+	context.removeFile_ = removeFile;
+	context.next_ = files.begin();
+	context.end_ = files.end();
+	context.generated_ = 0;
+	context.removed_ = false;
+	context.stop_ = false;
+	context.mailErrors_ = false;
+
+	if (jobs > files.size()) {
+		jobs = files.size();
+	}
+
+	pLogs->add(logs::TRACE_TYPE::LOG, "Traitement de %u fichier(s) par %u thread(s)", (unsigned int)files.size(), (unsigned int)jobs);
+
+	// Les environnements sont créés par les threads eux-mêmes
+	//	la liste ne doit plus être redimensionnée pendant leur exécution
+	while (workers.items_.size() < jobs) {
+		workers.items_.push_back(nullptr);
+	}
+
+	// libCURL doit être initialisée avant la création des threads
+	jhbCURLTools::CURLHandle::instance();
+
+	deque<std::thread> threads;
+	for (size_t index = 0; index < jobs; index++) {
+		try {
+			threads.push_back(std::thread(_browseJob, &context, index));
+		}
+		catch (...) {
+			pLogs->add(logs::TRACE_TYPE::ERR, "Impossible de lancer le thread de traitement n°%u", (unsigned int)(index + 1));
+			break;
+		}
+	}
+
+	// Aucun thread => traitement dans le thread courant
+	if (0 == threads.size()) {
+		_browseJob(&context, 0);
+	}
+
+	for (deque<std::thread>::iterator it = threads.begin(); it != threads.end(); it++) {
+		if ((*it).joinable()) {
+			(*it).join();
+		}
+	}
+
+	filesGenerated += context.generated_;
+	if (context.removed_) {
+		removeFile = true;
+	}
+
+	if (context.mailErrors_) {
+		mailErrors = true;
+	}
+
+	return !context.stop_;
+}
+
+// Mode démon
+//
+
+// Arrêt demandé (SIGINT, SIGTERM)
+static volatile sig_atomic_t _stopWatching(0);
+
+void _onStopSignal(int)
+{
+	_stopWatching = 1;
+}
+
+// Surveillance du dossier des fichiers de commandes
+//	les fichiers ajoutés ou modifiés sont traités dès leur enregistrement et,
+//	si une fréquence est définie, chaque fichier est régénéré à sa propre échéance.
+//	Le LDAPBrowser (et donc la connexion LDAP et les listes en cache) est conservé entre deux traitements
+//
+int _watchFolder(const string& folder, list<string>& files, int freq, bool removeFile, LDAPBrowser& requester, confFile& configurationFile, logs* pLogs, size_t& filesGenerated)
+{
+	folderWatcher watcher(pLogs);
+	if (!watcher.open(folder)) {
+		cout << "Impossible de surveiller le dossier '" << folder << "'" << endl;
+		return 1;
+	}
+
+	signal(SIGINT, _onStopSignal);
+	signal(SIGTERM, _onStopSignal);
+
+	cout << "Surveillance du dossier '" << folder << "'" << endl;
+
+	// Prochaine échéance de chaque fichier
+	typedef std::chrono::steady_clock::time_point TIME_POINT;
+	map<string, TIME_POINT> schedule;
+	TIME_POINT now(std::chrono::steady_clock::now());
+	if (freq) {
+		for (list<string>::iterator it = files.begin(); it != files.end(); it++) {
+			schedule[(*it)] = now + std::chrono::milliseconds(freq);
+		}
+	}
+
+	// Délai avant de retraiter un fichier en erreur bloquante (sans analyse régulière)
+	map<string, int> retries;
+
+	set<string> changed, removed;
+	list<string> due;
+	int timeout(-1), retCode(0);
+	folderWatcher::WAIT_RESULT waited(folderWatcher::WAIT_RESULT::WATCH_OK);
+	RET_TYPE retType(RET_TYPE::RET_INVALID_FILE);
+	bool generated(false), blocking(false), remove(false), mailErrors(false);
+	while (!_stopWatching) {
+		// Attente jusqu'à la prochaine échéance
+		timeout = -1;
+		now = std::chrono::steady_clock::now();
+		for (map<string, TIME_POINT>::iterator it = schedule.begin(); it != schedule.end(); it++) {
+			int delay((it->second > now) ? (int)std::chrono::duration_cast<std::chrono::milliseconds>(it->second - now).count() : 0);
+			if (timeout < 0 || delay < timeout) {
+				timeout = delay;
+			}
+		}
+
+#ifdef _WIN32
+		// Les signaux n'interrompent pas l'attente
+		if (timeout < 0 || timeout > WATCH_DELAY) {
+			timeout = WATCH_DELAY;
+		}
+#endif // _WIN32
+
+		changed.clear();
+		removed.clear();
+		if (folderWatcher::WAIT_RESULT::WATCH_ERROR == (waited = watcher.wait(timeout, changed, removed))) {
+			cout << "Erreur lors de la surveillance du dossier '" << folder << "'" << endl;
+			retCode = 1;
+			break;
+		}
+
+		if (folderWatcher::WAIT_RESULT::WATCH_INTERRUPTED == waited) {
+			// Signal => on ne s'arrête que sur demande
+			continue;
+		}
+
+		now = std::chrono::steady_clock::now();
+
+		// Fichiers supprimés
+		for (set<string>::iterator it = removed.begin(); it != removed.end(); it++) {
+			retries.erase((*it));
+			if (schedule.erase((*it))) {
+				pLogs->add(logs::TRACE_TYPE::LOG, "Le fichier '%s' a été supprimé", (*it).c_str());
+			}
+		}
+
+		// Fichiers ajoutés ou modifiés => traitement après un court délai (plusieurs écritures successives)
+		for (set<string>::iterator it = changed.begin(); it != changed.end(); it++) {
+			pLogs->add(logs::TRACE_TYPE::LOG, "Le fichier '%s' a été ajouté ou modifié", (*it).c_str());
+			schedule[(*it)] = now + std::chrono::milliseconds(WATCH_DELAY);
+			retries.erase((*it));
+		}
+
+		// Fichiers à traiter
+		due.clear();
+		for (map<string, TIME_POINT>::iterator it = schedule.begin(); it != schedule.end(); it++) {
+			if (it->second <= now) {
+				due.push_back(it->first);
+			}
+		}
+
+		for (list<string>::iterator it = due.begin(); !_stopWatching && it != due.end(); it++) {
+			// Supprimé entre temps (évènements perdus)
+			if (!sFileSystem::exists((*it))) {
+				schedule.erase((*it));
+				retries.erase((*it));
+				continue;
+			}
+
+			_now();
+			cout << sFileSystem::split((*it));
+			cout.flush();
+
+			retType = RET_TYPE::RET_INVALID_FILE;
+			try {
+				if (configurationFile.openCommandFile((*it).c_str(), retType)) {
+					retType = requester.browse();
+				}
+			}
+			catch (LDAPException& e) {
+				pLogs->add(logs::TRACE_TYPE::ERR, e.what());
+				retType = RET_TYPE::RET_BLOCKING_ERROR;
+			}
+
+			// Une erreur bloquante n'arrête pas le démon : le fichier sera traité à nouveau
+			generated = blocking = false;
+			remove = removeFile;
+			cout << _fileStatus(retType, generated, blocking, remove) << endl;
+			if (generated) {
+				filesGenerated++;
+			}
+
+			if (blocking && 0 == freq) {
+				// Nouvelle tentative, de plus en plus espacée
+				int& delay(retries[(*it)]);
+				delay = (0 == delay) ? WATCH_RETRY_DELAY : ((delay > WATCH_RETRY_MAX_DELAY / 2) ? WATCH_RETRY_MAX_DELAY : 2 * delay);
+				schedule[(*it)] = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+				pLogs->add(logs::TRACE_TYPE::LOG, "Nouvelle tentative pour le fichier '%s' dans %d s", (*it).c_str(), delay / 1000);
+				continue;
+			}
+
+			retries.erase((*it));
+			if (remove) {
+#ifndef _DEBUG
+				sFileSystem::remove((*it));
+#endif // #ifndef _DEBUG
+				schedule.erase((*it));
+			}
+			else {
+				if (freq) {
+					schedule[(*it)] = std::chrono::steady_clock::now() + std::chrono::milliseconds(freq);
+				}
+				else {
+					schedule.erase((*it));
+				}
+			}
+		}
+
+		// Fin des transferts et envoi des mails en attente
+		if (due.size() && !requester.flush()) {
+			mailErrors = true;
+		}
+	}
+
+	watcher.close();
+
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+
+	cout << "Fin de la surveillance du dossier '" << folder << "'" << endl;
+	pLogs->add(logs::TRACE_TYPE::LOG, "Fin de la surveillance du dossier '%s'", folder.c_str());
+	return (0 == retCode && mailErrors) ? 1 : retCode;
+}
+
 // Lecture du contenu d'un dossier
 //
 bool _getFolderContent(const string& srcPath, list<string>& content, logs* pLogs)
@@ -614,9 +1130,14 @@ bool _getFolderContent(const string& srcPath, list<string>& content, logs* pLogs
 void _now()
 {
 	time_t now = time(0);
-	tm *ltm = localtime(&now);
+	tm ltm;
+#ifdef _WIN32
+	localtime_s(&ltm, &now);
+#else
+	localtime_r(&now, &ltm);
+#endif // _WIN32
 
-	cout << std::setfill('0') << std::setw(2) << ltm->tm_hour << ":" << std::setfill('0') << std::setw(2) << ltm->tm_min << ":" << std::setfill('0') << std::setw(2) << ltm->tm_sec << " - ";
+	cout << std::setfill('0') << std::setw(2) << ltm.tm_hour << ":" << std::setfill('0') << std::setw(2) << ltm.tm_min << ":" << std::setfill('0') << std::setw(2) << ltm.tm_sec << " - ";
 }
 
 // Durée depuis le lancement de l'OS
@@ -794,11 +1315,13 @@ bool _updateConfigurationFile(string path)
 //
 void _usage()
 {
-	cout << "\n" << APP_FULL_NAME << " {files or folder} [-base:{folder}] [-d:{folder}] [-f:{freq}] [-o:{output filename}] [-c] [-s]" << endl;
+	cout << "\n" << APP_FULL_NAME << " {files or folder} [-base:{folder}] [-d:{folder}] [-f:{freq}] [-j:{n}] [-w] [-o:{output filename}] [-c] [-s]" << endl;
 	cout << "\n\t {files or folder} : Listes des fichiers de commande à traiter. Lorsqu'un seul nom est fourni, et qu'il s'agit d'un dossier, tout le contenu du dossier sera traité (identique à -d:{folder})" << endl;
 	cout << "\n\t -base:{folder} : Le dossier 'folder' est considéré comme le dossier de l'application. Par défaut, le dossier de l'application est celui dans lequel se trouve le binaire." << endl;
 	cout << "\n\t -d:{folder} : Analyse de tous les fichiers de commandes contenus dans le dossier {folder}" << endl;
 	cout << "\n\t -f:{freq} : Analyse périodique des fichiers et des dossiers. Freq est la fréquence d'analyse en minutes" << endl;
+	cout << "\n\t -j:{n} : Traitement simultané des fichiers de commandes par {n} threads. Chaque thread utilise sa propre connexion LDAP" << endl;
+	cout << "\n\t -w : Mode démon. Le dossier est surveillé et chaque fichier de commandes ajouté ou modifié est traité immédiatement. Avec -f, chaque fichier est de plus traité à sa propre fréquence" << endl;
 	cout << "\n\t -o:{output-file} : Le fichier généré sera renommé en {output-file] même si le fichier de commande indique une autre destination" << endl;
 	cout << "\n\t -c : Suppression du fichier de commande après traitements" << endl;
 	cout << "\n\t -s : Windows uniquement = pas de MessageBox" << endl;
@@ -813,6 +1336,12 @@ void _usage()
 
 	cout << "\n- Traitement des 5 fichiers passes en ligne de commande ! " << endl;
 	cout << "\n\t" << APP_FULL_NAME << " file1.xml file2.xml file3.xml file4.xml file5.xml" << endl;
+
+	cout << "\n- Traitement des fichiers de commande du dossier ~/ldap2Files/datas par 8 threads:" << endl;
+	cout << "\n\t" << APP_FULL_NAME << " -d:~/ldap2Files/datas -j:8" << endl;
+
+	cout << "\n- Surveillance du dossier ~/ldap2Files/datas, chaque fichier étant de plus régénéré toutes les heures:" << endl;
+	cout << "\n\t" << APP_FULL_NAME << " -d:~/ldap2Files/datas -w -f:60" << endl;
 }
 
 // EOF
@@ -0,0 +1,221 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: mailQueue.cpp
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Implémentation de la classe mailQueue
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#include "mailQueue.h"
+
+#include "sFileSystem.h"
+#include "./CURLTools/SMTPClient.h"
+
+//----------------------------------------------------------------------
+//--
+//-- Implémentation de la classe
+//--
+//----------------------------------------------------------------------
+
+// Construction
+//
+mailQueue::mailQueue(logs* pLogs, const string& spoolFolder)
+{
+	logs_ = pLogs;
+	spool_ = spoolFolder;
+}
+
+// Mise en attente d'un envoi
+//
+bool mailQueue::add(mailDestination* dest, const char* fileName, size_t fileID, int timeout)
+{
+	if (nullptr == dest || IS_EMPTY(fileName) || 0 == strlen(dest->folder())) {
+		return false;
+	}
+
+	string shortName(sFileSystem::split(fileName));
+
+	// Connexion au serveur
+	string server(dest->smtpServer());
+	server += ":";
+	server += charUtils::itoa(dest->smtpPort());
+	server += ":";
+	server += dest->smtpUser();
+	server += ":";
+	server += dest->smtpPwd();
+	server += (dest->useTLS() ? ":tls" : "");
+
+	// Le message
+	string key(server);
+	key += "|";
+	key += dest->smtpFrom();
+	key += "|";
+	key += dest->smtpObject();
+	key += "|";
+	key += charUtils::itoa((int)fileID);
+
+	// Un message existe déjà pour ce fichier ?
+	for (deque<LPMAILMESSAGE>::iterator it = messages_.begin(); it != messages_.end(); it++) {
+		if ((*it) && (*it)->key_ == key) {
+			(*it)->recipients_.push_back(dest->folder());
+			if (timeout > (*it)->timeout_) {
+				(*it)->timeout_ = timeout;
+			}
+
+			logs_->add(logs::TRACE_TYPE::NORMAL, "Envoi par mail à '%s' ajouté au message en attente pour '%s'", dest->folder(), shortName.c_str());
+			return true;
+		}
+	}
+
+	// Le fichier temporaire sera supprimé avant l'envoi => copie
+	//	l'identifiant est propre au LDAPBrowser et chaque thread de traitement a son propre dossier temporaire
+	//	(et donc sa propre file) => pas de collision entre deux fichiers de commandes
+	map<size_t, string>::iterator file = files_.find(fileID);
+	if (files_.end() == file) {
+		string copy(sFileSystem::merge(spool_, "mail_" + charUtils::itoa((int)fileID) + "_" + shortName));
+		if (!sFileSystem::copy_file(fileName, copy)) {
+			logs_->add(logs::TRACE_TYPE::ERR, "Impossible de conserver le fichier '%s' pour l'envoi par mail", fileName);
+			return false;
+		}
+
+		file = files_.insert(std::pair<size_t, string>(fileID, copy)).first;
+	}
+
+	LPMAILMESSAGE message(nullptr);
+	if (nullptr == (message = new MAILMESSAGE)) {
+		return false;
+	}
+
+	message->server_ = server;
+	message->key_ = key;
+	message->smtpServer_ = dest->smtpServer();
+	message->port_ = dest->smtpPort();
+	message->user_ = dest->smtpUser();
+	message->pwd_ = dest->smtpPwd();
+	message->tls_ = dest->useTLS();
+	message->from_ = dest->smtpFrom();
+	message->object_ = dest->smtpObject();
+	message->recipients_.push_back(dest->folder());
+	message->fileName_ = file->second;
+	message->name_ = shortName;
+	message->timeout_ = timeout;
+	messages_.push_back(message);
+
+	logs_->add(logs::TRACE_TYPE::NORMAL, "Envoi par mail de '%s' à '%s' mis en attente", shortName.c_str(), dest->folder());
+	return true;
+}
+
+// Envoi de tous les messages en attente
+//	les messages sont regroupés par serveur, chaque groupe utilise une seule session SMTP
+//
+size_t mailQueue::flush()
+{
+	if (0 == messages_.size()) {
+		_clear();
+		return 0;
+	}
+
+	logs_->add(logs::TRACE_TYPE::LOG, "Envoi de %u message(s) en attente", (unsigned int)messages_.size());
+
+	// Initialisation de libCURL (avant la création des sessions)
+	jhbCURLTools::CURLHandle::instance();
+
+	size_t errors(0), sessions(0);
+	set<string> done;
+	for (deque<LPMAILMESSAGE>::iterator it = messages_.begin(); it != messages_.end(); it++) {
+		if (nullptr == (*it) || done.end() != done.find((*it)->server_)) {
+			continue;
+		}
+
+		// Une session pour ce serveur
+		string server((*it)->server_);
+		done.insert(server);
+
+		CURL* session(curl_easy_init());
+		if (nullptr == session) {
+			logs_->add(logs::TRACE_TYPE::ERR, "Impossible d'ouvrir une session SMTP vers '%s'", (*it)->smtpServer_.c_str());
+		}
+		else {
+			sessions++;
+		}
+
+		// Tous les messages pour ce serveur
+		for (deque<LPMAILMESSAGE>::iterator msg = it; msg != messages_.end(); msg++) {
+			LPMAILMESSAGE message(*msg);
+			if (nullptr == message || message->server_ != server) {
+				continue;
+			}
+
+			jhbCURLTools::SMTPClient mail(message->from_, "", message->object_, message->object_);
+			mail.setTimeout(message->timeout_);
+			mail.addAttachment(message->fileName_, message->name_);
+
+			string recipients("");
+			for (deque<string>::iterator dest = message->recipients_.begin(); dest != message->recipients_.end(); dest++) {
+				mail.addRecipient((*dest).c_str());
+				if (recipients.size()) {
+					recipients += ", ";
+				}
+				recipients += (*dest);
+			}
+
+			CURLcode ret(CURLE_OK);
+			if (CURLE_OK != (ret = mail.send(message->smtpServer_, message->port_, message->user_, message->pwd_, message->tls_, session))) {
+				errors++;
+				logs_->add(logs::TRACE_TYPE::ERR, "Message '%s' refusé pour '%s'. Erreur : %d, code SMTP : %ld", message->name_.c_str(), recipients.c_str(), ret, mail.responseCode());
+			}
+			else {
+				logs_->add(logs::TRACE_TYPE::LOG, "Envoi du fichier '%s' par mail à '%s'", message->name_.c_str(), recipients.c_str());
+			}
+		}
+
+		// Fermeture de la connexion
+		if (session) {
+			curl_easy_cleanup(session);
+		}
+	}
+
+	logs_->add(logs::TRACE_TYPE::LOG, "%u message(s) envoyé(s) en %u session(s) SMTP, %u refusé(s)", (unsigned int)(messages_.size() - errors), (unsigned int)sessions, (unsigned int)errors);
+
+	_clear();
+	return errors;
+}
+
+// Libérations
+//	les copies des fichiers joints sont supprimées
+//
+void mailQueue::_clear()
+{
+	for (deque<LPMAILMESSAGE>::iterator it = messages_.begin(); it != messages_.end(); it++) {
+		if (*it) {
+			delete (*it);
+		}
+	}
+
+	messages_.clear();
+
+	for (map<size_t, string>::iterator it = files_.begin(); it != files_.end(); it++) {
+		sFileSystem::remove(it->second);
+	}
+
+	files_.clear();
+}
+
+// EOF
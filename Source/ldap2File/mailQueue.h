@@ -0,0 +1,107 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: mailQueue.h
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Définition de la classe mailQueue
+//--
+//--			Les envois par mail sont mis en attente puis transmis en fin
+//--			d'analyse : une seule connexion (et authentification) par
+//--			serveur SMTP pour tous les messages
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#ifndef __LDAP_2_FILE_MAIL_QUEUE_h__
+#define __LDAP_2_FILE_MAIL_QUEUE_h__   1
+
+#include "sharedConsts.h"
+#include "sharedTypes.h"
+
+//----------------------------------------------------------------------
+//--
+//-- Définition de la classe
+//--
+//----------------------------------------------------------------------
+
+class mailQueue
+{
+	// Méthodes publiques
+	//
+public:
+
+	// Construction
+	mailQueue(logs* pLogs, const string& spoolFolder);
+
+	// Destruction
+	virtual ~mailQueue()
+	{ _clear(); }
+
+	// Mise en attente d'un envoi
+	//	les destinataires d'un même fichier (même identifiant) sur un même serveur
+	//	avec le même émetteur et le même objet reçoivent un seul message
+	bool add(mailDestination* dest, const char* fileName, size_t fileID, int timeout = 0);
+
+	// Nombre de messages en attente
+	size_t size()
+	{ return messages_.size(); }
+
+	// Envoi de tous les messages en attente
+	//	retourne le nombre de messages refusés
+	size_t flush();
+
+	// Méthodes privées
+	//
+protected:
+
+	// Un message
+	typedef struct tagMAILMESSAGE
+	{
+		string			server_;		// Clé du serveur (connexion partagée)
+		string			key_;			// Clé du message (fusion des destinataires)
+
+		string			smtpServer_;
+		unsigned int	port_;
+		string			user_;
+		string			pwd_;
+		bool			tls_;
+
+		string			from_;
+		string			object_;
+		deque<string>	recipients_;
+
+		string			fileName_;		// Copie du fichier joint
+		string			name_;			// Nom affiché
+		int				timeout_;
+	}MAILMESSAGE,* LPMAILMESSAGE;
+
+	void _clear();
+
+	// Données membres privées
+	//
+protected:
+	logs*				logs_;
+	string				spool_;			// Dossier des copies des fichiers joints
+
+	deque<LPMAILMESSAGE>	messages_;
+	map<size_t, string>		files_;		// Identifiant du fichier => copie
+};
+
+#endif // #ifndef __LDAP_2_FILE_MAIL_QUEUE_h__
+
+// EOF
@@ -346,6 +346,71 @@ orgChartFile::treeCursor::LPCURSORSEGMENT orgChartFile::treeCursor::at(size_t in
 	return (*it);
 }
 
+// Ecriture d'un lot de lignes
+//	Par défaut chaque cellule est transmise à addAt / removeAt / replaceAt.
+//	Un fichier peut modifier la chaîne qu'il reçoit (encodage) : les valeurs sont alors copiées
+//	et le lot reste intact (il peut être transmis à plusieurs fichiers)
+//
+size_t outputFile::_writeRows(outputRows& rows, bool copyValues)
+{
+	size_t saved(0);
+	outputRows::LPROWCELL cell(nullptr);
+	string value("");
+	deque<string> values;
+
+	for (size_t index = 0; index < rows.size(); index++){
+		outputRows::row& line(rows[index]);
+		for (size_t cIndex = 0; cIndex < line.size(); cIndex++){
+			cell = line[cIndex];
+			currentAttribute_ = cell->names_;
+
+			switch (cell->op_){
+			case outputRows::CELL_OP::ADD:
+				if (copyValues) {
+					value = cell->value_;
+					addAt(cell->colIndex_, value);
+				}
+				else {
+					addAt(cell->colIndex_, cell->value_);
+				}
+				break;
+
+			case outputRows::CELL_OP::ADD_VALUES:
+				if (copyValues) {
+					values = cell->values_;
+					addAt(cell->colIndex_, values);
+				}
+				else {
+					addAt(cell->colIndex_, cell->values_);
+				}
+				break;
+
+			case outputRows::CELL_OP::REMOVE:
+				removeAt(cell->colIndex_);
+				break;
+
+			case outputRows::CELL_OP::REPLACE:
+				if (copyValues) {
+					value = cell->value_;
+					replaceAt(cell->colIndex_, value);
+				}
+				else {
+					replaceAt(cell->colIndex_, cell->value_);
+				}
+				break;
+			}
+		}
+
+		currentAttribute_ = nullptr;
+
+		if (saveLine(false, line.agent())){
+			saved++;
+		}
+	}
+
+	return saved;
+}
+
 // Cancaténation de valeurs
 //
 string outputFile::_cat(deque<string>& values, string& sep)
@@ -56,6 +56,10 @@ using namespace sFileSystem;
 #define FILE_EXT_TXT	"txt"
 #define FILE_EXT_VCF    "vcf"
 
+// Nombre de lignes transmises en une fois au fichier de sortie
+//
+#define OUTPUT_ROWS_BATCH_SIZE	512
+
 //----------------------------------------------------------------------
 //--
 //-- orgCharFile
@@ -156,6 +160,155 @@ protected:
 
 };
 
+//----------------------------------------------------------------------
+//--
+//-- outputRows
+//--
+//----------------------------------------------------------------------
+
+// Lot de lignes à transmettre au fichier de sortie (outputFile::writeRows)
+//	Lignes et cellules sont conservées d'un lot à l'autre : les chaînes gardent
+//	leur mémoire et le remplissage d'un lot n'alloue plus rien
+//
+class outputRows
+{
+	// Methodes publiques
+	//
+public:
+
+	// Action portée par une cellule
+	enum class CELL_OP : uint8_t { ADD = 0, ADD_VALUES = 1, REMOVE = 2, REPLACE = 3 };
+
+	// Une cellule
+	typedef struct _ROWCELL
+	{
+		CELL_OP			op_;
+		size_t			colIndex_;		// Colonne
+		LPATTRNAMES		names_;			// Nom(s) de l'attribut
+		string			value_;			// Valeur simple
+		deque<string>	values_;		// ... ou multiple
+	} ROWCELL, * LPROWCELL;
+
+	// Une ligne
+	//
+	class row
+	{
+	public:
+		row()
+		{ clear(); }
+
+		void clear(){
+			size_ = 0;
+			agent_ = nullptr;
+		}
+
+		// Accès
+		size_t size()
+		{ return size_; }
+		LPROWCELL operator [](size_t index)
+		{ return (index < size_ ? &cells_[index] : nullptr); }
+		LPAGENTINFOS agent()
+		{ return agent_; }
+
+	protected:
+		friend class outputRows;
+
+		// Prochaine cellule (réutilisée si elle existe)
+		LPROWCELL _newCell(CELL_OP op, size_t colIndex, LPATTRNAMES names){
+			if (size_ == cells_.size()){
+				cells_.resize(size_ + 1);
+			}
+
+			LPROWCELL cell(&cells_[size_++]);
+			cell->op_ = op;
+			cell->colIndex_ = colIndex;
+			cell->names_ = names;
+			return cell;
+		}
+
+		deque<ROWCELL>	cells_;
+		size_t			size_;			// Cellules utilisées
+		LPAGENTINFOS	agent_;			// Agent associé à la ligne
+	};
+
+	// Construction
+	outputRows(size_t batchSize = OUTPUT_ROWS_BATCH_SIZE){
+		batchSize_ = (batchSize ? batchSize : 1);
+		size_ = 0;
+		names_ = nullptr;
+	}
+
+	// Destruction
+	virtual ~outputRows()
+	{}
+
+	// Accès aux lignes terminées
+	size_t size()
+	{ return size_; }
+	row& operator [](size_t index)
+	{ return rows_[index]; }
+
+	// Le lot est-il complet ?
+	bool full()
+	{ return (size_ >= batchSize_); }
+
+	// Vidage (la ligne en cours est abandonnée)
+	void clear(){
+		for (size_t index = 0; index <= size_ && index < rows_.size(); index++){
+			rows_[index].clear();
+		}
+		size_ = 0;
+		names_ = nullptr;
+	}
+
+	// Nom(s) de l'attribut des prochaines valeurs
+	void setAttributeNames(LPATTRNAMES pAttribute = nullptr)
+	{ names_ = pAttribute; }
+
+	// Ajout d'une valeur dans la ligne en cours
+	void addAt(size_t colIndex, const string& value)
+	{ _current()._newCell(CELL_OP::ADD, colIndex, names_)->value_ = value; }
+	void addAt(size_t colIndex, const char* value)
+	{ _current()._newCell(CELL_OP::ADD, colIndex, names_)->value_ = (IS_EMPTY(value) ? "" : value); }
+	void addAt(size_t colIndex, const deque<string>& values)
+	{ _current()._newCell(CELL_OP::ADD_VALUES, colIndex, names_)->values_ = values; }
+
+	// Suppression / remplacement d'une valeur
+	void removeAt(size_t colIndex)
+	{ _current()._newCell(CELL_OP::REMOVE, colIndex, names_); }
+	void replaceAt(size_t colIndex, const char* value)
+	{ _current()._newCell(CELL_OP::REPLACE, colIndex, names_)->value_ = (IS_EMPTY(value) ? "" : value); }
+
+	// Fin de la ligne en cours
+	//	retourne true si le lot est complet
+	bool saveLine(LPAGENTINFOS agent = nullptr){
+		_current().agent_ = agent;
+		size_++;
+		return full();
+	}
+
+	// Methodes privees
+	//
+protected:
+
+	// Ligne en cours de remplissage
+	row& _current(){
+		if (size_ == rows_.size()){
+			rows_.resize(size_ + 1);
+		}
+
+		return rows_[size_];
+	}
+
+	// Données membres privées
+	//
+protected:
+	deque<row>		rows_;				// Lignes (terminées puis en cours)
+	size_t			size_;				// Nombre de lignes terminées
+	size_t			batchSize_;			// Taille d'un lot
+	LPATTRNAMES		names_;				// Attribut en cours de traitement
+};
+
 //----------------------------------------------------------------------
 //--
 //-- outputFile
@@ -246,7 +399,7 @@ public:
 	{ return elements_; }
 
 	// Changement de nom
-	void setFileName(string& source, bool keepPath);/* {
+	virtual void setFileName(string& source, bool keepPath);/* {
 		fileName_ = source;
 	}*/
 
@@ -335,6 +488,11 @@ public:
 	// Enregistrement de la "ligne" / nouvelle ligne
 	virtual bool saveLine(bool header = false, LPAGENTINFOS agent = nullptr) = 0;
 
+	// Ecriture d'un lot de lignes
+	//	retourne le nombre de lignes enregistrées
+	virtual size_t writeRows(outputRows& rows)
+	{ return _writeRows(rows, true); }
+
 	// Effacement de la ligne
 	virtual void clearLine()
 	{}
@@ -342,6 +500,16 @@ public:
 	// Sauvegarde / Fermeture
 	virtual bool close() = 0;
 
+	// Copie complémentaire du fichier fermé (même nom suivi de cette extension)
+	//	elle est transmise avec le fichier, sauf par mail (nullptr => pas de copie)
+	virtual const char* sidecarExtension()
+	{ return nullptr; }
+
+	// Fin des transferts du fichier fermé
+	//	success = true si toutes les destinations l'ont reçu
+	virtual void delivered(bool success)
+	{}
+
 	// Methodes privees
 	//
 protected:
@@ -371,6 +539,10 @@ protected:
 	// Cancaténation de valeurs
 	string _cat(deque<string>& values, string& sep);
 
+	// Ecriture d'un lot de lignes cellule par cellule
+	//	copyValues = false si le fichier ne modifie pas les valeurs reçues (elles sont alors lues dans le lot)
+	size_t _writeRows(outputRows& rows, bool copyValues);
+
 private:
 
 	// Donnees membres privees
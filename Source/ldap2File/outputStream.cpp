@@ -0,0 +1,397 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: outputStream.cpp
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Implémentation de la classe outputStream
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#include "outputStream.h"
+
+#include "../ZipLib/streams/compression_encoder_stream.h"
+#include "../ZipLib/compression/deflate/deflate_encoder.h"
+
+//----------------------------------------------------------------------
+//--
+//-- Constantes privées
+//--
+//----------------------------------------------------------------------
+
+// Entête gzip (RFC 1952) : ID1, ID2, CM = deflate, FLG, MTIME (4), XFL, OS = inconnu
+//
+static const unsigned char GZIP_HEADER[] = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff };
+
+#define GZIP_TRAILER_SIZE		8			// CRC32 + taille
+
+#define GZIP_DEFAULT_LEVEL		6
+#define ZSTD_DEFAULT_LEVEL		3
+
+//----------------------------------------------------------------------
+//--
+//-- outputStream
+//--
+//----------------------------------------------------------------------
+
+// Construction
+//
+outputStream::outputStream()
+	:std::ostream(nullptr)
+{
+	compression_ = COMPRESSION_TYPE::NONE;
+	level_ = -1;
+}
+
+// Mode de compression
+//
+bool outputStream::setCompression(COMPRESSION_TYPE compression, int level)
+{
+	level_ = level;
+
+#ifndef __USE_ZSTD__
+	if (COMPRESSION_TYPE::ZSTD == compression) {
+		// Non disponible => gzip
+		compression_ = COMPRESSION_TYPE::GZIP;
+		return false;
+	}
+#endif // __USE_ZSTD__
+
+	compression_ = compression;
+	return true;
+}
+
+// Extension associée à la compression
+//
+const char* outputStream::extension()
+{
+	switch (compression_) {
+	case COMPRESSION_TYPE::GZIP:
+		return FILE_EXT_GZIP;
+
+	case COMPRESSION_TYPE::ZSTD:
+		return FILE_EXT_ZSTD;
+
+	default:
+		return "";
+	}
+}
+
+// Ajout de l'extension au nom d'un fichier
+//
+void outputStream::addExtension(string& fileName)
+{
+	if (COMPRESSION_TYPE::NONE == compression_ || 0 == fileName.size()) {
+		return;
+	}
+
+	string ext(".");
+	ext += extension();
+
+	// Déja présente ?
+	if (fileName.size() > ext.size() &&
+		0 == fileName.compare(fileName.size() - ext.size(), ext.size(), ext)) {
+		return;
+	}
+
+	fileName += ext;
+}
+
+// Ouverture du fichier
+//
+void outputStream::open(const char* fileName, ios_base::openmode mode)
+{
+	close();
+
+	// Un flux compressé est binaire
+	if (COMPRESSION_TYPE::NONE != compression_) {
+		mode |= ios_base::binary;
+	}
+
+	file_.open(fileName, mode);
+	if (!file_.is_open()) {
+		setstate(ios_base::failbit);
+		return;
+	}
+
+	if (COMPRESSION_TYPE::NONE == compression_) {
+		// Ecriture directe
+		rdbuf(file_.rdbuf());
+		return;
+	}
+
+	if (!buffer_.open(&file_, compression_, level_)) {
+		file_.close();
+		setstate(ios_base::failbit);
+		return;
+	}
+
+	rdbuf(&buffer_);
+}
+
+// Fermeture du fichier
+//	Pour un fichier compressé, c'est ici que le flux est terminé
+//
+bool outputStream::close()
+{
+	if (!file_.is_open()) {
+		return false;
+	}
+
+	bool done(true);
+	if (COMPRESSION_TYPE::NONE == compression_) {
+		flush();
+	}
+	else {
+		done = buffer_.close();
+	}
+
+	done = done && !fail();
+
+	// Les écritures suivantes échoueront (comme un std::ofstream fermé)
+	rdbuf(file_.rdbuf());
+	file_.close();
+
+	if (!done || file_.fail()) {
+		setstate(ios_base::failbit);
+		return false;
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------
+//--
+//-- outputStream::compressionBuffer
+//--
+//----------------------------------------------------------------------
+
+// Construction
+//
+outputStream::compressionBuffer::compressionBuffer()
+{
+	in_ = out_ = 0;
+	file_ = nullptr;
+	compression_ = COMPRESSION_TYPE::NONE;
+	deflate_ = nullptr;
+	deflateOut_ = 0;
+	crc_ = 0;
+#ifdef __USE_ZSTD__
+	zstd_ = nullptr;
+	zBuffer_ = nullptr;
+	zSize_ = 0;
+#endif // __USE_ZSTD__
+}
+
+// Début du flux compressé
+//
+bool outputStream::compressionBuffer::open(std::ofstream* file, COMPRESSION_TYPE compression, int level)
+{
+	_release();
+
+	if (nullptr == (file_ = file)) {
+		return false;
+	}
+
+	compression_ = compression;
+	in_ = out_ = 0;
+
+	if (COMPRESSION_TYPE::GZIP == compression_) {
+		// Entête
+		file_->write((const char*)GZIP_HEADER, sizeof(GZIP_HEADER));
+		deflateOut_ = sizeof(GZIP_HEADER);
+		crc_ = (uint32_t)crc32(0L, Z_NULL, 0);
+
+		// Flux "deflate" brut
+		deflate_encoder_properties props;
+		props.CompressionLevel = ((level < 0 || level > 9) ? GZIP_DEFAULT_LEVEL : level);
+		if (nullptr == (deflate_ = new compression_encoder_stream(std::make_shared<deflate_encoder>(), props, *file_))) {
+			return false;
+		}
+	}
+#ifdef __USE_ZSTD__
+	else {
+		if (nullptr == (zstd_ = ZSTD_createCCtx())) {
+			return false;
+		}
+
+		ZSTD_CCtx_setParameter(zstd_, ZSTD_c_compressionLevel, (level <= 0 ? ZSTD_DEFAULT_LEVEL : level));
+		ZSTD_CCtx_setParameter(zstd_, ZSTD_c_checksumFlag, 1);
+
+		zSize_ = ZSTD_CStreamOutSize();
+		if (nullptr == (zBuffer_ = new char[zSize_])) {
+			return false;
+		}
+	}
+#endif // __USE_ZSTD__
+
+	setp(data_, data_ + sizeof(data_));
+	return !file_->fail();
+}
+
+// Fin du flux compressé
+//
+bool outputStream::compressionBuffer::close()
+{
+	if (nullptr == file_) {
+		return false;
+	}
+
+	bool done(0 == sync());
+
+	if (COMPRESSION_TYPE::GZIP == compression_ && deflate_) {
+		// Fin du flux "deflate" (Z_FINISH)
+		deflate_->flush();
+		deflateOut_ += ((compression_encoder_stream*)deflate_)->get_bytes_written();
+		delete deflate_;
+		deflate_ = nullptr;
+
+		// Pied : CRC32 et taille (modulo 2^32) en "little-endian"
+		unsigned char trailer[GZIP_TRAILER_SIZE];
+		uint32_t size((uint32_t)in_);
+		for (int index = 0; index < 4; index++) {
+			trailer[index] = (unsigned char)(crc_ >> (8 * index));
+			trailer[4 + index] = (unsigned char)(size >> (8 * index));
+		}
+
+		file_->write((const char*)trailer, GZIP_TRAILER_SIZE);
+		out_ = deflateOut_ + GZIP_TRAILER_SIZE;
+	}
+#ifdef __USE_ZSTD__
+	else {
+		if (zstd_) {
+			ZSTD_inBuffer input = { nullptr, 0, 0 };
+			size_t remaining(0);
+			do {
+				ZSTD_outBuffer output = { zBuffer_, zSize_, 0 };
+				remaining = ZSTD_compressStream2(zstd_, &output, &input, ZSTD_e_end);
+				if (ZSTD_isError(remaining)) {
+					done = false;
+					break;
+				}
+
+				file_->write(zBuffer_, output.pos);
+				out_ += output.pos;
+			} while (remaining);
+		}
+	}
+#endif // __USE_ZSTD__
+
+	done = done && !file_->fail();
+
+	_release();
+	return done;
+}
+
+// Le tampon est plein
+//
+outputStream::compressionBuffer::int_type outputStream::compressionBuffer::overflow(int_type c)
+{
+	if (0 != sync()) {
+		return traits_type::eof();
+	}
+
+	if (!traits_type::eq_int_type(c, traits_type::eof())) {
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+	}
+
+	return traits_type::not_eof(c);
+}
+
+// Compression du contenu du tampon
+//	le flux compressé n'est pas terminé (cf. close)
+//
+int outputStream::compressionBuffer::sync()
+{
+	size_t len(pptr() - pbase());
+	if (0 == len) {
+		return 0;
+	}
+
+	bool done(_encode(pbase(), len));
+	setp(data_, data_ + sizeof(data_));
+	return (done ? 0 : -1);
+}
+
+// Compression d'un bloc
+//
+bool outputStream::compressionBuffer::_encode(const char* data, size_t len)
+{
+	if (nullptr == file_) {
+		return false;
+	}
+
+	in_ += len;
+
+	if (COMPRESSION_TYPE::GZIP == compression_) {
+		if (nullptr == deflate_) {
+			return false;
+		}
+
+		crc_ = (uint32_t)crc32(crc_, (const Bytef*)data, (uInt)len);
+		deflate_->write(data, len);
+	}
+#ifdef __USE_ZSTD__
+	else {
+		if (nullptr == zstd_) {
+			return false;
+		}
+
+		ZSTD_inBuffer input = { data, len, 0 };
+		while (input.pos < input.size) {
+			ZSTD_outBuffer output = { zBuffer_, zSize_, 0 };
+			if (ZSTD_isError(ZSTD_compressStream2(zstd_, &output, &input, ZSTD_e_continue))) {
+				return false;
+			}
+
+			file_->write(zBuffer_, output.pos);
+			out_ += output.pos;
+		}
+	}
+#endif // __USE_ZSTD__
+
+	return !file_->fail();
+}
+
+// Libérations
+//
+void outputStream::compressionBuffer::_release()
+{
+	if (deflate_) {
+		delete deflate_;
+		deflate_ = nullptr;
+	}
+
+#ifdef __USE_ZSTD__
+	if (zstd_) {
+		ZSTD_freeCCtx(zstd_);
+		zstd_ = nullptr;
+	}
+
+	if (zBuffer_) {
+		delete[] zBuffer_;
+		zBuffer_ = nullptr;
+	}
+#endif // __USE_ZSTD__
+
+	file_ = nullptr;
+	setp(data_, data_ + sizeof(data_));
+}
+
+// EOF
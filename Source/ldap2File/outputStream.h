@@ -0,0 +1,162 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: outputStream.h
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Définition de la classe outputStream
+//--
+//--			Flux d'écriture des fichiers "texte" (CSV, LDIF, vCard, JS)
+//--			avec compression (gzip ou zstd) au fil de l'eau
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#ifndef __LDAP_2_FILE_OUTPUT_STREAM_h__
+#define __LDAP_2_FILE_OUTPUT_STREAM_h__   1
+
+#include "sharedConsts.h"
+
+#include <fstream>
+#include <streambuf>
+
+// zstd n'est disponible que si l'application est compilée avec __USE_ZSTD__ (et liée avec -lzstd)
+//
+#ifdef __USE_ZSTD__
+#include <zstd.h>
+#endif // __USE_ZSTD__
+
+//----------------------------------------------------------------------
+//--
+//-- Constantes publiques
+//--
+//----------------------------------------------------------------------
+
+// Extensions des fichiers compressés
+//
+#define FILE_EXT_GZIP			"gz"
+#define FILE_EXT_ZSTD			"zst"
+
+// Taille du tampon de compression
+//
+#define OUTPUT_STREAM_BUFFER_SIZE	65536
+
+//----------------------------------------------------------------------
+//--
+//-- Définition de la classe
+//--
+//----------------------------------------------------------------------
+
+// S'utilise comme un std::ofstream : open / is_open / close / <<
+//	Sans compression, les écritures vont directement dans le fichier
+//
+class outputStream : public std::ostream
+{
+	// Méthodes publiques
+	//
+public:
+
+	// Construction
+	outputStream();
+
+	// Destruction
+	virtual ~outputStream()
+	{ close(); }
+
+	// Compression à appliquer au prochain fichier ouvert
+	//	retourne false si le mode demandé n'est pas disponible (zstd => gzip)
+	bool setCompression(COMPRESSION_TYPE compression, int level = -1);
+	COMPRESSION_TYPE compression()
+	{ return compression_; }
+
+	// Extension associée à la compression ("" si pas de compression)
+	const char* extension();
+
+	// Ajout de l'extension au nom d'un fichier (si nécessaire)
+	void addExtension(string& fileName);
+
+	// Gestion du fichier
+	void open(const char* fileName, ios_base::openmode mode = ios_base::out | ios_base::trunc);
+	bool is_open()
+	{ return file_.is_open(); }
+	bool close();
+
+	// Volumes (en octets) avant et après compression
+	size_t bytesIn()
+	{ return buffer_.in_; }
+	size_t bytesOut()
+	{ return buffer_.out_; }
+
+	// Méthodes privées
+	//
+protected:
+
+	// Tampon de compression
+	//
+	class compressionBuffer : public std::streambuf
+	{
+	public:
+		compressionBuffer();
+		virtual ~compressionBuffer()
+		{ _release(); }
+
+		// Début / fin du flux compressé
+		bool open(std::ofstream* file, COMPRESSION_TYPE compression, int level);
+		bool close();
+
+		size_t			in_;				// Octets reçus
+		size_t			out_;				// Octets écrits
+
+	protected:
+		// std::streambuf
+		int_type overflow(int_type c = traits_type::eof()) override;
+		int sync() override;
+
+		// Compression d'un bloc
+		bool _encode(const char* data, size_t len);
+
+		void _release();
+
+		std::ofstream*		file_;
+		COMPRESSION_TYPE	compression_;
+		char				data_[OUTPUT_STREAM_BUFFER_SIZE];
+
+		// gzip : flux "deflate" de ZipLib encadré par l'entête et le pied gzip
+		std::ostream*		deflate_;
+		size_t				deflateOut_;	// Octets compressés (avant le flux)
+		uint32_t			crc_;
+
+#ifdef __USE_ZSTD__
+		ZSTD_CCtx*			zstd_;
+		char*				zBuffer_;
+		size_t				zSize_;
+#endif // __USE_ZSTD__
+	};
+
+	// Données membres privées
+	//
+protected:
+	std::ofstream		file_;
+	compressionBuffer	buffer_;
+
+	COMPRESSION_TYPE	compression_;
+	int					level_;				// -1 => niveau par défaut
+};
+
+#endif // #ifndef __LDAP_2_FILE_OUTPUT_STREAM_h__
+
+// EOF
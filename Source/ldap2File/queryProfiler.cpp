@@ -0,0 +1,335 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: queryProfiler.cpp
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Implémentation de la classe queryProfiler
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#include "queryProfiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+
+//----------------------------------------------------------------------
+//--
+//-- Constantes privées
+//--
+//----------------------------------------------------------------------
+
+// Bornes supérieures (en ms) des classes de l'histogramme
+//	la dernière classe (+Inf) n'a pas de borne
+//
+static const double BUCKET_BOUNDS[QUERY_PROFILER_BUCKETS - 1] = { 1, 2.5, 5, 10, 25, 50, 100, 250, 500, 1000, 2500 };
+
+//----------------------------------------------------------------------
+//--
+//-- Implémentation de la classe
+//--
+//----------------------------------------------------------------------
+
+// Construction
+//
+queryProfiler::queryProfiler(logs* pLogs, size_t threshold)
+{
+	logs_ = pLogs;
+	threshold_ = (threshold ? threshold : QUERY_PROFILER_DEF_THRESHOLD);
+	cmdFile_ = "";
+}
+
+// Nouvelle exécution
+//
+void queryProfiler::start(const char* cmdFile)
+{
+	cmdFile_ = (cmdFile ? cmdFile : "");
+	shapes_.clear();
+}
+
+// Une requête de plus
+//
+void queryProfiler::add(const char* base, int scope, const char* filter, char** attributes, size_t entries, size_t bytes, double duration)
+{
+	string key(shape(filter));
+	QUERYSHAPE& query(shapes_[key]);
+
+	// Une même forme peut porter sur plusieurs bases (une requête par service ...)
+	string baseDN(base ? base : "");
+	if (query.bases_.size() < QUERY_PROFILER_MAX_BASES || query.bases_.end() != query.bases_.find(baseDN)) {
+		query.bases_.insert(baseDN);
+	}
+	else {
+		query.otherBases_++;
+	}
+
+	query.scope_ = scope;
+	query.calls_++;
+	query.entries_ += entries;
+	query.bytes_ += bytes;
+	query.duration_ += duration;
+	if (duration > query.max_) {
+		query.max_ = duration;
+	}
+
+	// Classe de l'histogramme
+	size_t index(0);
+	while (index < QUERY_PROFILER_BUCKETS - 1 && duration > BUCKET_BOUNDS[index]) {
+		index++;
+	}
+	query.buckets_[index]++;
+
+	// Liste des attributs (à la première requête)
+	if (1 == query.calls_ && attributes) {
+		for (char** attr = attributes; *attr; attr++) {
+			if (query.attributes_.size()) {
+				query.attributes_ += ",";
+			}
+			query.attributes_ += *attr;
+		}
+	}
+
+	if (logs_) {
+		logs_->add(logs::TRACE_TYPE::DBG, "Requête LDAP - %.3f ms - base : '%s', profondeur : %d, filtre : '%s', attributs : '%s' - %u entrée(s), %u octet(s)", duration, baseDN.c_str(), scope, (filter ? filter : ""), query.attributes_.c_str(), (unsigned int)entries, (unsigned int)bytes);
+
+		// Une requête par élément ?
+		if (query.calls_ == threshold_ + 1) {
+			logs_->add(logs::TRACE_TYPE::LOG, "Attention - La requête '%s' a été exécutée plus de %u fois. Les valeurs devraient être obtenues en une seule recherche", key.c_str(), (unsigned int)threshold_);
+		}
+	}
+}
+
+// Nombre de formes répétées plus que le seuil
+//
+size_t queryProfiler::repeated()
+{
+	size_t count(0);
+	for (map<string, QUERYSHAPE>::iterator it = shapes_.begin(); it != shapes_.end(); it++) {
+		if (it->second.calls_ > threshold_) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+// Ajout des statistiques au rapport d'exécution (objet JSON)
+//
+void queryProfiler::toJSON(std::ostream& out, const char* indent)
+{
+	string tab(indent ? indent : "");
+
+	out << "{" << std::endl;
+	out << tab << "\t\"threshold\": " << threshold_ << "," << std::endl;
+	out << tab << "\t\"repeated\": " << repeated() << "," << std::endl;
+	out << tab << "\t\"shapes\": [";
+
+	bool first(true);
+	for (map<string, QUERYSHAPE>::iterator it = shapes_.begin(); it != shapes_.end(); it++) {
+		QUERYSHAPE& query(it->second);
+
+		out << (first ? "" : ",") << std::endl;
+		first = false;
+
+		out << tab << "\t\t{ \"filter\": \"" << _escape(it->first, false) << "\""
+			<< ", \"bases\": [";
+
+		for (set<string>::iterator base = query.bases_.begin(); base != query.bases_.end(); base++) {
+			out << (query.bases_.begin() == base ? " \"" : ", \"") << _escape((*base), false) << "\"";
+		}
+
+		out << " ], \"otherBases\": " << query.otherBases_
+			<< ", \"scope\": " << query.scope_
+			<< ", \"attributes\": \"" << _escape(query.attributes_, false) << "\""
+			<< ", \"calls\": " << query.calls_
+			<< ", \"entries\": " << query.entries_
+			<< ", \"bytes\": " << query.bytes_
+			<< ", \"durationMs\": " << query.duration_
+			<< ", \"maxMs\": " << query.max_
+			<< ", \"repeated\": " << (query.calls_ > threshold_ ? "true" : "false")
+			<< ", \"histogram\": { ";
+
+		for (size_t index = 0; index < QUERY_PROFILER_BUCKETS; index++) {
+			out << (index ? ", " : "") << "\"";
+			if (index < QUERY_PROFILER_BUCKETS - 1) {
+				out << BUCKET_BOUNDS[index];
+			}
+			else {
+				out << "+Inf";
+			}
+			out << "\": " << query.buckets_[index];
+		}
+
+		out << " } }";
+	}
+
+	out << std::endl << tab << "\t]" << std::endl;
+	out << tab << "}";
+}
+
+// Fichier pour Prometheus (collecteur "textfile" du node exporter)
+//	le fichier est écrit sous un nom temporaire puis renommé pour ne jamais être lu partiellement
+//
+bool queryProfiler::savePrometheus(const string& fileName)
+{
+	string tempName(fileName);
+	tempName += ".tmp";
+
+	std::ofstream file(tempName.c_str(), std::ios::out | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	string command(_escape(cmdFile_, true));
+	map<string, QUERYSHAPE>::iterator it;
+
+	file << "# HELP ldap2file_ldap_query_duration_seconds Durée des requêtes LDAP par forme de filtre" << std::endl;
+	file << "# TYPE ldap2file_ldap_query_duration_seconds histogram" << std::endl;
+	for (it = shapes_.begin(); it != shapes_.end(); it++) {
+		QUERYSHAPE& query(it->second);
+		string labels("command=\"" + command + "\",shape=\"" + _escape(it->first, true) + "\"");
+
+		size_t cumul(0);
+		for (size_t index = 0; index < QUERY_PROFILER_BUCKETS; index++) {
+			cumul += query.buckets_[index];
+			file << "ldap2file_ldap_query_duration_seconds_bucket{" << labels << ",le=\"";
+			if (index < QUERY_PROFILER_BUCKETS - 1) {
+				file << BUCKET_BOUNDS[index] / 1000.0;
+			}
+			else {
+				file << "+Inf";
+			}
+			file << "\"} " << cumul << std::endl;
+		}
+
+		file << "ldap2file_ldap_query_duration_seconds_sum{" << labels << "} " << query.duration_ / 1000.0 << std::endl;
+		file << "ldap2file_ldap_query_duration_seconds_count{" << labels << "} " << query.calls_ << std::endl;
+	}
+
+	file << "# HELP ldap2file_ldap_query_entries_total Nombre d'entrées retournées par forme de filtre" << std::endl;
+	file << "# TYPE ldap2file_ldap_query_entries_total counter" << std::endl;
+	for (it = shapes_.begin(); it != shapes_.end(); it++) {
+		file << "ldap2file_ldap_query_entries_total{command=\"" << command << "\",shape=\"" << _escape(it->first, true) << "\"} " << it->second.entries_ << std::endl;
+	}
+
+	file << "# HELP ldap2file_ldap_query_bytes_total Volume des valeurs retournées par forme de filtre" << std::endl;
+	file << "# TYPE ldap2file_ldap_query_bytes_total counter" << std::endl;
+	for (it = shapes_.begin(); it != shapes_.end(); it++) {
+		file << "ldap2file_ldap_query_bytes_total{command=\"" << command << "\",shape=\"" << _escape(it->first, true) << "\"} " << it->second.bytes_ << std::endl;
+	}
+
+	file << "# HELP ldap2file_ldap_query_repeated 1 si la forme de filtre a été exécutée plus que le seuil" << std::endl;
+	file << "# TYPE ldap2file_ldap_query_repeated gauge" << std::endl;
+	for (it = shapes_.begin(); it != shapes_.end(); it++) {
+		file << "ldap2file_ldap_query_repeated{command=\"" << command << "\",shape=\"" << _escape(it->first, true) << "\"} " << (it->second.calls_ > threshold_ ? 1 : 0) << std::endl;
+	}
+
+	bool done(!file.fail());
+	file.close();
+
+	if (!done) {
+		std::remove(tempName.c_str());
+		return false;
+	}
+
+	// Remplacement du fichier précédent
+	std::remove(fileName.c_str());
+	return (0 == std::rename(tempName.c_str(), fileName.c_str()));
+}
+
+// Forme d'un filtre : les valeurs sont remplacées par '?'
+//	les tests de présence ("=*") sont conservés
+//
+string queryProfiler::shape(const char* filter)
+{
+	string out(""), value("");
+	if (IS_EMPTY(filter)) {
+		return out;
+	}
+
+	bool inValue(false);
+	for (const char* pos = filter; *pos; pos++) {
+		if (inValue) {
+			if (')' == *pos) {
+				out += ("*" == value ? "*" : "?");
+				out += *pos;
+				inValue = false;
+			}
+			else {
+				value += *pos;
+
+				// Caractère échappé (RFC 4515)
+				if ('\\' == *pos && pos[1]) {
+					value += *(++pos);
+				}
+			}
+			continue;
+		}
+
+		out += *pos;
+		if ('=' == *pos) {
+			inValue = true;
+			value = "";
+		}
+	}
+
+	// Filtre sans parenthèses
+	if (inValue) {
+		out += ("*" == value ? "*" : "?");
+	}
+
+	return out;
+}
+
+// Chaine au format JSON ou valeur d'un label Prometheus
+//
+string queryProfiler::_escape(const string& value, bool prometheus)
+{
+	string out("");
+	char buffer[8];
+	for (string::const_iterator it = value.begin(); it != value.end(); it++) {
+		switch (*it) {
+		case '"':
+			out += "\\\"";
+			break;
+
+		case '\\':
+			out += "\\\\";
+			break;
+
+		case '\n':
+			out += "\\n";
+			break;
+
+		default:
+			if (!prometheus && (unsigned char)(*it) < 0x20) {
+				snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char)(*it));
+				out += buffer;
+			}
+			else {
+				out += *it;
+			}
+			break;
+		}
+	}
+
+	return out;
+}
+
+// EOF
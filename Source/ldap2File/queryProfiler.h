@@ -0,0 +1,148 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: queryProfiler.h
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Définition de la classe queryProfiler
+//--
+//--			Statistiques sur les requêtes LDAP regroupées par "forme" de
+//--			filtre (les valeurs sont remplacées par '?') et détection
+//--			des requêtes répétées (une requête par agent, par manager ...)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#ifndef __LDAP_2_FILE_QUERY_PROFILER_h__
+#define __LDAP_2_FILE_QUERY_PROFILER_h__   1
+
+#include "sharedConsts.h"
+
+#include <ostream>
+
+//----------------------------------------------------------------------
+//--
+//-- Constantes publiques
+//--
+//----------------------------------------------------------------------
+
+// Nombre de répétitions d'une même forme de requête au delà duquel
+// un avertissement est émis
+//
+#define QUERY_PROFILER_DEF_THRESHOLD	100
+
+// Nom du fichier pour le collecteur "textfile" de Prometheus
+//
+#define QUERY_PROFILER_PROM_PREFIX		"ldap2file_"
+#define QUERY_PROFILER_PROM_EXT			".prom"
+
+// Nombre de classes de l'histogramme des durées
+//
+#define QUERY_PROFILER_BUCKETS			12
+
+// Nombre d'entrées mesurées par requête pour estimer le volume retourné
+//
+#define QUERY_PROFILER_SAMPLE_ENTRIES	16
+
+// Nombre maximal de bases conservées pour une forme de requête
+//
+#define QUERY_PROFILER_MAX_BASES		10
+
+//----------------------------------------------------------------------
+//--
+//-- Définition de la classe
+//--
+//----------------------------------------------------------------------
+
+class queryProfiler
+{
+	// Méthodes publiques
+	//
+public:
+
+	// Construction
+	queryProfiler(logs* pLogs, size_t threshold = QUERY_PROFILER_DEF_THRESHOLD);
+
+	// Destruction
+	virtual ~queryProfiler()
+	{ shapes_.clear(); }
+
+	// Nouvelle exécution
+	void start(const char* cmdFile);
+
+	// Une requête de plus
+	void add(const char* base, int scope, const char* filter, char** attributes, size_t entries, size_t bytes, double duration);
+
+	// Nombre de formes répétées plus que le seuil
+	size_t repeated();
+	size_t threshold()
+	{ return threshold_; }
+
+	// Ajout des statistiques au rapport d'exécution (objet JSON)
+	void toJSON(std::ostream& out, const char* indent);
+
+	// Fichier pour Prometheus
+	bool savePrometheus(const string& fileName);
+
+	// Forme d'un filtre : les valeurs sont remplacées par '?'
+	//	"(&(objectClass=person)(uid=jdoe))" => "(&(objectClass=?)(uid=?))"
+	static string shape(const char* filter);
+
+	// Méthodes privées
+	//
+protected:
+
+	static string _escape(const string& value, bool prometheus);
+
+	// Données membres privées
+	//
+protected:
+
+	// Statistiques pour une forme de requête
+	typedef struct tagQUERYSHAPE
+	{
+		tagQUERYSHAPE(){
+			scope_ = 0;
+			otherBases_ = calls_ = entries_ = bytes_ = 0;
+			duration_ = max_ = 0.0;
+			memset(buckets_, 0, sizeof(buckets_));
+		}
+
+		set<string>	bases_;			// Bases utilisées (au plus QUERY_PROFILER_MAX_BASES)
+		size_t		otherBases_;	// Requêtes sur d'autres bases
+		int			scope_;
+		string		attributes_;	// Liste des attributs demandés
+
+		size_t		calls_;
+		size_t		entries_;
+		size_t		bytes_;
+		double		duration_;		// Durée totale en ms
+		double		max_;
+
+		size_t		buckets_[QUERY_PROFILER_BUCKETS];	// Histogramme des durées (non cumulatif)
+	}QUERYSHAPE;
+
+	logs*						logs_;
+	size_t						threshold_;
+
+	string						cmdFile_;
+	map<string, QUERYSHAPE>		shapes_;		// Forme du filtre => statistiques
+};
+
+#endif // #ifndef __LDAP_2_FILE_QUERY_PROFILER_h__
+
+// EOF
@@ -0,0 +1,261 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: runReport.cpp
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Implémentation de la classe runReport
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#include "runReport.h"
+
+#include <fstream>
+#include <iomanip>
+
+#ifdef _WIN32
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
+
+//----------------------------------------------------------------------
+//--
+//-- Constantes privées
+//--
+//----------------------------------------------------------------------
+
+// Noms des phases et des compteurs (dans l'ordre des énumérations)
+//
+static const char* PHASE_NAMES[] = { "connect", "containers", "search", "decode", "groups", "write", "orgChart", "close", "postGen", "ftp", "smtp", "scp" };
+static const char* COUNTER_NAMES[] = { "ldapRequests", "entries", "attributes", "rows", "fileBytes", "sentBytes" };
+
+//----------------------------------------------------------------------
+//--
+//-- Implémentation de la classe
+//--
+//----------------------------------------------------------------------
+
+// Construction
+//
+runReport::runReport()
+{
+	start("");
+}
+
+// Nouvelle exécution
+//
+void runReport::start(const char* cmdFile)
+{
+	cmdFile_ = (cmdFile ? cmdFile : "");
+	startTime_ = time(nullptr);
+	start_ = std::chrono::steady_clock::now();
+
+	memset(phases_, 0, sizeof(phases_));
+	memset(counters_, 0, sizeof(counters_));
+}
+
+// Fin d'une phase
+//
+void runReport::_add(PHASE phase, std::chrono::steady_clock::time_point& start, size_t rss)
+{
+	PHASEINFOS& infos(phases_[(size_t)phase]);
+
+	infos.calls_++;
+	infos.duration_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	size_t current(currentRSS());
+	if (current > infos.rssMax_) {
+		infos.rssMax_ = current;
+	}
+
+	if (current > rss) {
+		infos.rssGrowth_ += (current - rss);
+	}
+}
+
+// Phase mesurée par ailleurs (les transferts exécutés dans d'autres threads)
+//
+void runReport::add(PHASE phase, double duration)
+{
+	PHASEINFOS& infos(phases_[(size_t)phase]);
+
+	infos.calls_++;
+	infos.duration_ += duration;
+
+	size_t current(currentRSS());
+	if (current > infos.rssMax_) {
+		infos.rssMax_ = current;
+	}
+}
+
+// Pic d'utilisation mémoire du processus depuis son lancement (en ko)
+//
+size_t runReport::peakRSS()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.PeakWorkingSetSize / 1024;
+	}
+#else
+	struct rusage usage;
+	if (0 == getrusage(RUSAGE_SELF, &usage)) {
+		return (size_t)usage.ru_maxrss;		// déja en ko
+	}
+#endif // _WIN32
+
+	return 0;
+}
+
+// Mémoire utilisée par le processus (en ko)
+//	sous Linux, /proc/self/statm reste ouvert (les phases sont mesurées pour chaque entrée)
+//
+size_t runReport::currentRSS()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.WorkingSetSize / 1024;
+	}
+#else
+	static int statm(open("/proc/self/statm", O_RDONLY | O_CLOEXEC));
+	static long pageSize(sysconf(_SC_PAGESIZE));
+	if (statm >= 0 && pageSize > 0) {
+		// "taille résidente partagée ..." en pages
+		char buffer[128];
+		ssize_t len(pread(statm, buffer, sizeof(buffer) - 1, 0));
+		if (len > 0) {
+			buffer[len] = EOS;
+			unsigned long size(0), resident(0);
+			if (2 == sscanf(buffer, "%lu %lu", &size, &resident)) {
+				return (size_t)resident * (size_t)pageSize / 1024;
+			}
+		}
+	}
+#endif // _WIN32
+
+	return 0;
+}
+
+// Enregistrement du rapport
+//
+bool runReport::save(const string& fileName, int status, queryProfiler* profiler)
+{
+	std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	char date[32];
+	tm ltm;
+#ifdef _WIN32
+	localtime_s(&ltm, &startTime_);
+#else
+	localtime_r(&startTime_, &ltm);
+#endif // _WIN32
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &ltm);
+
+	file << std::fixed << std::setprecision(3);
+	file << "{" << std::endl;
+	file << "\t\"commandFile\": \"" << _escape(cmdFile_) << "\"," << std::endl;
+	file << "\t\"start\": \"" << date << "\"," << std::endl;
+	file << "\t\"status\": " << status << "," << std::endl;
+	file << "\t\"durationMs\": " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count() << "," << std::endl;
+	file << "\t\"rssPeakKB\": " << peakRSS() << "," << std::endl;		// Maximum depuis le lancement du processus
+	file << "\t\"rssKB\": " << currentRSS() << "," << std::endl;
+
+	// Compteurs
+	file << "\t\"counters\": {" << std::endl;
+	for (size_t index = 0; index < (size_t)COUNTER::COUNT; index++) {
+		file << "\t\t\"" << _counterName(index) << "\": " << counters_[index] << ((index + 1 < (size_t)COUNTER::COUNT) ? "," : "") << std::endl;
+	}
+	file << "\t}," << std::endl;
+
+	// Phases
+	file << "\t\"phases\": {" << std::endl;
+	for (size_t index = 0; index < (size_t)PHASE::COUNT; index++) {
+		PHASEINFOS& infos(phases_[index]);
+		file << "\t\t\"" << _phaseName(index) << "\": { \"calls\": " << infos.calls_
+			<< ", \"durationMs\": " << infos.duration_
+			<< ", \"rssMaxKB\": " << infos.rssMax_
+			<< ", \"rssGrowthKB\": " << infos.rssGrowth_ << " }"
+			<< ((index + 1 < (size_t)PHASE::COUNT) ? "," : "") << std::endl;
+	}
+	file << "\t}";
+
+	// Requêtes LDAP
+	if (profiler) {
+		file << "," << std::endl << "\t\"queries\": ";
+		profiler->toJSON(file, "\t");
+	}
+
+	file << std::endl << "}" << std::endl;
+
+	bool done(!file.fail());
+	file.close();
+	return done;
+}
+
+// Noms (clés JSON)
+//
+const char* runReport::_phaseName(size_t index)
+{
+	return (index < sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) ? PHASE_NAMES[index] : "");
+}
+
+const char* runReport::_counterName(size_t index)
+{
+	return (index < sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) ? COUNTER_NAMES[index] : "");
+}
+
+// Chaine au format JSON
+//
+string runReport::_escape(const string& value)
+{
+	string out("");
+	char buffer[8];
+	for (string::const_iterator it = value.begin(); it != value.end(); it++) {
+		switch (*it) {
+		case '"':
+			out += "\\\"";
+			break;
+
+		case '\\':
+			out += "\\\\";
+			break;
+
+		default:
+			if ((unsigned char)(*it) < 0x20) {
+				snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char)(*it));
+				out += buffer;
+			}
+			else {
+				out += *it;
+			}
+			break;
+		}
+	}
+
+	return out;
+}
+
+// EOF
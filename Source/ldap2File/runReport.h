@@ -0,0 +1,168 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: runReport.h
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Définition de la classe runReport
+//--
+//--			Mesure des durées et de la mémoire par phase de traitement
+//--			d'un fichier de commandes et génération d'un rapport JSON
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#ifndef __LDAP_2_FILE_RUN_REPORT_h__
+#define __LDAP_2_FILE_RUN_REPORT_h__   1
+
+#include "sharedConsts.h"
+#include "queryProfiler.h"
+
+#include <chrono>
+#include <ctime>
+
+//----------------------------------------------------------------------
+//--
+//-- Constantes publiques
+//--
+//----------------------------------------------------------------------
+
+// Suffixe des fichiers rapports (ajouté au nom du fichier de commandes)
+//
+#define RUN_REPORT_FILE_EXT		".report.json"
+
+//----------------------------------------------------------------------
+//--
+//-- Définition de la classe
+//--
+//----------------------------------------------------------------------
+
+// Les durées sont inclusives : une phase contient le temps des phases
+// qu'elle appelle (DECODE contient GROUPS et WRITE, ...)
+//
+class runReport
+{
+	// Méthodes publiques
+	//
+public:
+
+	// Phases mesurées
+	enum class PHASE : uint8_t { CONNECT = 0, CONTAINERS, SEARCH, DECODE, GROUPS, WRITE, ORGCHART, CLOSE, POSTGEN, FTP, SMTP, SCP, COUNT };
+
+	// Compteurs
+	enum class COUNTER : uint8_t { LDAP_REQUESTS = 0, ENTRIES, ATTRIBUTES, ROWS, FILE_BYTES, SENT_BYTES, COUNT };
+
+	// Mesure d'une phase (le temps d'un bloc ou jusqu'à l'appel de stop)
+	//	sans rapport (nullptr), aucune mesure n'est effectuée
+	//
+	class timer
+	{
+	public:
+		timer(runReport* report, PHASE phase)
+		{
+			phase_ = phase;
+			rss_ = 0;
+			if (nullptr != (report_ = report)) {
+				rss_ = runReport::currentRSS();
+				start_ = std::chrono::steady_clock::now();
+			}
+		}
+
+		virtual ~timer()
+		{ stop(); }
+
+		// Fin de la mesure
+		void stop()
+		{
+			if (report_) {
+				report_->_add(phase_, start_, rss_);
+				report_ = nullptr;
+			}
+		}
+
+	protected:
+		runReport*								report_;
+		PHASE									phase_;
+		std::chrono::steady_clock::time_point	start_;
+		size_t									rss_;		// Mémoire utilisée au début de la phase
+	};
+
+	// Construction
+	runReport();
+
+	// Destruction
+	virtual ~runReport()
+	{}
+
+	// Nouvelle exécution
+	void start(const char* cmdFile);
+
+	// Mise à jour d'un compteur
+	void add(COUNTER counter, size_t value = 1)
+	{ counters_[(size_t)counter] += value; }
+
+	// Phase mesurée par ailleurs (durée en ms)
+	void add(PHASE phase, double duration);
+
+	// Enregistrement du rapport (avec éventuellement les statistiques des requêtes)
+	bool save(const string& fileName, int status, queryProfiler* profiler = nullptr);
+
+	// Pic d'utilisation mémoire du processus depuis son lancement (en ko)
+	//	ce maximum ne redescend jamais : il ne permet pas d'attribuer la mémoire à une phase
+	static size_t peakRSS();
+
+	// Mémoire utilisée par le processus (en ko)
+	static size_t currentRSS();
+
+	// Méthodes privées
+	//
+protected:
+
+	// Fin d'une phase
+	void _add(PHASE phase, std::chrono::steady_clock::time_point& start, size_t rss);
+
+	// Noms (clés JSON)
+	static const char* _phaseName(size_t index);
+	static const char* _counterName(size_t index);
+
+	// Chaine au format JSON
+	static string _escape(const string& value);
+
+	// Données membres privées
+	//
+protected:
+
+	// Informations par phase
+	typedef struct tagPHASEINFOS
+	{
+		size_t		calls_;
+		double		duration_;		// en ms
+		size_t		rssMax_;		// Mémoire utilisée maximale à la fin de la phase (ko)
+		size_t		rssGrowth_;		// Croissance de la mémoire utilisée durant la phase (ko)
+	}PHASEINFOS;
+
+	string									cmdFile_;
+	time_t									startTime_;
+	std::chrono::steady_clock::time_point	start_;
+
+	PHASEINFOS								phases_[(size_t)PHASE::COUNT];
+	size_t									counters_[(size_t)COUNTER::COUNT];
+};
+
+#endif // #ifndef __LDAP_2_FILE_RUN_REPORT_h__
+
+// EOF
@@ -103,6 +103,16 @@
 // Analyse du contenu d'un dossier
 #define CMD_LINE_DIR			"-d:"
 
+// Traitement simultané des fichiers de commandes
+#define CMD_LINE_JOBS			"-j:"			// Nombre de threads
+#define JOB_TEMP_FOLDER			"job"			// Sous-dossier temporaire de chaque thread (job1, job2, ...)
+
+// Mode démon : surveillance du dossier des fichiers de commandes
+#define CMD_LINE_WATCH			"-w"
+#define WATCH_DELAY				1000			// Délai (en ms) entre une modification et le traitement du fichier
+#define WATCH_RETRY_DELAY		30000			// Premier délai (en ms) avant de retraiter un fichier en erreur bloquante
+#define WATCH_RETRY_MAX_DELAY	3600000			// ... il double à chaque échec jusqu'à ce maximum
+
 // Génération d'un fichier de sortie (à la place du nom fourni par le fichier de commande)
 #define CMD_OUTPUT_FILE			"-o:"
 
@@ -379,6 +389,10 @@ using namespace jhbTools;
 //
 enum class FILE_TYPE { FILE_UNKNOWN_TYPE = 0, FILE_TXT = 0, FILE_CSV, FILE_XLS, FILE_XLSX, FILE_ODS, FILE_JS, FILE_LDIF, FILE_VCARD};
 
+// Compression des fichiers "texte" générés
+//
+enum class COMPRESSION_TYPE { NONE = 0, GZIP, ZSTD };
+
 // Types de destinations
 //
 enum class DEST_TYPE { DEST_UNKNOWN = 0, DEST_FS = 1, DEST_FILE_SYSTEM = 1, DEST_EMAIL, DEST_FTP, DEST_SCP };
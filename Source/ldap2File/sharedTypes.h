@@ -48,12 +48,20 @@ typedef struct tagLOGINFOS
 		mode_ = LOG_LEVEL_NORMAL;
 		folder_ = "";		// Dans le dossier par dfaut (sous-dossier du dossier d'installation)
 		duration_ = LOG_DURATION_INFINITE;
+		report_ = false;		// Pas de rapport d'excution
+		profile_ = false;		// Pas de profilage des requtes
+		threshold_ = 0;			// Seuil par dfaut
+		prometheus_ = "";		// Pas de fichier pour Prometheus
 	}
 
 	string		fileName_;
 	string		mode_;
 	string		folder_;
 	int 		duration_;
+	bool		report_;
+	bool		profile_;
+	size_t		threshold_;
+	string		prometheus_;
 }LOGINFOS, *LPLOGINFOS;
 
 // Serveur pour les photos
@@ -80,54 +88,90 @@ typedef struct tagIMGSERVER
 
 		// Un dossier de base ?
 		if (!baseFolder_.size()){
-			// Le protocole est-il prcis ?
-			if (host_.size() && 0 != host_.find(IPPROTO_HTTP)){
-				string proto(IPPROTO_HTTP);
-				proto += "://";
-				proto += host_;
-				host_ = proto;
-			}
+			setBaseFolder();
+		}
 
-			baseFolder_ = host_;
-			size_t len(baseFolder_.size());
-			if (len){
-				if (baseFolder_[len - 1] == POSIX_FILENAME_SEP){
-					if (folder_[0] == POSIX_FILENAME_SEP){
-						baseFolder_.resize(len - 1);
-					}
-					baseFolder_ += folder_;
-				}
-				else{
-					if (folder_[0] != POSIX_FILENAME_SEP){
-						baseFolder_ += POSIX_FILENAME_SEP;
-					}
-					baseFolder_ += folder_;
-				}
+		string fName(baseFolder_);
+		fName += POSIX_FILENAME_SEP;
+		fName += (sShort.size()?sShort:nophoto_);
+		return fName;
+	}
+	string URL(const string& shortName)
+	{ return URL(shortName.c_str()); }
+
+	// Lien complet  partir d'un nom de fichier (quivalent  URL(shortFileName(fileName)))
+	//	Le rsultat est copi dans dest dont le tampon est rutilis
+	//	Le dossier de base doit avoir t calcul (setBaseFolder)
+	void fullURL(string& dest, const char* fileName) const{
+		const char* shortName(fileName ? fileName : "");
+		const char* sep(nullptr);
+
+		// Nom "court"
+		if (nullptr != (sep = strchr(shortName, POSIX_FILENAME_SEP))){
+			shortName = sep + 1;
+		}
+		if (nullptr != (sep = strchr(shortName, WIN_FILENAME_SEP))){
+			shortName = sep + 1;
+		}
 
-				// Pas de sparateur final
-				len = baseFolder_.size();
-				if (baseFolder_[len - 1] == POSIX_FILENAME_SEP){
+		// Nom complet ?
+		if (nullptr != strchr(shortName, POSIX_FILENAME_SEP)){
+			dest.assign(shortName);
+			return;
+		}
+
+		dest.assign(baseFolder_);
+		dest += POSIX_FILENAME_SEP;
+		if (*shortName){
+			dest.append(shortName);
+		}
+		else{
+			dest.append(nophoto_);
+		}
+	}
+
+	// Calcul du dossier de base
+	void setBaseFolder(){
+		// Le protocole est-il prcis ?
+		if (host_.size() && 0 != host_.find(IPPROTO_HTTP)){
+			string proto(IPPROTO_HTTP);
+			proto += "://";
+			proto += host_;
+			host_ = proto;
+		}
+
+		baseFolder_ = host_;
+		size_t len(baseFolder_.size());
+		if (len){
+			if (baseFolder_[len - 1] == POSIX_FILENAME_SEP){
+				if (folder_[0] == POSIX_FILENAME_SEP){
 					baseFolder_.resize(len - 1);
 				}
+				baseFolder_ += folder_;
 			}
 			else{
-				// Pas de serveur => chemin relatif sur le serveur courant
 				if (folder_[0] != POSIX_FILENAME_SEP){
-					baseFolder_ += folder_;
-				}
-				else{
-					baseFolder_ = folder_.substr(1);
+					baseFolder_ += POSIX_FILENAME_SEP;
 				}
+				baseFolder_ += folder_;
 			}
-		}
 
-		string fName(baseFolder_);
-		fName += POSIX_FILENAME_SEP;
-		fName += (sShort.size()?sShort:nophoto_);
-		return fName;
+			// Pas de sparateur final
+			len = baseFolder_.size();
+			if (baseFolder_[len - 1] == POSIX_FILENAME_SEP){
+				baseFolder_.resize(len - 1);
+			}
+		}
+		else{
+			// Pas de serveur => chemin relatif sur le serveur courant
+			if (folder_[0] != POSIX_FILENAME_SEP){
+				baseFolder_ += folder_;
+			}
+			else{
+				baseFolder_ = folder_.substr(1);
+			}
+		}
 	}
-	string URL(const string& shortName)
-	{ return URL(shortName.c_str()); }
 
 	// Nom "court" (ie. nettoyage si il y a un chemin)
 	string shortFileName(const char* fileName){
@@ -271,7 +315,7 @@ public:
 
 	// Initialisation des donnes membres
 	virtual void init()
-	{ environment_ = name_ = "";  type_ = DEST_TYPE::DEST_UNKNOWN; folder_ = ""; }
+	{ environment_ = name_ = "";  type_ = DEST_TYPE::DEST_UNKNOWN; folder_ = ""; timeout_ = 0; }
 
 	// Accs
 	void setEnvironment(string& env)
@@ -286,12 +330,17 @@ public:
 	{ return folder_.c_str(); }
 	const char* name()
 	{ return name_.c_str(); }
+	void setTimeout(int timeout)
+	{ timeout_ = (timeout > 0 ? timeout : 0); }
+	int timeout()
+	{ return timeout_; }
 
 protected :
 	string				name_;			// Nom
 	string				environment_;
 	DEST_TYPE			type_;			// Type ...
 	string				folder_;		// Le dossier destination
+	int					timeout_;		// Dure max. du transfert en secondes (0 = pas de limite)
 };
 
 // Une destination de type serveur ...
@@ -547,6 +596,20 @@ typedef struct tagOUTPUTFILEINFOS
 	tagOUTPUTFILEINFOS()
 	{ init(); }
 
+	// Constructeur par recopie
+	//	seuls les paramtres du format sont copis (les destinations et les actions restent  la source)
+	tagOUTPUTFILEINFOS(const tagOUTPUTFILEINFOS& src){
+		init();
+		format_ = src.format_;
+		formatName_ = src.formatName_;
+		name_ = src.name_;
+		templateFile_ = src.templateFile_;
+		showHeader_ = src.showHeader_;
+		sheetNameLen_ = src.sheetNameLen_;
+		compression_ = src.compression_;
+		compressionLevel_ = src.compressionLevel_;
+	}
+
 	// Destruction
 	virtual ~tagOUTPUTFILEINFOS(){
 		for (deque<fileDestination*>::iterator it = dests_.begin(); it != dests_.end(); it++){
@@ -563,9 +626,12 @@ typedef struct tagOUTPUTFILEINFOS
 	// Initialisation des donnes membres
 	void init(){
 		format_= FILE_TYPE::FILE_UNKNOWN_TYPE;
+		formats_.clear();
 		sheetNameLen_ = -1;
 		/*extension_ = */formatName_ = name_ = templateFile_ = "";
 		showHeader_ = true;
+		compression_ = COMPRESSION_TYPE::NONE;
+		compressionLevel_ = -1;
 	}
 
 	// Ajout d'une destination
@@ -578,12 +644,15 @@ typedef struct tagOUTPUTFILEINFOS
 	}
 
 	FILE_TYPE				format_;
+	deque<FILE_TYPE>		formats_;			// Tous les formats demands (si plusieurs)
 	//string					extension_;
 	string					formatName_;
 	string					name_;
 	string					templateFile_;
 	bool					showHeader_;
 	int 					sheetNameLen_;		// Longueur max. en caractres du nom d'un onglet (-1 = pas de limite)
+	COMPRESSION_TYPE		compression_;		// Compression du fichier gnr
+	int						compressionLevel_;	// -1 = niveau par dfaut
 	fileActions				actions_;
 	deque<fileDestination*>	dests_;
 }OPFI,* LPOPFI;
@@ -0,0 +1,380 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: teeFile.cpp
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Implémentation de la classe teeFile
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#include "teeFile.h"
+
+//----------------------------------------------------------------------
+//--
+//-- Implémentation de la classe
+//--
+//----------------------------------------------------------------------
+
+// Construction
+//
+teeFile::teeFile(const LPOPFI fileInfos, columnList* columns, confFile* parameters)
+	:outputFile(fileInfos, columns, parameters)
+{
+	extensions_ = "";
+}
+
+// Destruction
+//
+teeFile::~teeFile()
+{
+	// Libération des fichiers ...
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		if (*it) {
+			delete (*it);
+		}
+	}
+	files_.clear();
+
+	// ... puis de leurs informations
+	for (deque<LPOPFI>::iterator it = infos_.begin(); it != infos_.end(); it++) {
+		if (*it) {
+			delete (*it);
+		}
+	}
+	infos_.clear();
+
+	// Le nom est celui du premier fichier (déja supprimé)
+	fileName_ = "";
+}
+
+// Ajout d'un fichier
+//
+bool teeFile::addFile(outputFile* file, LPOPFI fileInfos)
+{
+	if (nullptr == file || nullptr == fileInfos) {
+		return false;
+	}
+
+	files_.push_back(file);
+	infos_.push_back(fileInfos);
+
+	// Liste des extensions (pour les logs)
+	if (extensions_.size()) {
+		extensions_ += "+";
+	}
+	extensions_ += file->fileExtension();
+
+	return true;
+}
+
+// Paramètres spécifiques de chaque format
+//
+bool teeFile::getOwnParameters()
+{
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		if (false == (*it)->getOwnParameters()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Colonnes "obligatoires" de tous les formats (sans doublons)
+//
+void teeFile::getOwnColumns(deque<OWNCOL>& colNames)
+{
+	colNames.clear();
+
+	deque<OWNCOL> cols;
+	deque<OWNCOL>::iterator found;
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		(*it)->getOwnColumns(cols);
+		for (deque<OWNCOL>::iterator col = cols.begin(); col != cols.end(); col++) {
+			for (found = colNames.begin(); found != colNames.end() && found->type_ != col->type_; found++);
+			if (colNames.end() == found) {
+				colNames.push_back(*col);
+			}
+		}
+	}
+}
+
+// Initialisation de tous les fichiers
+//
+bool teeFile::initialize()
+{
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		if (false == (*it)->initialize()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Création de tous les fichiers
+//
+bool teeFile::create()
+{
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		if (false == (*it)->create()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Nom des fichiers
+//	le nom est commun, chaque fichier conserve son extension
+//
+void teeFile::setFileName(string& source, bool keepPath)
+{
+	outputFile::setFileName(source, keepPath);
+
+	string baseName(source), name("");
+	size_t pos(baseName.rfind("."));
+	if (baseName.npos != pos && baseName.npos == baseName.find(FILENAME_SEP, pos)) {
+		// Retrait de l'extension
+		baseName = baseName.substr(0, pos);
+	}
+
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		name = baseName;
+		name += ".";
+		name += (*it)->fileExtension();
+		(*it)->setFileName(name, keepPath);
+	}
+}
+
+// Organigramme
+//	l'organigramme n'est généré que dans le premier fichier qui le gère
+//
+orgChartFile* teeFile::addOrgChartFile(bool flatMode, bool fullMode, bool& newFile)
+{
+	orgChartFile* orgFile(nullptr);
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		if (nullptr != (orgFile = (*it)->addOrgChartFile(flatMode, fullMode, newFile))) {
+			return orgFile;
+		}
+	}
+
+	newFile = false;
+	return nullptr;
+}
+
+// Onglets
+//
+void teeFile::setSheetName(string& sheetName)
+{
+	for (size_t index = 0; index < files_.size(); index++) {
+		files_[index]->setSheetName(_value(index, sheetName));
+	}
+}
+
+bool teeFile::addSheet(string& sheetName, bool withHeader, bool firstSheet)
+{
+	bool done(false);
+	for (size_t index = 0; index < files_.size(); index++) {
+		if (files_[index]->addSheet(_value(index, sheetName), withHeader, firstSheet)) {
+			done = true;
+		}
+	}
+
+	return done;
+}
+
+// Valeurs vides
+//
+void teeFile::addEmptyValue()
+{
+	for (size_t index = 0; index < files_.size(); index++) {
+		_file(index)->addEmptyValue();
+	}
+}
+
+//	le nombre retourné est celui du premier fichier (cf. size())
+size_t teeFile::addEmptyValues(size_t count)
+{
+	size_t added(0), current(0);
+	for (size_t index = 0; index < files_.size(); index++) {
+		current = _file(index)->addEmptyValues(count);
+		if (0 == index) {
+			added = current;
+		}
+	}
+
+	return added;
+}
+
+// Ajout d'une valeur (avec changement de colonne)
+//
+bool teeFile::add(string& value)
+{
+	bool done(true);
+	for (size_t index = 0; index < files_.size(); index++) {
+		if (false == _file(index)->add(_value(index, value))) {
+			done = false;
+		}
+	}
+
+	return done;
+}
+
+bool teeFile::add(deque<string>& values)
+{
+	bool done(true);
+	for (size_t index = 0; index < files_.size(); index++) {
+		if (index + 1 == files_.size()) {
+			done = _file(index)->add(values) && done;
+		}
+		else {
+			values_ = values;
+			done = _file(index)->add(values_) && done;
+		}
+	}
+
+	return done;
+}
+
+// Ajout d'une valeur dans une colonne précise
+//
+bool teeFile::addAt(size_t colIndex, string& value)
+{
+	bool done(true);
+	for (size_t index = 0; index < files_.size(); index++) {
+		if (false == _file(index)->addAt(colIndex, _value(index, value))) {
+			done = false;
+		}
+	}
+
+	return done;
+}
+
+bool teeFile::addAt(size_t colIndex, deque<string>& values)
+{
+	bool done(true);
+	for (size_t index = 0; index < files_.size(); index++) {
+		if (index + 1 == files_.size()) {
+			done = _file(index)->addAt(colIndex, values) && done;
+		}
+		else {
+			values_ = values;
+			done = _file(index)->addAt(colIndex, values_) && done;
+		}
+	}
+
+	return done;
+}
+
+// Suppression d'une valeur
+//
+bool teeFile::removeAt(size_t colIndex)
+{
+	bool done(true);
+	for (size_t index = 0; index < files_.size(); index++) {
+		if (false == _file(index)->removeAt(colIndex)) {
+			done = false;
+		}
+	}
+
+	return done;
+}
+
+// Remplacement d'une valeur
+//
+bool teeFile::replaceAt(size_t colIndex, string& singleValue)
+{
+	bool done(true);
+	for (size_t index = 0; index < files_.size(); index++) {
+		if (false == _file(index)->replaceAt(colIndex, _value(index, singleValue))) {
+			done = false;
+		}
+	}
+
+	return done;
+}
+
+// Enregistrement de la "ligne"
+//
+bool teeFile::saveLine(bool header, LPAGENTINFOS agent)
+{
+	bool done(true);
+	for (size_t index = 0; index < files_.size(); index++) {
+		if (false == _file(index)->saveLine(header, agent)) {
+			done = false;
+		}
+	}
+
+	return done;
+}
+
+// Lot de lignes
+//	Chaque fichier reçoit le lot complet (writeRows ne modifie pas le lot)
+//	le nombre retourné est celui du premier fichier (cf. size())
+//
+size_t teeFile::writeRows(outputRows& rows)
+{
+	size_t saved(0), current(0);
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		current = (*it)->writeRows(rows);
+		if (files_.begin() == it) {
+			saved = current;
+		}
+	}
+
+	return saved;
+}
+
+// Effacement de la ligne
+//
+void teeFile::clearLine()
+{
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		(*it)->clearLine();
+	}
+}
+
+// Sauvegarde / Fermeture
+//
+bool teeFile::close()
+{
+	bool done(true);
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		if (false == (*it)->close()) {
+			if (logs_) {
+				logs_->add(logs::TRACE_TYPE::ERR, "Le fichier '%s' n'a pu être sauvegardé", (*it)->fileName());
+			}
+			done = false;
+		}
+	}
+
+	return done;
+}
+
+// Fin des transferts
+//
+void teeFile::delivered(bool success)
+{
+	for (deque<outputFile*>::iterator it = files_.begin(); it != files_.end(); it++) {
+		(*it)->delivered(success);
+	}
+}
+
+// EOF
@@ -0,0 +1,150 @@
+//---------------------------------------------------------------------------
+//--
+//--	FICHIER	: teeFile.h
+//--
+//--	AUTEUR	: Jérôme Henry-Barnaudière - JHB
+//--
+//--	PROJET	: ldap2File
+//--
+//--    COMPATIBILITE : Win32 | Linux  Fedora (34 et +) / CentOS (7 & 8)
+//--
+//---------------------------------------------------------------------------
+//--
+//--	DESCRIPTION:
+//--
+//--			Définition de la classe teeFile
+//--
+//--			Génération simultanée de plusieurs fichiers (de formats
+//--			différents) à partir d'un unique parcours de l'annuaire
+//--
+//---------------------------------------------------------------------------
+//--
+//--	MODIFICATIONS:
+//--	-------------
+//--
+//--	21/09/2022 - JHB - Version 22.6.5
+//--
+//---------------------------------------------------------------------------
+
+#ifndef __LDAP_2_FILE_TEE_OUTPUT_FILE_h__
+#define __LDAP_2_FILE_TEE_OUTPUT_FILE_h__   1
+
+#include "outputFile.h"
+
+//----------------------------------------------------------------------
+//--
+//-- Définition de la classe
+//--
+//----------------------------------------------------------------------
+
+class teeFile : public outputFile
+{
+	// Méthodes publiques
+	//
+public:
+
+	// Construction
+	teeFile(const LPOPFI fileInfos, columnList* columns, confFile* parameters);
+
+	// Destruction
+	virtual ~teeFile();
+
+	// Ajout d'un fichier (l'objet devient propriétaire du fichier et de ses informations)
+	bool addFile(outputFile* file, LPOPFI fileInfos);
+
+	// Accès aux fichiers
+	size_t files()
+	{ return files_.size(); }
+	outputFile* operator[](size_t index)
+	{ return (index < files_.size() ? files_[index] : nullptr); }
+
+	// Paramètres et colonnes spécifiques
+	virtual bool getOwnParameters();
+	virtual void getOwnColumns(deque<OWNCOL>& colNames);
+
+	// Création du fichier / initialisation(s)
+	virtual bool initialize();
+	virtual bool create();
+
+	// Nom des fichiers (chacun garde son extension)
+	virtual void setFileName(string& source, bool keepPath);
+	virtual const char* fileExtension()
+	{ return extensions_.c_str(); }
+
+	// Nombre d'éléments enregistrés
+	virtual size_t size()
+	{ return (files_.size() ? files_.front()->size() : 0); }
+
+	// Organigramme (confié au premier fichier qui sait le gérer)
+	virtual orgChartFile* addOrgChartFile(bool flatMode, bool fullMode, bool& newFile);
+
+	// Onglets
+	virtual void setSheetName(string& sheetName);
+	virtual bool addSheet(string& sheetName, bool withHeader, bool firstSheet = false);
+
+	// Valeurs vides
+	virtual void addEmptyValue();
+	virtual size_t addEmptyValues(size_t count = 1);
+
+	// Ajout d'une valeur (avec changement de colonne)
+	virtual bool add(string& value);
+	virtual bool add(deque<string>& values);
+
+	// Ajout d'une valeur dans une colonne précise
+	virtual bool addAt(size_t colIndex, string& value);
+	virtual bool addAt(size_t colIndex, deque<string>& values);
+
+	// Suppression d'une valeur
+	virtual bool removeAt(size_t colIndex);
+
+	// Remplacement d'une valeur
+	virtual bool replaceAt(size_t colIndex, string& singleValue);
+
+	// Enregistrement de la "ligne"
+	virtual bool saveLine(bool header = false, LPAGENTINFOS agent = nullptr);
+
+	// Lot de lignes
+	virtual size_t writeRows(outputRows& rows);
+
+	// Effacement de la ligne
+	virtual void clearLine();
+
+	// Sauvegarde / Fermeture
+	virtual bool close();
+
+	// Fin des transferts
+	virtual void delivered(bool success);
+
+	// Méthodes privées
+	//
+protected:
+
+	// Fichier à alimenter (même attribut courant que le "tee")
+	outputFile* _file(size_t index) {
+		outputFile* file(files_[index]);
+		file->setAttributeNames(currentAttribute_);
+		return file;
+	}
+
+	// Un fichier peut modifier la valeur qu'il reçoit (encodage) => tous sauf le dernier reçoivent une copie
+	string& _value(size_t index, string& value) {
+		if (index + 1 == files_.size()) {
+			return value;
+		}
+		value_ = value;
+		return value_;
+	}
+
+	// Données membres privées
+	//
+protected:
+	deque<outputFile*>		files_;			// Les fichiers générés
+	deque<LPOPFI>			infos_;			// ... et leurs informations
+	string					extensions_;	// Liste des extensions
+	string					value_;			// Copie d'une valeur
+	deque<string>			values_;		// Copie de valeurs multiples
+};
+
+#endif // __LDAP_2_FILE_TEE_OUTPUT_FILE_h__
+
+// EOF
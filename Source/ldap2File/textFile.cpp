@@ -61,6 +61,37 @@ textFile::textFile(const LPOPFI fileInfos, columnList* columns, confFile* parame
 #else
 	setSeparators(STR_FR_SEP, NULL);
 #endif // _WIN32
+
+	// Compression du fichier
+	if (COMPRESSION_TYPE::NONE != fileInfos_->compression_) {
+		if (!file_.setCompression(fileInfos_->compression_, fileInfos_->compressionLevel_) && logs_) {
+			logs_->add(logs::TRACE_TYPE::ERR, "La compression zstd n'est pas disponible, le fichier sera compressé avec gzip");
+		}
+
+		file_.addExtension(fileName_);
+	}
+}
+
+// Nom du fichier
+//	le fichier compressé (et sa copie chez les destinataires) porte l'extension de la compression
+//
+void textFile::setFileName(string& source, bool keepPath)
+{
+	outputFile::setFileName(source, keepPath);
+
+	file_.addExtension(fileName_);
+	file_.addExtension(fileInfos_->name_);
+}
+
+const char* textFile::fileExtension()
+{
+	extension_ = outputFile::fileExtension();
+	if (COMPRESSION_TYPE::NONE != file_.compression()) {
+		extension_ += ".";
+		extension_ += file_.extension();
+	}
+
+	return extension_.c_str();
 }
 
 // Séparateurs et formats d'écriture
@@ -179,7 +210,9 @@ bool textFile::close()
 	}
 
 	// Fermeture du fichier
-	_close();
+	if (!_close()) {
+		writen = false;
+	}
 
 	// Ok
 	return writen;
@@ -225,4 +258,18 @@ bool textFile::_open()
 	return true;
 }
 
+// Fermeture du fichier
+//	=> fin du flux compressé
+//
+bool textFile::_close()
+{
+	bool done(file_.close());
+
+	if (logs_ && COMPRESSION_TYPE::NONE != file_.compression()) {
+		logs_->add(logs::TRACE_TYPE::DBG, "Fichier compressé (%s) : %d -> %d octets", file_.extension(), (int)file_.bytesIn(), (int)file_.bytesOut());
+	}
+
+	return done;
+}
+
 // EOF
@@ -27,7 +27,7 @@
 #define __LDAP_2_FILE_TXT_OUTPUT_FILE_h__   1
 
 #include "outputFile.h"
-#include <fstream>			// Enregistrement du fichier
+#include "outputStream.h"	// Enregistrement du fichier (éventuellement compressé)
 
 //----------------------------------------------------------------------
 //--
@@ -60,6 +60,10 @@ public:
 	// Création / initialisation(s)
 	virtual bool initialize();
 
+	// Nom du fichier (avec l'extension de la compression)
+	virtual void setFileName(string& source, bool keepPath);
+	virtual const char* fileExtension();
+
 	// Ajout d'une valeur (avec changement de colonne)
 	virtual bool add(string& value);
 	virtual bool add(deque<string>& values);
@@ -86,8 +90,7 @@ protected:
 	// Gestion du fichier
 	//
 	bool _open();
-	void _close()
-	{ file_.close(); }
+	bool _close();
 
 	// Données membres privées
 	//
@@ -96,7 +99,8 @@ protected:
 	string				sep_;			// Séparateur de valeurs
 	string				eol_;			// Fin de ligne
 
-	ofstream			file_;			// Fichier à générer
+	outputStream		file_;			// Fichier à générer
+	string				extension_;		// Extension (avec celle de la compression)
 
 	string				currentLine_;	// ligne en cours
 
@@ -282,7 +282,7 @@ bool vCardFile::addAt(size_t colIndex, string& value)
 #endif // _WIN32
 
 	// Le nom de la colonne ie. le nom "destination" LDAP
-	string name = currentAttribute_->colName_;
+	string& name(currentAttribute_->colName_);
 
 	// Recherche de l'attribut
 	LDAPATTRIBUTE* pAttr(attributesToSave_.findAttribute(name));
@@ -304,7 +304,7 @@ bool vCardFile::addAt(size_t colIndex, deque<string>& values)
 		return false;
 	}
 
-	string name = currentAttribute_->colName_;
+	string& name(currentAttribute_->colName_);
 
 	// Recherche de l'attribut
 	LDAPATTRIBUTE* pAttr(attributesToSave_.findAttribute(name));
@@ -322,7 +322,7 @@ bool vCardFile::addAt(size_t colIndex, deque<string>& values)
 	for (deque<string>::iterator it = values.begin(); it != values.end(); it++) {
 #ifdef _WIN32
         // Conversion en UTF8
-        value = encoder_.toUTF8((*it));
+        encoder_.toUTF8(value, it->c_str(), it->size());
         pAttr->add(value);
 #else
 		pAttr->add((*it));
@@ -394,8 +394,10 @@ bool vCardFile::close()
         writen = false;
 	}
 
-	// Fermeture du fichier
-	_close();
+	// Fermeture du fichier (et fin du flux compressé)
+	if (!_close()) {
+		writen = false;
+	}
 
 	// Ok
 	return writen;
@@ -426,27 +428,6 @@ void vCardFile::_attribute2VCARD(LDAPATTRIBUTE* attribute, const char* szName)
 	}
 }
 
-//
-// vCardFile::tagLDAPATTRIBUTE
-//
-
-// Recherche d'une valeur
-//
-bool vCardFile::tagLDAPATTRIBUTE::exists(string& attrValue)
-{
-	if (attrValue.size())
-	{
-		for (list<string>::iterator it = values_.begin(); it != values_.end(); it++) {
-			if ((*it) == attrValue) {
-				return true;
-			}
-		}
-	}
-
-	// Non trouvé
-	return false;
-}
-
 //
 // vCardFile::vCardUserDatas
 //
@@ -464,6 +445,7 @@ vCardFile::vCardUserDatas::~vCardUserDatas()
 
 	// Liste vide
 	attributes_.clear();
+	index_.clear();
 }
 
 // Nettoyage de la liste
@@ -483,12 +465,10 @@ void vCardFile::vCardUserDatas::clean()
 vCardFile::LDAPATTRIBUTE* vCardFile::vCardUserDatas::findAttribute(string& attrName)
 {
 	if (attrName.length()) {
-		LDAPATTRIBUTE* pAttribute(nullptr);
-		for (deque<LDAPATTRIBUTE*>::iterator it = attributes_.begin(); it != attributes_.end(); it++) {
-			if (nullptr != (pAttribute = (*it)) && (*it)->name_ == attrName) {
-				// Trouvé !
-				return (*it);
-			}
+		unordered_map<string, size_t>::iterator it = index_.find(attrName);
+		if (index_.end() != it) {
+			// Trouvé !
+			return attributes_[it->second];
 		}
 	}
 
@@ -524,20 +504,16 @@ vCardFile::LDAPATTRIBUTE* vCardFile::vCardUserDatas::add(vCardFile::LDAPATTRIBUT
 	LDAPATTRIBUTE* pCurrent = findAttribute(attr->name_);
 	if (nullptr == pCurrent) {
 		// L'attribut n'existe pas => on insère une copie
-		if (nullptr != (pCurrent = new LDAPATTRIBUTE(*attr))) {
-			// Crée => on ajoute la copie
-			attributes_.push_back(pCurrent);
-		}
+		// Crée => on ajoute la copie
+		pCurrent = _append(new LDAPATTRIBUTE(*attr));
 	}
 	else {
-		// L'attribut existe déja, je lui ajoute les valeurs
+		// L'attribut existe déja, je lui ajoute les valeurs (sans doublons)
 		for (list<string>::iterator it = attr->values_.begin(); it != attr->values_.end(); it++) {
 			if ((*it).size()) {
-				pCurrent->values_.push_back(*it);
+				pCurrent->add(*it);
 			}
 		}
-
-		pCurrent->values_.unique();	// Pas de doublons
 	}
 
 	// Ok
@@ -559,8 +535,7 @@ vCardFile::LDAPATTRIBUTE* vCardFile::vCardUserDatas::newAttribute(string& attrNa
 	}
 	else {
 		// Création d'un nouvel attribut
-		pAttr = new tagLDAPATTRIBUTE(attrName, attrValue);
-		attributes_.push_back(pAttr);
+		pAttr = _append(new tagLDAPATTRIBUTE(attrName, attrValue));
 	}
 
 	return pAttr;
@@ -40,6 +40,8 @@
 #define __LDAP_2_FILE_VCARD_OUTPUT_FILE_h__ 1
 
 #include "textFile.h"
+#include <unordered_map>
+#include <unordered_set>
 
 //----------------------------------------------------------------------
 //--
@@ -121,7 +123,7 @@ private:
 		// Constructions
 		tagLDAPATTRIBUTE(string& attrName, string& attrValue){
 			name_ = attrName;
-			values_.push_back(attrValue);
+			add(attrValue);
 		}
 
 		// Destruction
@@ -132,11 +134,12 @@ private:
 		{ return name_; }
 
 		// Recherche d'une valeur
-		bool exists(string& attrValue);
+		bool exists(string& attrValue)
+		{ return (attrValue.size() && index_.end() != index_.find(attrValue)); }
 
 		// Ajout dune valeur
 		void add(string& value) {
-			if (!exists(value)) {
+			if (0 == value.size() || index_.insert(value).second) {
 				// Pas dja en mmoire ...
 				values_.push_back(value);
 			}
@@ -150,6 +153,7 @@ private:
 		// Nettoyage (ie. suppression de toutes les valeurs)
 		void clean() {
 			values_.clear();
+			index_.clear();
 		}
 
 		// Nombre d'lments
@@ -159,6 +163,7 @@ private:
 
 		string			name_;			// Nom de l'attribut
 		list<string>	values_;		// Les valeurs ( priori non vides)
+		unordered_set<string>	index_;	// Recherche rapide des doublons
 	}LDAPATTRIBUTE;
 
 	// Toutes les informations d'un agent (ie. une "ligne" dans la logique fichier plat / CSV)
@@ -216,7 +221,17 @@ private:
 		LDAPATTRIBUTE* operator [](size_t index);
 
 	protected:
+		// Ajout d'un attribut en fin de liste (et dans l'index)
+		LDAPATTRIBUTE* _append(LDAPATTRIBUTE* attr) {
+			if (nullptr != attr) {
+				index_[attr->name_] = attributes_.size();
+				attributes_.push_back(attr);
+			}
+			return attr;
+		}
+
 		deque<LDAPATTRIBUTE*>	attributes_;		// Liste des attributs
+		unordered_map<string, size_t>	index_;		// Nom de l'attribut => position dans la liste
 	};
 
 	// Nouvelle ligne vierge